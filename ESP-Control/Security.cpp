@@ -4,14 +4,38 @@
 
 Security g_security;
 
-Security::Security() : m_nonceCacheIndex(0) {
+Security::Security() : m_nonceCacheIndex(0), m_workAllocated(false) {
   memset(m_sharedSecret, 0, sizeof(m_sharedSecret));
   memset(m_sessionKey, 0, sizeof(m_sessionKey));
   memset(m_nonceCache, 0, sizeof(m_nonceCache));
+
+  // Nur initialisieren, Speicher wird erst in begin() angelegt
+  mbedtls_md_init(&m_commandKey.inner);
+  mbedtls_md_init(&m_commandKey.outer);
+  m_commandKey.allocated = false;
+  m_commandKey.ready = false;
+  mbedtls_md_init(&m_responseKey.inner);
+  mbedtls_md_init(&m_responseKey.outer);
+  m_responseKey.allocated = false;
+  m_responseKey.ready = false;
+  mbedtls_md_init(&m_work);
+}
+
+Security::~Security() {
+  freeHMAC(m_commandKey);
+  freeHMAC(m_responseKey);
+  mbedtls_md_free(&m_work);
 }
 
 void Security::begin(const char* sharedSecret) {
   strncpy(m_sharedSecret, sharedSecret, sizeof(m_sharedSecret) - 1);
+
+  // ipad/opad einmalig vorberechnen; bei Fehler bleibt computeHMAC() als Fallback
+  if (!prepareHMAC(m_commandKey, (uint8_t*)m_sharedSecret, strlen(m_sharedSecret))) {
+    DEBUG_PRINTLN("[Security] HMAC-Vorberechnung fehlgeschlagen");
+  }
+  prepareResponseKey();
+
   DEBUG_PRINTLN("[Security] Initialisiert");
 }
 
@@ -20,11 +44,16 @@ void Security::generateSessionKey() {
   for (int i = 0; i < 32; i++) {
     m_sessionKey[i] = esp_random() & 0xFF;
   }
+  prepareResponseKey();
   DEBUG_PRINTLN("[Security] Neuer Session-Key generiert");
 }
 
 bool Security::generateResponse(const uint8_t* challenge, uint8_t* response) {
   // Response = HMAC-SHA256(SessionKey || SharedSecret, Challenge)
+  if (m_responseKey.ready) {
+    return computePreparedHMAC(m_responseKey, challenge, 16, response);
+  }
+
   uint8_t combinedKey[64];
   memcpy(combinedKey, m_sessionKey, 32);
   memcpy(combinedKey + 32, m_sharedSecret, 32);
@@ -58,6 +87,10 @@ bool Security::validateResponse(const uint8_t* challenge, const uint8_t* respons
 
 bool Security::generateCommandHMAC(const MessageHeader* header, uint8_t* hmac) {
   // HMAC über den gesamten Header
+  if (m_commandKey.ready) {
+    return computePreparedHMAC(m_commandKey, (uint8_t*)header, sizeof(MessageHeader), hmac);
+  }
+
   return computeHMAC((uint8_t*)m_sharedSecret, strlen(m_sharedSecret),
                      (uint8_t*)header, sizeof(MessageHeader), hmac);
 }
@@ -144,3 +177,102 @@ bool Security::computeHMAC(const uint8_t* key, size_t keyLen,
   mbedtls_md_free(&ctx);
   return true;
 }
+
+void Security::prepareResponseKey() {
+  // Key hängt vom Session-Key ab -> nach begin() und jedem generateSessionKey()
+  uint8_t combinedKey[64];
+  memcpy(combinedKey, m_sessionKey, 32);
+  memcpy(combinedKey + 32, m_sharedSecret, 32);
+
+  if (!prepareHMAC(m_responseKey, combinedKey, 64)) {
+    DEBUG_PRINTLN("[Security] HMAC-Vorberechnung fehlgeschlagen");
+  }
+  memset(combinedKey, 0, sizeof(combinedKey));
+}
+
+bool Security::prepareHMAC(PreparedHMAC& prepared, const uint8_t* key, size_t keyLen) {
+  const mbedtls_md_info_t* info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  uint8_t pad[HMAC_BLOCK_SIZE];
+  uint8_t keyHash[32];
+
+  prepared.ready = false;
+
+  // Kontexte nur einmal anlegen, danach bei Schlüsselwechsel wiederverwenden
+  if (!m_workAllocated) {
+    if (mbedtls_md_setup(&m_work, info, 0) != 0) {
+      return false;
+    }
+    m_workAllocated = true;
+  }
+  if (!prepared.allocated) {
+    if (mbedtls_md_setup(&prepared.inner, info, 0) != 0 ||
+        mbedtls_md_setup(&prepared.outer, info, 0) != 0) {
+      freeHMAC(prepared);
+      return false;
+    }
+    prepared.allocated = true;
+  }
+
+  // Wie mbedtls_md_hmac_starts(): lange Schlüssel werden vorher gehasht
+  if (keyLen > HMAC_BLOCK_SIZE) {
+    if (mbedtls_md(info, key, keyLen, keyHash) != 0) {
+      return false;
+    }
+    key = keyHash;
+    keyLen = sizeof(keyHash);
+  }
+
+  bool ok = true;
+
+  memset(pad, 0x36, sizeof(pad));
+  for (size_t i = 0; i < keyLen; i++) {
+    pad[i] ^= key[i];
+  }
+  ok = ok && mbedtls_md_starts(&prepared.inner) == 0;
+  ok = ok && mbedtls_md_update(&prepared.inner, pad, sizeof(pad)) == 0;
+
+  memset(pad, 0x5C, sizeof(pad));
+  for (size_t i = 0; i < keyLen; i++) {
+    pad[i] ^= key[i];
+  }
+  ok = ok && mbedtls_md_starts(&prepared.outer) == 0;
+  ok = ok && mbedtls_md_update(&prepared.outer, pad, sizeof(pad)) == 0;
+
+  // Schlüsselmaterial nicht auf dem Stack liegen lassen
+  memset(pad, 0, sizeof(pad));
+  memset(keyHash, 0, sizeof(keyHash));
+
+  prepared.ready = ok;
+  return ok;
+}
+
+bool Security::computePreparedHMAC(PreparedHMAC& prepared,
+                                   const uint8_t* data, size_t dataLen,
+                                   uint8_t* output) {
+  uint8_t innerHash[32];
+
+  // Inner: H((K ^ ipad) || data)
+  if (mbedtls_md_clone(&m_work, &prepared.inner) != 0 ||
+      mbedtls_md_update(&m_work, data, dataLen) != 0 ||
+      mbedtls_md_finish(&m_work, innerHash) != 0) {
+    return false;
+  }
+
+  // Outer: H((K ^ opad) || inner)
+  if (mbedtls_md_clone(&m_work, &prepared.outer) != 0 ||
+      mbedtls_md_update(&m_work, innerHash, sizeof(innerHash)) != 0 ||
+      mbedtls_md_finish(&m_work, output) != 0) {
+    return false;
+  }
+
+  return true;
+}
+
+void Security::freeHMAC(PreparedHMAC& prepared) {
+  mbedtls_md_free(&prepared.inner);
+  mbedtls_md_free(&prepared.outer);
+  mbedtls_md_init(&prepared.inner);
+  mbedtls_md_init(&prepared.outer);
+  prepared.allocated = false;
+  prepared.ready = false;
+}
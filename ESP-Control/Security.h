@@ -8,10 +8,22 @@
 // ============================================================================
 // SICHERHEITS-LAYER MIT CHALLENGE-RESPONSE (OHNE NVS)
 // ============================================================================
+//
+// Threading: Die HMAC-Funktionen (generate/validateCommandHMAC,
+// generate/validateResponse) teilen sich den Arbeitskontext m_work und sind
+// NICHT reentrant - genau wie der Nonce-Cache. Heute ruft jede Rolle sie nur
+// aus einem Task auf: der Actor ausschliesslich im ESP-NOW Empfangs-Callback,
+// der Controller nur aus loop() (Taster, OTA, Challenge). Wer sie künftig aus
+// zwei Tasks nutzt (z.B. Response-Prüfung im Callback des Controllers), muss
+// die Aufrufe serialisieren (Mutex/portMUX). Ein Kontext auf dem Stack pro
+// Aufruf ist keine Alternative: mbedtls_md_clone braucht einen per
+// mbedtls_md_setup allozierten Kontext - das wäre wieder ein malloc pro
+// Nachricht.
 
 class Security {
 public:
   Security();
+  ~Security();
 
   // Initialisierung mit Shared Secret aus ESP_Code_Key.h
   void begin(const char* sharedSecret);
@@ -62,10 +74,35 @@ private:
   NonceEntry m_nonceCache[MAX_NONCE_CACHE];
   int m_nonceCacheIndex;
 
+  // Vorberechneter HMAC-Schlüssel: SHA256-Zustand nach ipad bzw. opad.
+  // Pro Nachricht werden nur noch die Zustände nach m_work geklont -
+  // 2 statt 4 SHA256-Blöcke, kein malloc. Nicht reentrant (siehe oben).
+  struct PreparedHMAC {
+    mbedtls_md_context_t inner;
+    mbedtls_md_context_t outer;
+    bool allocated;
+    bool ready;
+  };
+
+  static const size_t HMAC_BLOCK_SIZE = 64;   // SHA256-Blockgröße
+
+  PreparedHMAC m_commandKey;    // Key = SharedSecret (Command-HMAC)
+  PreparedHMAC m_responseKey;   // Key = SessionKey || SharedSecret (Response)
+  mbedtls_md_context_t m_work;
+  bool m_workAllocated;
+
   // HMAC-SHA256 Helper
   bool computeHMAC(const uint8_t* key, size_t keyLen,
                    const uint8_t* data, size_t dataLen,
                    uint8_t* output);
+
+  // Vorberechnete HMAC-Zustände
+  void prepareResponseKey();
+  bool prepareHMAC(PreparedHMAC& prepared, const uint8_t* key, size_t keyLen);
+  bool computePreparedHMAC(PreparedHMAC& prepared,
+                           const uint8_t* data, size_t dataLen,
+                           uint8_t* output);
+  void freeHMAC(PreparedHMAC& prepared);
 };
 
 extern Security g_security;
@@ -0,0 +1,175 @@
+/*
+ * hmac_bench.cpp
+ * Host-Benchmark für den Command-HMAC aus Security.cpp
+ * (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Übersetzt das echte Security.cpp gegen die Host-Stubs in tools/host und
+ * misst die Latenz pro Command-HMAC (MessageHeader, 11 Bytes):
+ *   vorher      - mbedtls_md_setup/hmac_starts/.../free pro Aufruf
+ *                 (bisheriges Security::computeHMAC, hier nachgebaut)
+ *   hmac_reset  - HMAC-Kontext einmal gekeyt, pro Aufruf mbedtls_md_hmac_reset
+ *   nachher     - Security::generateCommandHMAC (ipad/opad-Zustände geklont)
+ * Vorab wird geprüft, dass Command-HMAC und Challenge-Response bitgleich zu
+ * mbedtls_md_hmac() sind - am Funk-Format ändert sich nichts.
+ *
+ * Voraussetzung: mbedTLS-Header und libmbedcrypto auf dem PC (2.x oder 3.x)
+ *   Debian/Ubuntu: apt install libmbedtls-dev
+ *   macOS:         brew install mbedtls   (dazu -I/-L auf $(brew --prefix mbedtls))
+ *
+ * Build & Run (aus ESP-Control/tools):
+ *   g++ -O2 -std=c++17 -Ihost -I.. hmac_bench.cpp ../Security.cpp -lmbedcrypto -o hmac_bench
+ *   ./hmac_bench [Iterationen]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__has_include)
+#if !__has_include(<mbedtls/md.h>)
+#error "mbedtls/md.h fehlt - mbedTLS installieren (apt install libmbedtls-dev / brew install mbedtls), siehe Kopfkommentar"
+#endif
+#endif
+
+#include <mbedtls/md.h>
+
+#include "Security.h"
+#include "example_ESP_Code_Key.h"
+
+bool g_debugEnabled = false;
+
+// ==================== REFERENZ ====================
+
+// Bisheriger Weg: Kontext pro Nachricht anlegen, keyen und freigeben
+static bool hmacOneShot(const uint8_t* key, size_t keyLen,
+                        const uint8_t* data, size_t dataLen, uint8_t* output) {
+  mbedtls_md_context_t ctx;
+  mbedtls_md_init(&ctx);
+
+  bool ok = mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1) == 0 &&
+            mbedtls_md_hmac_starts(&ctx, key, keyLen) == 0 &&
+            mbedtls_md_hmac_update(&ctx, data, dataLen) == 0 &&
+            mbedtls_md_hmac_finish(&ctx, output) == 0;
+
+  mbedtls_md_free(&ctx);
+  return ok;
+}
+
+static bool hmacReference(const uint8_t* key, size_t keyLen,
+                          const uint8_t* data, size_t dataLen, uint8_t* output) {
+  return mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                         key, keyLen, data, dataLen, output) == 0;
+}
+
+// ==================== PRÜFUNG ====================
+
+static void fillHeader(MessageHeader& header, uint32_t i) {
+  header.msgType = MSG_RELAY_TOGGLE;
+  header.controllerId = i % 10;
+  header.actorId = (i / 10) % 10;
+  header.timestamp = i * 37;
+  header.nonce = i * 2654435761UL;
+}
+
+static int checkWireFormat(Security& security) {
+  const uint8_t* secret = (const uint8_t*)SHARED_SECRET;
+  size_t secretLen = strlen(SHARED_SECRET);
+  int failures = 0;
+
+  for (uint32_t i = 0; i < 1000; i++) {
+    MessageHeader header;
+    fillHeader(header, i);
+
+    uint8_t expected[32], actual[32];
+    hmacReference(secret, secretLen, (uint8_t*)&header, sizeof(header), expected);
+    if (!security.generateCommandHMAC(&header, actual) || memcmp(expected, actual, 32) != 0) {
+      failures++;
+    }
+    if (!security.validateCommandHMAC(&header, expected)) {
+      failures++;
+    }
+  }
+
+  // Challenge-Response über zwei Session-Keys (Response-Kontext wird neu gekeyt)
+  for (int round = 0; round < 2; round++) {
+    security.generateSessionKey();
+
+    uint8_t combinedKey[64] = {};
+    security.getSessionKey(combinedKey, 32);
+    memcpy(combinedKey + 32, SHARED_SECRET, strlen(SHARED_SECRET) < 32 ? strlen(SHARED_SECRET) : 32);
+
+    for (int i = 0; i < 100; i++) {
+      uint8_t challenge[16], expected[32], actual[32];
+      security.generateChallenge(challenge);
+      hmacReference(combinedKey, 64, challenge, 16, expected);
+      if (!security.generateResponse(challenge, actual) || memcmp(expected, actual, 32) != 0) {
+        failures++;
+      }
+      if (!security.validateResponse(challenge, actual, combinedKey)) {
+        failures++;
+      }
+    }
+  }
+
+  return failures;
+}
+
+// ==================== MESSUNG ====================
+
+template <typename F>
+static double measure(const char* name, long iterations, F&& fn) {
+  MessageHeader header;
+  uint8_t hmac[32];
+  uint8_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    fillHeader(header, (uint32_t)i);
+    fn(header, hmac);
+    sink ^= hmac[0];
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+  printf("%-12s %8.0f ns/Command  (%ld Aufrufe, sink %02x)\n", name, ns, iterations, sink);
+  return ns;
+}
+
+int main(int argc, char** argv) {
+  long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+  if (iterations <= 0) iterations = 1000000;
+
+  Security security;
+  security.begin(SHARED_SECRET);
+  security.generateSessionKey();
+
+  int failures = checkWireFormat(security);
+  printf("Funk-Format: %s (%d Abweichungen)\n", failures ? "FEHLER" : "identisch", failures);
+  if (failures) return 1;
+
+  const uint8_t* secret = (const uint8_t*)SHARED_SECRET;
+  size_t secretLen = strlen(SHARED_SECRET);
+
+  double before = measure("vorher", iterations, [&](const MessageHeader& h, uint8_t* out) {
+    hmacOneShot(secret, secretLen, (const uint8_t*)&h, sizeof(h), out);
+  });
+
+  mbedtls_md_context_t resetCtx;
+  mbedtls_md_init(&resetCtx);
+  mbedtls_md_setup(&resetCtx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+  mbedtls_md_hmac_starts(&resetCtx, secret, secretLen);
+  measure("hmac_reset", iterations, [&](const MessageHeader& h, uint8_t* out) {
+    mbedtls_md_hmac_reset(&resetCtx);
+    mbedtls_md_hmac_update(&resetCtx, (const uint8_t*)&h, sizeof(h));
+    mbedtls_md_hmac_finish(&resetCtx, out);
+  });
+  mbedtls_md_free(&resetCtx);
+
+  double after = measure("nachher", iterations, [&](const MessageHeader& h, uint8_t* out) {
+    security.generateCommandHMAC(&h, out);
+  });
+
+  printf("Faktor vorher/nachher: %.2fx\n", before / after);
+  return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Arduino.h (Host-Stub)
+ * Minimaler Ersatz, damit Security.cpp für tools/hmac_bench.cpp
+ * auf dem PC übersetzt werden kann. Nur was Config.h/Security.cpp nutzen.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <chrono>
+
+inline uint32_t millis() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+struct HostSerial {
+  void print(const char* s) { fputs(s, stdout); }
+  void println(const char* s) { puts(s); }
+  int printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+  }
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,17 @@
+/*
+ * esp_random.h (Host-Stub)
+ * Ersatz für den ESP32-Hardware-Zufallsgenerator auf dem PC.
+ */
+
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+#include <random>
+
+inline uint32_t esp_random() {
+  static std::mt19937 rng(std::random_device{}());
+  return rng();
+}
+
+#endif // HOST_ESP_RANDOM_H
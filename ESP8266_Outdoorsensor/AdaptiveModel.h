@@ -0,0 +1,167 @@
+/*
+ * AdaptiveModel.h
+ * Modellbasierte Wahl der Sleep-Periode (Kalman-Filter mit Trend)
+ *
+ * Pro Messgrösse (Temperatur, Luftdruck) ein 2-Zustands Kalman-Filter:
+ *   Zustand x = [Wert, Änderungsrate pro Sekunde], Modell "konstante Rate",
+ *   Prozessrauschen als Random Walk der Rate.
+ * Nach jeder Messung wird die nächste Periode so gewählt, dass die bis zum
+ * nächsten Wake erwartete Abweichung des gesendeten (rohen) Werts s, den der
+ * Empfänger bis dahin hält,
+ *   max(|Wert - s|, |Wert + Rate * dt - s|) + k * Sigma(dt)
+ * unter der konfigurierten Schranke bleibt. Einzelne verrauschte Werte
+ * verschieben die Rate nur wenig, langsame Rampen werden dagegen erkannt;
+ * ein stark verrauschter gesendeter Wert verkürzt dagegen die Periode.
+ * maxPeriod darf über der festen Standard-Periode liegen - nur so spart das
+ * Modell bei ruhigem Wetter Pakete ein.
+ *
+ * Der Zustand (AdaptiveState) liegt im RTC Memory des Sensors. Keine
+ * Arduino-Abhängigkeiten, damit tools/adaptive_sim.cpp denselben Code nutzt.
+ *
+ * Version: 1.1.0
+ */
+
+#ifndef ADAPTIVE_MODEL_H
+#define ADAPTIVE_MODEL_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ==================== DATENSTRUKTUREN ====================
+
+// Kalman-Filter einer Messgrösse (Kovarianz symmetrisch: p00, p01, p11)
+struct TrendFilter {
+    float value;                // Geschätzter Wert
+    float rate;                 // Geschätzte Änderung pro Sekunde
+    float p00, p01, p11;
+};
+
+// Im RTC Memory gehaltener Modellzustand
+struct AdaptiveState {
+    TrendFilter temp;
+    TrendFilter press;
+    uint8_t initialized;
+    uint8_t reserved[3];
+};
+
+struct AdaptiveConfig {
+    float tempBound;            // °C max. erwarteter Fehler bis zur nächsten Messung
+    float pressBound;           // mbar
+    float tempNoise;            // °C Messrauschen (1 Sigma)
+    float pressNoise;           // mbar
+    float tempRateDrift;        // °C/h Änderung der Rate pro Stunde (1 Sigma)
+    float pressRateDrift;       // mbar/h pro Stunde
+    float confidence;           // k: Sigma-Faktor der Fehlerschranke
+    uint16_t minPeriod;         // s
+    uint16_t maxPeriod;         // s
+};
+
+// ==================== HAUPT-KLASSE ====================
+
+class AdaptiveModel {
+private:
+    AdaptiveConfig cfg;
+
+    // Random-Walk Varianz der Rate pro Sekunde aus "Einheit/h pro Stunde"
+    static float processNoise(float ratePerHourDrift) {
+        float perSecond = ratePerHourDrift / 3600.0f;
+        return perSecond * perSecond / 3600.0f;
+    }
+
+    static void initFilter(TrendFilter& f, float z, float noise, float rateDrift) {
+        float rateSigma = rateDrift / 3600.0f;
+        f.value = z;
+        f.rate = 0;
+        f.p00 = noise * noise;
+        f.p01 = 0;
+        f.p11 = rateSigma * rateSigma;
+    }
+
+    static void updateFilter(TrendFilter& f, float z, float dt, float noise, float q) {
+        // Vorhersage
+        f.value += f.rate * dt;
+        f.p00 += 2.0f * dt * f.p01 + dt * dt * f.p11 + q * dt * dt * dt / 3.0f;
+        f.p01 += dt * f.p11 + q * dt * dt / 2.0f;
+        f.p11 += q * dt;
+
+        // Korrektur mit der Messung
+        float s = f.p00 + noise * noise;
+        float k0 = f.p00 / s;
+        float k1 = f.p01 / s;
+        float y = z - f.value;
+
+        f.value += k0 * y;
+        f.rate += k1 * y;
+        f.p11 -= k1 * f.p01;
+        f.p00 *= (1.0f - k0);
+        f.p01 *= (1.0f - k0);
+    }
+
+    /**
+     * Grösste erwartete Abweichung des gehaltenen Werts sent in [0, dt]
+     * Die Abweichung des Schätzwerts ist linear in dt, ihr Betrag konvex:
+     * das Maximum liegt an einem der Ränder. Monoton in dt (Bisektion).
+     */
+    float expectedError(const TrendFilter& f, float sent, float dt, float q) const {
+        float var = f.p00 + 2.0f * dt * f.p01 + dt * dt * f.p11 + q * dt * dt * dt / 3.0f;
+        if (var < 0) var = 0;
+        float now = fabsf(f.value - sent);
+        float later = fabsf(f.value + f.rate * dt - sent);
+        return (now > later ? now : later) + cfg.confidence * sqrtf(var);
+    }
+
+    // Längste Periode in [minPeriod, maxPeriod] mit Fehler <= bound (Bisektion)
+    uint16_t periodFor(const TrendFilter& f, float sent, float bound, float q) const {
+        if (expectedError(f, sent, cfg.maxPeriod, q) <= bound) return cfg.maxPeriod;
+        if (expectedError(f, sent, cfg.minPeriod, q) > bound) return cfg.minPeriod;
+
+        uint16_t lo = cfg.minPeriod, hi = cfg.maxPeriod;
+        while (hi - lo > 1) {
+            uint16_t mid = lo + (hi - lo) / 2;
+            if (expectedError(f, sent, mid, q) <= bound) lo = mid;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+public:
+    explicit AdaptiveModel(const AdaptiveConfig& config) : cfg(config) {}
+
+    /** Zustand verwerfen (RTC ungültig oder Sensor getauscht) */
+    static void reset(AdaptiveState& st) {
+        st.initialized = 0;
+    }
+
+    /**
+     * Messung einbauen
+     * @param dtSec Sekunden seit der vorherigen Messung
+     */
+    void update(AdaptiveState& st, float temp, float press, uint32_t dtSec) const {
+        if (!st.initialized) {
+            initFilter(st.temp, temp, cfg.tempNoise, cfg.tempRateDrift);
+            initFilter(st.press, press, cfg.pressNoise, cfg.pressRateDrift);
+            st.initialized = 1;
+            return;
+        }
+
+        float dt = (float)dtSec;
+        updateFilter(st.temp, temp, dt, cfg.tempNoise, processNoise(cfg.tempRateDrift));
+        updateFilter(st.press, press, dt, cfg.pressNoise, processNoise(cfg.pressRateDrift));
+    }
+
+    /**
+     * Nächste Sleep-Periode
+     * @param sentTemp/sentPress Gesendete Rohwerte, die der Empfänger bis zum
+     *        nächsten Paket hält (ohne gültige Messung: st.temp.value/st.press.value)
+     * @return Sekunden; die strengere der beiden Messgrössen entscheidet
+     */
+    uint16_t nextPeriod(const AdaptiveState& st, float sentTemp, float sentPress) const {
+        if (!st.initialized) return cfg.minPeriod;
+
+        uint16_t tempPeriod = periodFor(st.temp, sentTemp, cfg.tempBound, processNoise(cfg.tempRateDrift));
+        uint16_t pressPeriod = periodFor(st.press, sentPress, cfg.pressBound, processNoise(cfg.pressRateDrift));
+        return (tempPeriod < pressPeriod) ? tempPeriod : pressPeriod;
+    }
+};
+
+#endif // ADAPTIVE_MODEL_H
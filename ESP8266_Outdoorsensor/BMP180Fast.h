@@ -0,0 +1,214 @@
+/*
+ * BMP180Fast.h
+ * Schlanker BMP180 Treiber für Deep-Sleep Sensoren
+ *
+ * Gegenüber SFE_BMP180:
+ * - Kalibrierung (22 Bytes EEPROM) wird vom Sketch im RTC Memory gehalten
+ *   und per Prüfsumme validiert; begin() liest sie nur nach Power-On oder
+ *   bei ungültigem Cache über I2C.
+ * - Keine festen Wartezeiten: das Sco-Bit im Control-Register wird gepollt,
+ *   die Messung endet sobald der Sensor fertig ist (Timeout = Datenblatt-Maximum).
+ * - Oversampling pro Messung wählbar (0..3).
+ * - Kompensation mit der Integer-Formel aus dem Datenblatt.
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef BMP180_FAST_H
+#define BMP180_FAST_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// ==================== KONSTANTEN ====================
+
+#define BMP180_ADDR 0x77
+#define BMP180_REG_CALIB 0xAA           // AC1..MD, 22 Bytes Big Endian
+#define BMP180_REG_CHIP_ID 0xD0
+#define BMP180_REG_CONTROL 0xF4
+#define BMP180_REG_RESULT 0xF6
+#define BMP180_CHIP_ID 0x55
+#define BMP180_CMD_TEMPERATURE 0x2E
+#define BMP180_CMD_PRESSURE 0x34        // + (oss << 6)
+#define BMP180_SCO_BIT 0x20             // 1 = Wandlung läuft
+
+#define BMP180_POLL_US 500              // Abstand der Sco-Abfragen
+
+// ==================== DATENSTRUKTUREN ====================
+
+// Kalibrierung, im RTC Memory des Sketches abgelegt
+struct BMP180Calibration {
+    int16_t ac1, ac2, ac3;
+    uint16_t ac4, ac5, ac6;
+    int16_t b1, b2, mb, mc, md;
+    uint16_t checksum;          // CRC-16 über die 22 Bytes davor
+};
+
+static_assert(sizeof(BMP180Calibration) % 4 == 0, "RTC memory needs 4-byte multiples");
+
+// ==================== HAUPT-KLASSE ====================
+
+class BMP180Fast {
+private:
+    BMP180Calibration cal;
+
+    // Max. Wandlungszeit laut Datenblatt in µs (Temperatur = oss 0)
+    static uint32_t maxConversionUs(uint8_t oss) {
+        static const uint16_t table[4] = { 4500, 7500, 13500, 25500 };
+        return table[oss & 3];
+    }
+
+    static bool writeReg(uint8_t reg, uint8_t value) {
+        Wire.beginTransmission(BMP180_ADDR);
+        Wire.write(reg);
+        Wire.write(value);
+        return Wire.endTransmission() == 0;
+    }
+
+    static bool readRegs(uint8_t reg, uint8_t* buf, uint8_t len) {
+        Wire.beginTransmission(BMP180_ADDR);
+        Wire.write(reg);
+        if (Wire.endTransmission(false) != 0) return false;
+        if (Wire.requestFrom((uint8_t)BMP180_ADDR, len) != len) return false;
+        for (uint8_t i = 0; i < len; i++) buf[i] = Wire.read();
+        return true;
+    }
+
+    // Wandlung starten und auf Sco = 0 warten
+    static bool convert(uint8_t cmd, uint8_t oss, uint8_t* result, uint8_t len) {
+        if (!writeReg(BMP180_REG_CONTROL, cmd)) return false;
+
+        uint32_t start = micros();
+        uint8_t control;
+        do {
+            delayMicroseconds(BMP180_POLL_US);
+            if (!readRegs(BMP180_REG_CONTROL, &control, 1)) return false;
+            if (micros() - start > maxConversionUs(oss) + BMP180_POLL_US) return false;
+        } while (control & BMP180_SCO_BIT);
+
+        return readRegs(BMP180_REG_RESULT, result, len);
+    }
+
+public:
+    BMP180Fast() {
+        memset(&cal, 0, sizeof(cal));
+    }
+
+    /** CRC-16/CCITT über die Kalibrierwerte */
+    static uint16_t checksum(const BMP180Calibration& c) {
+        const uint8_t* p = (const uint8_t*)&c;
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < offsetof(BMP180Calibration, checksum); i++) {
+            crc ^= (uint16_t)p[i] << 8;
+            for (uint8_t b = 0; b < 8; b++) {
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    static bool isValid(const BMP180Calibration& c) {
+        return c.checksum == checksum(c);
+    }
+
+    /**
+     * Kalibrierung übernehmen oder vom Sensor lesen
+     * @param cache Kalibrierung aus dem RTC Memory; wird bei ungültiger
+     *              Prüfsumme neu gelesen und aktualisiert
+     * @param loaded true wenn über I2C gelesen wurde (Sketch muss cache speichern)
+     * @return false wenn der Sensor nicht antwortet
+     */
+    bool begin(BMP180Calibration& cache, bool& loaded) {
+        loaded = false;
+        if (isValid(cache)) {
+            cal = cache;
+            return true;
+        }
+
+        uint8_t id;
+        if (!readRegs(BMP180_REG_CHIP_ID, &id, 1) || id != BMP180_CHIP_ID) return false;
+
+        uint8_t raw[22];
+        if (!readRegs(BMP180_REG_CALIB, raw, sizeof(raw))) return false;
+
+        // Kommunikationsprüfung laut Datenblatt: kein Wort 0x0000 oder 0xFFFF
+        uint16_t words[11];
+        for (int i = 0; i < 11; i++) {
+            words[i] = ((uint16_t)raw[i * 2] << 8) | raw[i * 2 + 1];
+            if (words[i] == 0x0000 || words[i] == 0xFFFF) return false;
+        }
+
+        cal.ac1 = (int16_t)words[0];
+        cal.ac2 = (int16_t)words[1];
+        cal.ac3 = (int16_t)words[2];
+        cal.ac4 = words[3];
+        cal.ac5 = words[4];
+        cal.ac6 = words[5];
+        cal.b1 = (int16_t)words[6];
+        cal.b2 = (int16_t)words[7];
+        cal.mb = (int16_t)words[8];
+        cal.mc = (int16_t)words[9];
+        cal.md = (int16_t)words[10];
+        cal.checksum = checksum(cal);
+
+        cache = cal;
+        loaded = true;
+        return true;
+    }
+
+    /**
+     * Temperatur und Druck messen
+     * @param oss Oversampling 0..3 (höher = genauer, langsamer, mehr Strom)
+     * @param temp °C
+     * @param pressure mbar
+     * @return 0 = OK, 2 = Temperatur-Wandlung, 4 = Druck-Wandlung fehlgeschlagen
+     *         (Codes wie readBMP180() mit SFE_BMP180)
+     */
+    int read(uint8_t oss, double& temp, double& pressure) {
+        oss &= 3;
+        uint8_t buf[3];
+
+        if (!convert(BMP180_CMD_TEMPERATURE, 0, buf, 2)) return 2;
+        int32_t ut = ((int32_t)buf[0] << 8) | buf[1];
+
+        if (!convert(BMP180_CMD_PRESSURE + (oss << 6), oss, buf, 3)) return 4;
+        int32_t up = (((int32_t)buf[0] << 16) | ((int32_t)buf[1] << 8) | buf[2]) >> (8 - oss);
+
+        int32_t b5 = computeB5(cal, ut);
+        temp = (b5 + 8) / 160.0;
+        pressure = computePressure(cal, up, oss, b5) / 100.0;
+        return 0;
+    }
+
+    // ==================== KOMPENSATION (Datenblatt) ====================
+
+    static int32_t computeB5(const BMP180Calibration& c, int32_t ut) {
+        int32_t x1 = ((ut - (int32_t)c.ac6) * (int32_t)c.ac5) >> 15;
+        int32_t x2 = ((int32_t)c.mc << 11) / (x1 + c.md);
+        return x1 + x2;
+    }
+
+    /** @return Druck in Pa */
+    static int32_t computePressure(const BMP180Calibration& c, int32_t up, uint8_t oss, int32_t b5) {
+        int32_t b6 = b5 - 4000;
+        int32_t x1 = (c.b2 * ((b6 * b6) >> 12)) >> 11;
+        int32_t x2 = (c.ac2 * b6) >> 11;
+        int32_t x3 = x1 + x2;
+        int32_t b3 = ((((int32_t)c.ac1 * 4 + x3) << oss) + 2) / 4;
+
+        x1 = (c.ac3 * b6) >> 13;
+        x2 = (c.b1 * ((b6 * b6) >> 12)) >> 16;
+        x3 = ((x1 + x2) + 2) >> 2;
+        uint32_t b4 = ((uint32_t)c.ac4 * (uint32_t)(x3 + 32768)) >> 15;
+        uint32_t b7 = ((uint32_t)up - b3) * (uint32_t)(50000 >> oss);
+
+        int32_t p = (b7 < 0x80000000) ? (int32_t)((b7 * 2) / b4) : (int32_t)((b7 / b4) * 2);
+
+        x1 = (p >> 8) * (p >> 8);
+        x1 = (x1 * 3038) >> 16;
+        x2 = (-7357 * p) >> 16;
+        return p + ((x1 + x2 + 3791) >> 4);
+    }
+};
+
+#endif // BMP180_FAST_H
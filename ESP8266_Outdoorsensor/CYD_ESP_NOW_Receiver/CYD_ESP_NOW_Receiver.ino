@@ -22,6 +22,9 @@
 #include <WiFi.h>
 #include <esp_now.h>
 #include <esp_wifi.h>
+#include "SensorIngest.h"
+#include "FrameRing.h"
+#include "Freshness.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -32,7 +35,7 @@
 #define DISPLAY_ROTATION 3
 
 // Update Intervall für "Zeit seit letztem Empfang"
-#define TIME_UPDATE_INTERVAL 5000  // 5 Sekunden
+#define TIME_UPDATE_INTERVAL 5000  // 5 Sekunden (nur Altersanzeige)
 
 // ==================== FARBEN ====================
 
@@ -55,33 +58,7 @@
 
 // ==================== DATENSTRUKTUR ====================
 
-typedef struct sensor_data_indoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  float humidity;
-  uint8_t am2321_readings;
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;
-  uint16_t sleep_time_sec;
-} sensor_data_indoor;
-
-typedef struct sensor_data_outdoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;
-  uint16_t sleep_time_sec;
-} sensor_data_outdoor;
+// Pakete, Schemas und Geräte-Tabelle: siehe SensorIngest.h
 
 // ==================== GLOBALE VARIABLEN ====================
 
@@ -91,8 +68,15 @@ LGFX lcd;  // Display Objekt
 LGFX_Sprite indoorSprite(&lcd);
 LGFX_Sprite outdoorSprite(&lcd);
 
-sensor_data_indoor indoorData;
-sensor_data_outdoor outdoorData;
+// Geräte-Tabelle (pro Sender-MAC); angezeigt wird der erste Sensor je Schema
+SensorIngest ingest;
+
+// Empfangs-Ring: Callback -> loop() (Arduino Loop-Task als Worker)
+FrameRing<> frameRing;
+TaskHandle_t workerTaskHandle = nullptr;
+
+SensorSample indoorData;
+SensorSample outdoorData;
 
 bool indoorReceived = false;
 bool outdoorReceived = false;
@@ -105,6 +89,12 @@ unsigned long lastIndoorReceive = 0;
 unsigned long lastOutdoorReceive = 0;
 unsigned long lastTimeUpdate = 0;
 
+// Aktualität (fresh/late/lost) aus den gelernten Paketabständen
+SensorFreshness indoorFreshness;
+SensorFreshness outdoorFreshness;
+FreshnessState shownIndoorState = FRESHNESS_NONE;
+FreshnessState shownOutdoorState = FRESHNESS_NONE;
+
 int indoorRSSI = 0;
 int outdoorRSSI = 0;
 
@@ -114,26 +104,56 @@ bool is480p = false;  // true für 320x480, false für 240x320
 
 // ==================== ESP-NOW CALLBACK ====================
 
+// Läuft im WiFi-Task: nur kopieren und loop() wecken
 void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int data_len) {
-  // Sensor-Typ erkennen
-  bool isIndoor = (data_len >= sizeof(sensor_data_indoor));
+  frameRing.push(recv_info->src_addr, data, data_len, recv_info->rx_ctrl->rssi, millis());
+  if (workerTaskHandle) xTaskNotifyGive(workerTaskHandle);
+}
+
+// Dekodierung und Weiterverarbeitung im Loop-Task
+void processFrame(const RawFrame& frame) {
+  // Zeit-Beacons der Bridge sind keine Messwerte
+  if (sensorPacketIsControl(frame.data, frame.len)) return;
+
+  SensorDevice* dev = ingest.ingest(frame.mac, frame.data, frame.len,
+                                    frame.rssi, frame.rxMs);
+  if (!dev) {
+    Serial.println("[INGEST] Packet dropped (unknown schema or table full)");
+    return;
+  }
+  dev->hasNewData = false;
 
-  if (isIndoor) {
-    memcpy(&indoorData, data, min((int)sizeof(indoorData), data_len));
+  // Batch-Paket: angezeigt wird nur der aktuelle Wert
+  uint8_t batchCount = SensorIngest::getBatchCount(*dev, frame.data, frame.len);
+  if (batchCount > 0) {
+    Serial.printf("[INGEST] %s: %u buffered samples in batch\n",
+                  SensorIngest::getSchemaName(dev->schema), batchCount);
+  }
+
+  if (dev->ordinal != 0) {
+    Serial.printf("[INGEST] %s sensor #%d: %.1f°C (not displayed)\n",
+                  SensorIngest::getSchemaName(dev->schema), dev->ordinal + 1, dev->last.temperature);
+    return;
+  }
+
+  if (dev->schema == SCHEMA_INDOOR) {
+    indoorData = dev->last;
     indoorReceived = true;
-    lastIndoorReceive = millis();
-    indoorRSSI = recv_info->rx_ctrl->rssi;
+    lastIndoorReceive = frame.rxMs;
+    indoorFreshness.arrival(frame.rxMs, indoorData.sleep_time_sec);
+    indoorRSSI = dev->link.rssi;
     indoorNeedsUpdate = true;  // Flag setzen statt direkt zeichnen
 
     Serial.println("\n=== Indoor Data Received ===");
     Serial.printf("Temp: %.1f°C, Hum: %.1f%%, Press: %.1f mbar\n",
                   indoorData.temperature, indoorData.humidity, indoorData.pressure);
     Serial.printf("Battery: %d mV, RSSI: %d dBm\n", indoorData.battery_voltage, indoorRSSI);
-  } else {
-    memcpy(&outdoorData, data, min((int)sizeof(outdoorData), data_len));
+  } else if (dev->schema == SCHEMA_OUTDOOR) {
+    outdoorData = dev->last;
     outdoorReceived = true;
-    lastOutdoorReceive = millis();
-    outdoorRSSI = recv_info->rx_ctrl->rssi;
+    lastOutdoorReceive = frame.rxMs;
+    outdoorFreshness.arrival(frame.rxMs, outdoorData.sleep_time_sec);
+    outdoorRSSI = dev->link.rssi;
     outdoorNeedsUpdate = true;  // Flag setzen statt direkt zeichnen
 
     Serial.println("\n=== Outdoor Data Received ===");
@@ -143,6 +163,14 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
   }
 }
 
+void drainFrameRing() {
+  const RawFrame* frame;
+  while ((frame = frameRing.peek()) != nullptr) {
+    processFrame(*frame);
+    frameRing.release();
+  }
+}
+
 // ==================== DISPLAY FUNKTIONEN ====================
 
 // Farbe basierend auf RSSI
@@ -163,6 +191,13 @@ String formatTime(unsigned long seconds) {
   }
 }
 
+// Farbe der Altersanzeige: grau = pünktlich, orange = überfällig, rot = verloren
+uint16_t freshnessColor(FreshnessState state) {
+  if (state == FRESHNESS_LATE) return COLOR_RSSI_MEDIUM;
+  if (state == FRESHNESS_LOST) return COLOR_BATTERY_LOW;
+  return COLOR_TEXT_DIM;
+}
+
 // Header zeichnen
 void drawHeader() {
   // Gradient Header
@@ -226,7 +261,8 @@ void drawIndoorSection() {
   int lineHeight = is480p ? 35 : 28;
   int centerX = spriteW / 2;
   unsigned long secondsAgo = (millis() - lastIndoorReceive) / 1000;
-  bool dataValid (secondsAgo <= (2.1 * indoorData.sleep_time_sec));
+  shownIndoorState = indoorFreshness.state(millis());
+  bool dataValid = (shownIndoorState != FRESHNESS_LOST);
 
   // Temperatur mit Gradzeichen
   indoorSprite.setFont(is480p ? &fonts::FreeSansBold24pt7b : &fonts::FreeSansBold18pt7b);
@@ -274,7 +310,7 @@ void drawIndoorSection() {
   
   //indoorSprite.setFont(&fonts::FreeSans9pt7b);
   indoorSprite.setFont(&fonts::Font2);
-  indoorSprite.setTextColor(COLOR_TEXT_DIM);
+  indoorSprite.setTextColor(freshnessColor(shownIndoorState));
   indoorSprite.drawString(formatTime(secondsAgo), centerX, contentY);
 
   // Sprite auf Display pushen (KEIN deleteSprite!)
@@ -316,7 +352,8 @@ void drawOutdoorSection() {
   int lineHeight = is480p ? 35 : 28;
   int centerX = spriteW / 2;
   unsigned long secondsAgo = (millis() - lastOutdoorReceive) / 1000;
-  bool dataValid (secondsAgo <= (2.1 * outdoorData.sleep_time_sec));
+  shownOutdoorState = outdoorFreshness.state(millis());
+  bool dataValid = (shownOutdoorState != FRESHNESS_LOST);
 
   // Temperatur mit Gradzeichen
   outdoorSprite.setFont(is480p ? &fonts::FreeSansBold24pt7b : &fonts::FreeSansBold18pt7b);
@@ -364,7 +401,7 @@ void drawOutdoorSection() {
   //unsigned long secondsAgo = (millis() - lastOutdoorReceive) / 1000;
   //outdoorSprite.setFont(&fonts::FreeSans9pt7b);
   outdoorSprite.setFont(&fonts::Font2);
-  outdoorSprite.setTextColor(COLOR_TEXT_DIM);
+  outdoorSprite.setTextColor(freshnessColor(shownOutdoorState));
   outdoorSprite.drawString(formatTime(secondsAgo), centerX, contentY);
 
   // Sprite auf Display pushen (KEIN deleteSprite!)
@@ -476,6 +513,9 @@ void setup() {
 
   Serial.println("✓ ESP-NOW initialized");
 
+  // setup() läuft bereits im Loop-Task, der die Frames verarbeitet
+  workerTaskHandle = xTaskGetCurrentTaskHandle();
+
   // Receive Callback registrieren
   esp_now_register_recv_cb(onDataRecv);
   Serial.println("✓ Receive callback registered");
@@ -486,6 +526,9 @@ void setup() {
 // ==================== LOOP ====================
 
 void loop() {
+  // Empfangene Frames verarbeiten
+  drainFrameRing();
+
   // Daten-Updates wenn neue Daten empfangen wurden
   if (indoorNeedsUpdate) {
     indoorNeedsUpdate = false;
@@ -497,11 +540,33 @@ void loop() {
     drawOutdoorSection();
   }
 
-  // Regelmäßig Zeit-Updates
+  // Zustandswechsel fresh/late/lost sofort zeichnen
+  unsigned long now = millis();
+  if (indoorReceived && indoorFreshness.state(now) != shownIndoorState) {
+    Serial.printf("[FRESH] Indoor: %s\n", SensorFreshness::stateName(indoorFreshness.state(now)));
+    drawIndoorSection();
+  }
+  if (outdoorReceived && outdoorFreshness.state(now) != shownOutdoorState) {
+    Serial.printf("[FRESH] Outdoor: %s\n", SensorFreshness::stateName(outdoorFreshness.state(now)));
+    drawOutdoorSection();
+  }
+
+  // Regelmäßig Zeit-Updates (Altersanzeige)
   if (millis() - lastTimeUpdate >= TIME_UPDATE_INTERVAL) {
     lastTimeUpdate = millis();
     updateTimes();
+
+    static uint32_t reportedDrops = 0;
+    if (frameRing.getDropped() != reportedDrops) {
+      reportedDrops = frameRing.getDropped();
+      Serial.printf("[ESP-NOW] Frames dropped (ring full): %lu\n", (unsigned long)reportedDrops);
+    }
   }
 
-  delay(100);
+  // Schlafen bis Frame, nächster Zustandswechsel oder Altersanzeige
+  now = millis();
+  unsigned long wait = TIME_UPDATE_INTERVAL - min(now - lastTimeUpdate, (unsigned long)TIME_UPDATE_INTERVAL);
+  wait = freshnessSooner(wait, indoorFreshness.nextChange(now));
+  wait = freshnessSooner(wait, outdoorFreshness.nextChange(now));
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait + 1));
 }
\ No newline at end of file
@@ -15,12 +15,22 @@
 #include <Credentials.h>
 #include <WiFi.h>
 #include <time.h>
+#include <sys/time.h>
 #include <SD.h>
 #include <SPI.h>
 #include <WebServer.h>
 #include <InfluxDbClient.h>
 #include <InfluxDbCloud.h>
 #include "I2CSensorBridge.h"
+#include "Metrics.h"
+#include "RetainedText.h"
+#include "GraphPageCache.h"
+#include "RollingMinMax.h"
+#include "CsvReader.h"
+#include "CsvIndex.h"
+#include "ScratchArena.h"
+#include "TouchGesture.h"
+#include "Freshness.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -57,11 +67,18 @@ SPIClass sdSPI(VSPI);
 // Display
 #define DISPLAY_ROTATION 3             // Landscape
 
+// Touch (XPT2046 PENIRQ, CYD Standard: GPIO36; -1 = Polling ohne IRQ)
+#ifndef TOUCH_IRQ_PIN
+  #define TOUCH_IRQ_PIN 36
+#endif
+#define TOUCH_SAMPLE_MS 10             // Abtastintervall solange berührt
+#define TOUCH_QUEUE_LENGTH 8
+
 // Update-Intervalle (ms)
 #define I2C_POLL_INTERVAL 1000        // I2C alle 1 Sekunde abfragen
-#define DISPLAY_UPDATE_INTERVAL 5000  // Display-Zeit alle 5 Sekunden
 #define WIFI_RETRY_INTERVAL 30000     // WiFi-Reconnect alle 30 Sekunden
 #define SD_LOG_INTERVAL 900000        // SD-Log alle 15 Minuten (900000 ms)
+#define TIME_SYNC_INTERVAL 60000      // NTP-Zeit jede Minute an die Bridge schreiben
 
 // ==================== INFLUXDB KONFIGURATION ====================
 // WICHTIG: Setze diese Werte in deiner Credentials.h oder hier direkt
@@ -123,6 +140,40 @@ struct SystemStatus {
     unsigned long outdoor_last_seen;  // Millisekunden
     uint16_t esp_now_packets;
     uint8_t wifi_channel;
+    uint16_t frames_dropped;          // Bridge: Empfangs-Ring voll
+} __attribute__((packed));
+
+// Link-Qualität pro Sensor (Bridge, Struct 0x05; Werte sättigen bei 0xFFFF)
+#define LINK_EXPORT_MAX 5
+
+struct LinkStatsEntry {
+    uint8_t mac[3];             // Letzte 3 Bytes der Sender-MAC
+    uint8_t schema;             // 1 = Outdoor, 2 = Indoor
+    uint8_t ordinal;            // 0 = primärer Sensor des Schemas
+    int8_t rssi_avg;            // dBm (EWMA)
+    int8_t rssi_p10;            // dBm, schwächste 10%
+    int8_t rssi_p50;
+    int8_t rssi_p90;
+    uint16_t packets;
+    uint16_t lost;
+    uint16_t loss_recent_pm;    // Gleitende Verlustrate in Promille
+    uint16_t retries;
+    uint16_t jitter_ms;         // Mittlere Abweichung des Paketabstands
+    uint16_t last_seen_sec;
+} __attribute__((packed));
+
+struct LinkStatsTable {
+    uint8_t count;              // Gültige Einträge
+    uint8_t total;              // Sensoren in der Geräte-Tabelle der Bridge
+    LinkStatsEntry entries[LINK_EXPORT_MAX];
+} __attribute__((packed));
+
+// Uhrzeit für die Bridge (Master schreibt, Bridge verteilt sie per Zeit-Beacon)
+struct TimeSyncData {
+    uint32_t epoch;         // UTC Sekunden
+    uint16_t epoch_ms;      // Millisekunden-Anteil
+    int16_t utc_offset_min; // Lokalzeit = UTC + Offset (inkl. Sommerzeit)
+    uint8_t valid;          // 1 = NTP-Zeit gültig
 } __attribute__((packed));
 
 // ==================== DISPLAY FARBEN ====================
@@ -144,19 +195,16 @@ struct SystemStatus {
 
 // ==================== MIN/MAX TRACKING ====================
 
-// Struktur für Min/Max-Werte
-struct MinMaxData {
-    float tempMin;
-    float tempMax;
-    float humMin;           // nur Indoor
-    float humMax;           // nur Indoor
-    float pressMin;
-    float pressMax;
-    uint16_t batteryMin;
-    uint16_t batteryMax;
-    unsigned long lastReset;  // Zeitstempel des letzten Resets
+// Gleitendes 24h-Fenster pro Messgrösse (monotone Deques, siehe RollingMinMax.h)
+enum MinMaxQuantity {
+    MM_INDOOR_TEMP, MM_INDOOR_HUM, MM_INDOOR_PRESS, MM_INDOOR_BATT,
+    MM_OUTDOOR_TEMP, MM_OUTDOOR_PRESS, MM_OUTDOOR_BATT,
+    MM_QUANTITY_COUNT
 };
 
+#define MINMAX_SNAPSHOT_FILE "/minmax24.bin"
+#define MINMAX_SNAPSHOT_TMP  "/minmax24.tmp"
+
 // ==================== GLOBALE VARIABLEN ====================
 
 // Display
@@ -167,13 +215,45 @@ int screenWidth = 320;
 int screenHeight = 240;
 bool is480p = false;
 
-// Display Mode
-uint8_t displayMode = 0;       // 0 = Normal, 1 = Outdoor Graph, 2 = Battery Graph, 3 = Min/Max
-unsigned long lastTouchTime = 0;
-unsigned long lastModeChange = 0;
-const unsigned long TOUCH_DEBOUNCE = 300;  // 300ms Debounce
+// Retained-Mode Felder für Normal-Modus (nur geänderte Felder werden gepusht)
+RetainedTextLayer retained(&lcd);
+
+enum HeaderField { HDR_TIME, HDR_BRIDGE, HDR_SD, HDR_WIFI, HDR_IP, HEADER_FIELD_COUNT };
+enum SensorField { FIELD_TEMP, FIELD_HUM, FIELD_PRESS, FIELD_BATT, FIELD_RSSI, FIELD_AGE, SENSOR_FIELD_COUNT };
+
+RetainedField headerFields[HEADER_FIELD_COUNT];
+RetainedField indoorFields[SENSOR_FIELD_COUNT];
+RetainedField outdoorFields[SENSOR_FIELD_COUNT];
+bool indoorFieldsActive = false;   // Spalte zeigt Messwerte (nicht "Waiting")
+bool outdoorFieldsActive = false;
+
+// Graph-Seiten: im Hintergrund vorgerendert, Seitenwechsel = ein DMA-Push
+GraphPageCache graphPages(&lcd);
+enum GraphPage { GRAPH_PAGE_OUTDOOR, GRAPH_PAGE_BATTERY };
+bool graphPagesDirty = true;                   // CSV hat neue Daten -> neu laden + rendern
+unsigned long lastGraphRefresh = 0;
+const unsigned long GRAPH_REFRESH_RETRY = 60000;  // Retry wenn Laden fehlschlägt (z.B. noch keine Zeit)
+
+// Display Mode (wird vom UI-Task und von loop() gelesen/geschrieben)
+#define DISPLAY_MODE_COUNT 5
+volatile uint8_t displayMode = 0;       // 0 = Normal, 1 = Outdoor Graph, 2 = Battery Graph, 3 = Min/Max, 4 = Diagnose
+volatile unsigned long lastModeChange = 0;
 const unsigned long AUTO_RETURN_TIME = 30000;  // 30s Auto-Return zu Schirm 1
 
+// Display-Zugriff aus loop(), Touch- und UI-Task serialisieren
+// Rekursiv, weil z.B. updateDisplay() aus gesperrten Abschnitten aufgerufen wird
+SemaphoreHandle_t displayMutex = nullptr;
+
+class DisplayLock {
+public:
+    DisplayLock() { xSemaphoreTakeRecursive(displayMutex, portMAX_DELAY); }
+    ~DisplayLock() { xSemaphoreGiveRecursive(displayMutex); }
+};
+
+// Touch: IRQ -> touchTask (Samples, Gesten) -> touchQueue -> uiTask (Moduswechsel, Rendern)
+TaskHandle_t touchTaskHandle = nullptr;
+QueueHandle_t touchQueue = nullptr;
+
 // Graph Daten (240 Messwerte)
 #define GRAPH_DATA_POINTS 240
 struct GraphData {
@@ -191,6 +271,20 @@ struct GraphData {
     bool indoorLoaded;
 } graphData;
 
+// Lade-Puffer der Graph-Loader: statische Arena statt malloc/free
+// Grösse = Worst-Case der Allokationen (aktueller Monat + Vormonat),
+// ein Fehlschlag ist damit ausgeschlossen. Reset nach jedem Ladevorgang.
+#define GRAPH_LOAD_BUFFER 500   // Max. Zeilen aus der aktuellen Monatsdatei (~5 Tage)
+#define GRAPH_ROWS_ARENA_BYTES(rows) \
+    (2 * ARENA_BYTES(float, rows) + ARENA_BYTES(uint16_t, rows) + ARENA_BYTES(bool, rows))
+#define GRAPH_ARENA_SIZE \
+    (GRAPH_ROWS_ARENA_BYTES(GRAPH_LOAD_BUFFER) + GRAPH_ROWS_ARENA_BYTES(GRAPH_DATA_POINTS))
+
+// Vormonat wird höchstens bis GRAPH_DATA_POINTS aufgefüllt und muss in den Puffer passen
+static_assert(GRAPH_DATA_POINTS <= GRAPH_LOAD_BUFFER, "Graph load buffer smaller than graph");
+
+ScratchArena<GRAPH_ARENA_SIZE> graphArena;
+
 // I2C Bridge
 I2CSensorBridge i2cBridge;
 
@@ -198,10 +292,12 @@ I2CSensorBridge i2cBridge;
 IndoorData indoorData;
 OutdoorData outdoorData;
 SystemStatus systemStatus;
+TimeSyncData timeSyncData;
+LinkStatsTable linkStats;
+bool linkStatsReceived = false;
 
-// Min/Max Tracking
-MinMaxData indoorMinMax;
-MinMaxData outdoorMinMax;
+// Min/Max Tracking (24h gleitend, überlebt Reboot via SD-Snapshot)
+RollingMinMaxSet<MM_QUANTITY_COUNT> minMax24;
 
 // Status
 bool indoorReceived = false;
@@ -209,9 +305,21 @@ bool outdoorReceived = false;
 unsigned long lastIndoorUpdate = 0;
 unsigned long lastOutdoorUpdate = 0;
 
+// Aktualität (fresh/late/lost) aus den gelernten Paketabständen
+SensorFreshness indoorFreshness;
+SensorFreshness outdoorFreshness;
+unsigned long freshnessTimerStart = 0;          // Weck-Timer für Zustandswechsel
+unsigned long freshnessTimerMs = FRESHNESS_NEVER;
+
+// Normal-Schirm: Redraw nur bei neuen Daten/Status oder zum nächsten Termin
+// (Minutenwechsel der Uhr, fresh/late/lost-Wechsel) statt periodisch
+bool redrawRequested = true;
+unsigned long redrawTimerStart = 0;
+unsigned long redrawTimerMs = FRESHNESS_NEVER;
+
 // Timing
 unsigned long lastI2CPoll = 0;
-unsigned long lastDisplayUpdate = 0;
+unsigned long lastTimeSync = 0;
 unsigned long lastWiFiRetry = 0;
 
 // WiFi & Zeit
@@ -221,6 +329,8 @@ bool timeConfigured = false;
 // SD-Karte
 bool sdCardAvailable = false;
 unsigned long lastSDLog = 0;
+CsvIndexState indoorIndex = {};   // Sidecar-Index der aktuellen Monatsdatei
+CsvIndexState outdoorIndex = {};
 String currentDateString = "";
 
 // Webserver
@@ -234,6 +344,22 @@ WebServer server(80);
   #define INFLUX_RETRY_INTERVAL 60000  // Retry alle 60 Sekunden
 #endif
 
+// Performance-Metriken (abrufbar über /metrics)
+LatencyHistogram i2cLatency;       // ping, Status, Struct lesen
+MetricCounter i2cErrors;
+LatencyHistogram sdWriteLatency;   // open + print einer Log-Zeile
+LatencyHistogram sdFlushLatency;   // close (schreibt den FAT-Puffer)
+LatencyHistogram loopLatency;      // ein loop()-Durchlauf ohne delay()
+LatencyHistogram frameLatency;     // ein Display-Update
+LatencyHistogram touchLatency;     // Geste erkannt -> erste Ausgabe des neuen Schirms
+LatencyHistogram gestureDuration;  // Erste Berührung -> Geste erkannt
+MetricCounter touchEventsDropped;  // Gesten verworfen (Queue voll)
+#ifdef ENABLE_INFLUXDB
+  MetricCounter influxWritesOk;
+  MetricCounter influxWritesFailed;
+  uint16_t influxQueueDepth = 0;   // Näherung: Punkte seit letztem erfolgreichem Write
+#endif
+
 // ==================== DISPLAY FUNKTIONEN ====================
 
 uint16_t getRSSIColor(int rssi) {
@@ -249,69 +375,138 @@ String formatTime(unsigned long seconds) {
     return String(seconds / 3600) + "h " + String((seconds % 3600) / 60) + "min";
 }
 
-void drawHeader() {
-    // Gradient Header
+// Farbe des Header-Verlaufs in Zeile y
+uint16_t headerGradientColor(int y) {
     int headerHeight = is480p ? 50 : 35;
-    for (int y = 0; y < headerHeight; y++) {
-        uint8_t blue = 31 - (y * 31 / headerHeight);
-        lcd.drawFastHLine(0, y, screenWidth, lcd.color565(0, 0, blue * 8));
+    if (y >= headerHeight) return COLOR_BG;
+    uint8_t blue = 31 - (y * 31 / headerHeight);
+    return lcd.color565(0, 0, blue * 8);
+}
+
+// Hintergrund für Header-Felder (Verlauf statt Einfarbig)
+void headerFieldBackground(LGFX_Sprite& dst, int x, int y, int w, int h) {
+    for (int row = 0; row < h; row++) {
+        dst.drawFastHLine(0, row, w, headerGradientColor(y + row));
     }
+}
 
+// Layout aller Retained-Felder (nach Erkennung der Display-Grösse aufrufen)
+void setupRetainedFields() {
+    // Header: Uhrzeit/Datum mittig, Status links/rechts
+    const lgfx::IFont* timeFont = is480p ? &fonts::FreeSansBold18pt7b : &fonts::FreeSansBold12pt7b;
+    int headerHeight = is480p ? 50 : 35;
+    int timeY = is480p ? 10 : 7;
+    int sideW = 75;
+
+    RetainedTextLayer::setup(headerFields[HDR_TIME], screenWidth / 2, timeY, top_center,
+                             sideW, timeY, screenWidth - 2 * sideW, headerHeight - timeY,
+                             timeFont, COLOR_BG, headerFieldBackground);
+    RetainedTextLayer::setup(headerFields[HDR_BRIDGE], 5, 0, top_left,
+                             0, 0, sideW, 18, &fonts::Font2, COLOR_BG, headerFieldBackground);
+    RetainedTextLayer::setup(headerFields[HDR_SD], 5, 20, top_left,
+                             0, 20, sideW, 16, &fonts::Font2, COLOR_BG, headerFieldBackground);
+    RetainedTextLayer::setup(headerFields[HDR_WIFI], screenWidth - 5, 0, top_right,
+                             screenWidth - sideW, 0, sideW, 18, &fonts::Font2, COLOR_BG, headerFieldBackground);
+    RetainedTextLayer::setup(headerFields[HDR_IP], screenWidth - 5, 20, top_right,
+                             screenWidth - sideW, 20, sideW, 16, &fonts::Font2, COLOR_BG, headerFieldBackground);
+
+    // Sensor-Spalten: gleiche Zeilen wie im Sprite-Layout
+    int boxY = is480p ? 70 : 55;
+    int boxW = screenWidth / 2 - 10;
+    int boxH = screenHeight - boxY - 5;
+    int titleHeight = 42;
+    int spriteY = boxY + titleHeight;
+    int spriteW = boxW - 4;
+    int spriteH = boxH - titleHeight - 2;
+    int lineHeight = is480p ? 35 : 28;
+
+    int rowY[SENSOR_FIELD_COUNT];
+    rowY[FIELD_TEMP]  = 17;
+    rowY[FIELD_HUM]   = rowY[FIELD_TEMP] + lineHeight;
+    rowY[FIELD_PRESS] = rowY[FIELD_HUM] + lineHeight - 5;
+    rowY[FIELD_BATT]  = rowY[FIELD_PRESS] + lineHeight;
+    rowY[FIELD_RSSI]  = rowY[FIELD_BATT] + lineHeight - 12;
+    rowY[FIELD_AGE]   = rowY[FIELD_RSSI] + lineHeight - 12;
+
+    const lgfx::IFont* rowFont[SENSOR_FIELD_COUNT] = {
+        is480p ? &fonts::FreeSansBold24pt7b : &fonts::FreeSansBold18pt7b,
+        is480p ? &fonts::FreeSansBold12pt7b : &fonts::FreeSans9pt7b,
+        is480p ? &fonts::FreeSansBold12pt7b : &fonts::FreeSans9pt7b,
+        &fonts::Font2, &fonts::Font2, &fonts::Font2
+    };
+
+    int columnX[2] = {5 + 2, screenWidth / 2 + 5 + 2};
+    RetainedField* columns[2] = {indoorFields, outdoorFields};
+
+    for (int c = 0; c < 2; c++) {
+        for (int i = 0; i < SENSOR_FIELD_COUNT; i++) {
+            // Feldgrenzen jeweils auf halbem Weg zur Nachbarzeile (keine Überlappung)
+            int top = (i == 0) ? 0 : (rowY[i - 1] + rowY[i]) / 2;
+            int bottom = (i == SENSOR_FIELD_COUNT - 1) ? spriteH : (rowY[i] + rowY[i + 1]) / 2;
+            RetainedTextLayer::setup(columns[c][i], columnX[c] + spriteW / 2, spriteY + rowY[i], middle_center,
+                                     columnX[c], spriteY + top, spriteW, bottom - top,
+                                     rowFont[i], COLOR_BG);
+        }
+    }
+}
+
+// Header-Inhalte aktualisieren (nur geänderte Felder werden gezeichnet)
+void updateHeaderFields() {
     // Monatsnamen für deutsches Datum
     const char* monate[] = {"Jan.", "Feb.", "Mrz.", "Apr.", "Mai", "Jun.",
                             "Jul.", "Aug.", "Sep.", "Okt.", "Nov.", "Dez."};
 
     // Zeit & Datum auf einer Zeile, zentriert
+    char timeDateStr[32] = "";
     if (wifiConnected && timeConfigured) {
         struct tm timeinfo;
-        if (getLocalTime(&timeinfo)) {
-            lcd.setFont(is480p ? &fonts::FreeSansBold18pt7b : &fonts::FreeSansBold12pt7b);
-            lcd.setTextColor(COLOR_TEXT);
-            lcd.setTextDatum(top_center);
-
+        if (getLocalTime(&timeinfo, 0)) {
             char timeStr[6];
             strftime(timeStr, sizeof(timeStr), "%H:%M", &timeinfo);
-
-            char timeDateStr[32];
             snprintf(timeDateStr, sizeof(timeDateStr), "%s  %d. %s", timeStr, timeinfo.tm_mday, monate[timeinfo.tm_mon]);
-
-            lcd.drawString(timeDateStr, screenWidth / 2, is480p ? 10 : 7);
         }
     }
+    retained.draw(headerFields[HDR_TIME], timeDateStr, COLOR_TEXT);
 
     // I2C Bridge Status (links oben)
-    lcd.setFont(&fonts::Font2);
-    lcd.setTextDatum(top_left);
     if (systemStatus.esp_now_packets > 0) {
-        lcd.setTextColor(COLOR_RSSI_GOOD);
-        lcd.drawString("Bridge OK", 5, 0);
+        retained.draw(headerFields[HDR_BRIDGE], "Bridge OK", COLOR_RSSI_GOOD);
     } else {
-        lcd.setTextColor(COLOR_RSSI_MEDIUM);
-        lcd.drawString("Waiting...", 5, 0);
+        retained.draw(headerFields[HDR_BRIDGE], "Waiting...", COLOR_RSSI_MEDIUM);
     }
 
     // SD-Karten Status (links unten, im blauen Bereich)
-    if (sdCardAvailable) {
-        lcd.setTextColor(COLOR_RSSI_GOOD);
-        lcd.drawString("SD", 5, 20);
-    }
+    retained.draw(headerFields[HDR_SD], sdCardAvailable ? "SD" : "", COLOR_RSSI_GOOD);
 
     // WiFi Status (rechts oben)
-    lcd.setTextDatum(top_right);
     if (wifiConnected) {
-        lcd.setTextColor(COLOR_RSSI_GOOD);
-        lcd.drawString("WiFi", screenWidth - 5, 0);
+        retained.draw(headerFields[HDR_WIFI], "WiFi", COLOR_RSSI_GOOD);
     } else {
-        lcd.setTextColor(COLOR_RSSI_POOR);
-        lcd.drawString("No WiFi", screenWidth - 5, 0);
+        retained.draw(headerFields[HDR_WIFI], "No WiFi", COLOR_RSSI_POOR);
     }
 
     // IP letztes Byte anzeigen (rechts unten, im blauen Bereich)
+    char ipStr[4] = "";
     if (wifiConnected) {
         IPAddress ip = WiFi.localIP();
-        lcd.setTextColor(COLOR_RSSI_GOOD);
-        lcd.drawString(String(ip[3]), screenWidth - 5, 20);  // Letztes Byte der IP
+        snprintf(ipStr, sizeof(ipStr), "%d", ip[3]);  // Letztes Byte der IP
     }
+    retained.draw(headerFields[HDR_IP], ipStr, COLOR_RSSI_GOOD);
+}
+
+// Header komplett zeichnen (Verlauf + alle Felder)
+void drawHeader() {
+    // Gradient Header
+    int headerHeight = is480p ? 50 : 35;
+    for (int y = 0; y < headerHeight; y++) {
+        lcd.drawFastHLine(0, y, screenWidth, headerGradientColor(y));
+    }
+    retained.countBytes((uint32_t)screenWidth * headerHeight * 2);
+
+    for (int i = 0; i < HEADER_FIELD_COUNT; i++) {
+        RetainedTextLayer::invalidate(headerFields[i]);
+    }
+    updateHeaderFields();
 }
 
 void drawSensorBox(int x, int y, int w, int h, const char* title, uint16_t color) {
@@ -322,225 +517,283 @@ void drawSensorBox(int x, int y, int w, int h, const char* title, uint16_t color
     lcd.drawString(title, x + w / 2, y + 8);
 }
 
-void drawIndoorSection() {
-    int boxX = 5;
+// Messwert-Felder einer Sensor-Spalte aktualisieren (Indoor: humidity >= 0)
+void updateSensorFields(RetainedField* fields, FreshnessState freshness, float temperature, float humidity,
+                        float pressure, uint16_t battery_mv, bool battery_warning, int8_t rssi,
+                        unsigned long secondsAgo) {
+    char text[RETAINED_TEXT_LEN];
+    bool dataValid = (freshness == FRESHNESS_FRESH || freshness == FRESHNESS_LATE);
+
+    // Temperatur, Luftfeuchtigkeit, Luftdruck (nur wenn Daten gültig)
+    text[0] = '\0';
+    if (dataValid) snprintf(text, sizeof(text), "%.1f C", temperature);
+    retained.draw(fields[FIELD_TEMP], text, COLOR_TEMP);
+
+    if (humidity >= 0) {
+        text[0] = '\0';
+        if (dataValid) snprintf(text, sizeof(text), "%.0f%%", humidity);
+        retained.draw(fields[FIELD_HUM], text, COLOR_HUM);
+    } else {
+        retained.draw(fields[FIELD_HUM], "(no humidity)", COLOR_TEXT_DIM);
+    }
+
+    text[0] = '\0';
+    if (dataValid) snprintf(text, sizeof(text), "%.0f mbar", pressure);
+    retained.draw(fields[FIELD_PRESS], text, COLOR_PRESS);
+
+    // Batterie, RSSI und Alter (immer anzeigen)
+    snprintf(text, sizeof(text), battery_warning ? "%u mV  LOW!" : "%u mV", battery_mv);
+    retained.draw(fields[FIELD_BATT], text, battery_warning ? COLOR_BATTERY_LOW : COLOR_BATTERY_OK);
+
+    snprintf(text, sizeof(text), "RSSI: %d dBm", rssi);
+    retained.draw(fields[FIELD_RSSI], text, getRSSIColor(rssi));
+
+    // Alter: grau = pünktlich, orange = überfällig, rot = verloren
+    uint16_t ageColor = COLOR_TEXT_DIM;
+    if (freshness == FRESHNESS_LATE) ageColor = COLOR_RSSI_MEDIUM;
+    else if (freshness == FRESHNESS_LOST) ageColor = COLOR_BATTERY_LOW;
+    retained.draw(fields[FIELD_AGE], formatTime(secondsAgo).c_str(), ageColor);
+}
+
+// "Waiting for sensor data" in einer Sensor-Spalte anzeigen
+void drawWaitingSprite(LGFX_Sprite& sprite, int x, int y) {
+    int spriteW = sprite.width();
+    int spriteH = sprite.height();
+
+    sprite.fillSprite(COLOR_BG);
+    sprite.setFont(&fonts::FreeSans9pt7b);
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setTextDatum(middle_center);
+    sprite.drawString("Waiting for", spriteW / 2, spriteH / 2 - 15);
+    sprite.drawString("sensor data", spriteW / 2, spriteH / 2 + 10);
+    sprite.pushSprite(x, y);
+    retained.countBytes((uint32_t)spriteW * spriteH * 2);
+}
+
+// Sensor-Spalte komplett zeichnen (Rahmen, Hintergrund, alle Felder)
+void drawSensorColumn(bool left, const char* title, uint16_t color, bool received,
+                      LGFX_Sprite& sprite, RetainedField* fields, bool& fieldsActive) {
+    int boxX = left ? 5 : screenWidth / 2 + 5;
     int boxY = is480p ? 70 : 55;
     int boxW = screenWidth / 2 - 10;
     int boxH = screenHeight - boxY - 5;
 
-    drawSensorBox(boxX, boxY, boxW, boxH, "INDOOR", COLOR_INDOOR);
+    drawSensorBox(boxX, boxY, boxW, boxH, title, color);
 
     int titleHeight = 42;
     int spriteY = boxY + titleHeight;
-    int spriteW = boxW - 4;
-    int spriteH = boxH - titleHeight - 2;
 
-    indoorSprite.fillSprite(COLOR_BG);
-
-    if (!indoorReceived) {
+    if (!received) {
         // Noch nie Daten empfangen
-        indoorSprite.setFont(&fonts::FreeSans9pt7b);
-        indoorSprite.setTextColor(COLOR_TEXT_DIM);
-        indoorSprite.setTextDatum(middle_center);
-        indoorSprite.drawString("Waiting for", spriteW / 2, spriteH / 2 - 15);
-        indoorSprite.drawString("sensor data", spriteW / 2, spriteH / 2 + 10);
-        indoorSprite.pushSprite(boxX + 2, spriteY);
+        drawWaitingSprite(sprite, boxX + 2, spriteY);
+        fieldsActive = false;
         return;
     }
 
-    int contentY = 17;
-    int lineHeight = is480p ? 35 : 28;
-    int centerX = spriteW / 2;
-
-    // Timeout-Berechnung: Master entscheidet selbst über Gültigkeit
-    unsigned long secondsAgo = systemStatus.indoor_last_seen / 1000;
-    bool dataValid = (systemStatus.indoor_last_seen > 0) &&
-                     (secondsAgo <= (2.1 * indoorData.sleep_time_sec));
+    lcd.fillRect(boxX + 2, spriteY, sprite.width(), sprite.height(), COLOR_BG);
+    retained.countBytes((uint32_t)sprite.width() * sprite.height() * 2);
 
-    // Temperatur (nur wenn Daten gültig)
-    indoorSprite.setFont(is480p ? &fonts::FreeSansBold24pt7b : &fonts::FreeSansBold18pt7b);
-    indoorSprite.setTextColor(COLOR_TEMP);
-    indoorSprite.setTextDatum(middle_center);
-    if (dataValid) {
-        char tempStr[16];
-        snprintf(tempStr, sizeof(tempStr), "%.1f C", indoorData.temperature);
-        indoorSprite.drawString(tempStr, centerX, contentY);
+    for (int i = 0; i < SENSOR_FIELD_COUNT; i++) {
+        RetainedTextLayer::invalidate(fields[i]);
     }
-    contentY += lineHeight;
+    fieldsActive = true;
+}
 
-    // Luftfeuchtigkeit (nur wenn Daten gültig)
-    indoorSprite.setFont(is480p ? &fonts::FreeSansBold12pt7b : &fonts::FreeSans9pt7b);
-    indoorSprite.setTextColor(COLOR_HUM);
-    if (dataValid) {
-        indoorSprite.drawString(String(indoorData.humidity, 0) + "%", centerX, contentY);
+void updateIndoorFields() {
+    if (!indoorFieldsActive) {
+        drawIndoorSection();
+        return;
     }
-    contentY += lineHeight - 5;
 
-    // Luftdruck (nur wenn Daten gültig)
-    indoorSprite.setTextColor(COLOR_PRESS);
-    if (dataValid) {
-        indoorSprite.drawString(String(indoorData.pressure, 0) + " mbar", centerX, contentY);
-    }
-    contentY += lineHeight;
+    // Gültigkeit: Master entscheidet selbst anhand der gelernten Paketabstände
+    unsigned long secondsAgo = systemStatus.indoor_last_seen / 1000;
+    FreshnessState freshness = indoorFreshness.state(millis());
 
-    // Batterie (immer anzeigen)
-    indoorSprite.setFont(&fonts::Font2);
-    uint16_t battColor = indoorData.battery_warning ? COLOR_BATTERY_LOW : COLOR_BATTERY_OK;
-    indoorSprite.setTextColor(battColor);
-    indoorSprite.drawString(String(indoorData.battery_mv) + " mV", centerX, contentY);
-    if (indoorData.battery_warning) {
-        indoorSprite.setTextColor(COLOR_BATTERY_LOW);
-        indoorSprite.drawString("LOW!", centerX, contentY + 18);
+    updateSensorFields(indoorFields, freshness, indoorData.temperature, indoorData.humidity,
+                       indoorData.pressure, indoorData.battery_mv, indoorData.battery_warning,
+                       indoorData.rssi, secondsAgo);
+}
+
+void updateOutdoorFields() {
+    if (!outdoorFieldsActive) {
+        drawOutdoorSection();
+        return;
     }
-    contentY += lineHeight - 12;
 
-    // RSSI (immer anzeigen)
-    indoorSprite.setTextColor(getRSSIColor(indoorData.rssi));
-    indoorSprite.drawString("RSSI: " + String(indoorData.rssi) + " dBm", centerX, contentY);
-    contentY += lineHeight - 12;
+    // Gültigkeit: Master entscheidet selbst anhand der gelernten Paketabstände
+    unsigned long secondsAgo = systemStatus.outdoor_last_seen / 1000;
+    FreshnessState freshness = outdoorFreshness.state(millis());
 
-    // Zeit seit letztem Update (immer anzeigen)
-    indoorSprite.setTextColor(COLOR_TEXT_DIM);
-    indoorSprite.drawString(formatTime(secondsAgo), centerX, contentY);
+    // Keine Luftfeuchtigkeit beim Outdoor-Sensor (-1)
+    updateSensorFields(outdoorFields, freshness, outdoorData.temperature, -1,
+                       outdoorData.pressure, outdoorData.battery_mv, outdoorData.battery_warning,
+                       outdoorData.rssi, secondsAgo);
+}
 
-    indoorSprite.pushSprite(boxX + 2, spriteY);
+void drawIndoorSection() {
+    drawSensorColumn(true, "INDOOR", COLOR_INDOOR, indoorReceived,
+                     indoorSprite, indoorFields, indoorFieldsActive);
+    if (indoorFieldsActive) updateIndoorFields();
 }
 
 void drawOutdoorSection() {
-    int boxX = screenWidth / 2 + 5;
-    int boxY = is480p ? 70 : 55;
-    int boxW = screenWidth / 2 - 10;
-    int boxH = screenHeight - boxY - 5;
+    drawSensorColumn(false, "OUTDOOR", COLOR_OUTDOOR, outdoorReceived,
+                     outdoorSprite, outdoorFields, outdoorFieldsActive);
+    if (outdoorFieldsActive) updateOutdoorFields();
+}
 
-    drawSensorBox(boxX, boxY, boxW, boxH, "OUTDOOR", COLOR_OUTDOOR);
+// ==================== MIN/MAX FUNKTIONEN ====================
 
-    int titleHeight = 42;
-    int spriteY = boxY + titleHeight;
-    int spriteW = boxW - 4;
-    int spriteH = boxH - titleHeight - 2;
+/**
+ * Zeitbasis für das 24h-Fenster
+ * Epoch-Sekunden sobald NTP läuft, vorher Uptime (wird beim Sync umgerechnet).
+ * 0 = Snapshot mit Epoch-Zeiten geladen, aber noch keine gültige Uhrzeit.
+ */
+uint32_t minMaxNow() {
+    time_t epoch = time(nullptr);
+    uint32_t epochNow = (timeConfigured && epoch > 1600000000) ? (uint32_t)epoch : 0;
+    return minMax24.now(epochNow, millis() / 1000);
+}
 
-    outdoorSprite.fillSprite(COLOR_BG);
+void updateIndoorMinMax() {
+    if (!indoorReceived) return;
 
-    if (!outdoorReceived) {
-        // Noch nie Daten empfangen
-        outdoorSprite.setFont(&fonts::FreeSans9pt7b);
-        outdoorSprite.setTextColor(COLOR_TEXT_DIM);
-        outdoorSprite.setTextDatum(middle_center);
-        outdoorSprite.drawString("Waiting for", spriteW / 2, spriteH / 2 - 15);
-        outdoorSprite.drawString("sensor data", spriteW / 2, spriteH / 2 + 10);
-        outdoorSprite.pushSprite(boxX + 2, spriteY);
-        return;
-    }
+    uint32_t t = minMaxNow();
+    if (t == 0) return;
 
-    int contentY = 17;
-    int lineHeight = is480p ? 35 : 28;
-    int centerX = spriteW / 2;
+    minMax24[MM_INDOOR_TEMP].update(t, indoorData.temperature);
+    minMax24[MM_INDOOR_HUM].update(t, indoorData.humidity);
+    minMax24[MM_INDOOR_PRESS].update(t, indoorData.pressure);
+    minMax24[MM_INDOOR_BATT].update(t, indoorData.battery_mv);
+}
 
-    // Timeout-Berechnung: Master entscheidet selbst über Gültigkeit
-    unsigned long secondsAgo = systemStatus.outdoor_last_seen / 1000;
-    bool dataValid = (systemStatus.outdoor_last_seen > 0) &&
-                     (secondsAgo <= (2.1 * outdoorData.sleep_time_sec));
+void updateOutdoorMinMax() {
+    if (!outdoorReceived) return;
 
-    // Temperatur (nur wenn Daten gültig)
-    outdoorSprite.setFont(is480p ? &fonts::FreeSansBold24pt7b : &fonts::FreeSansBold18pt7b);
-    outdoorSprite.setTextColor(COLOR_TEMP);
-    outdoorSprite.setTextDatum(middle_center);
-    if (dataValid) {
-        char tempStr[16];
-        snprintf(tempStr, sizeof(tempStr), "%.1f C", outdoorData.temperature);
-        outdoorSprite.drawString(tempStr, centerX, contentY);
-    }
-    contentY += lineHeight;
+    uint32_t t = minMaxNow();
+    if (t == 0) return;
 
-    // Keine Luftfeuchtigkeit
-    outdoorSprite.setFont(is480p ? &fonts::FreeSansBold12pt7b : &fonts::FreeSans9pt7b);
-    outdoorSprite.setTextColor(COLOR_TEXT_DIM);
-    outdoorSprite.drawString("(no humidity)", centerX, contentY);
-    contentY += lineHeight - 5;
+    minMax24[MM_OUTDOOR_TEMP].update(t, outdoorData.temperature);
+    minMax24[MM_OUTDOOR_PRESS].update(t, outdoorData.pressure);
+    minMax24[MM_OUTDOOR_BATT].update(t, outdoorData.battery_mv);
+}
 
-    // Luftdruck (nur wenn Daten gültig)
-    outdoorSprite.setTextColor(COLOR_PRESS);
-    if (dataValid) {
-        outdoorSprite.drawString(String(outdoorData.pressure, 0) + " mbar", centerX, contentY);
-    }
-    contentY += lineHeight;
+/**
+ * 24h-Zustand auf SD sichern (erst .tmp schreiben, dann umbenennen)
+ */
+void saveMinMaxSnapshot() {
+    if (!sdCardAvailable || !minMax24.isEpochBased()) return;
 
-    // Batterie (immer anzeigen)
-    outdoorSprite.setFont(&fonts::Font2);
-    uint16_t battColor = outdoorData.battery_warning ? COLOR_BATTERY_LOW : COLOR_BATTERY_OK;
-    outdoorSprite.setTextColor(battColor);
-    outdoorSprite.drawString(String(outdoorData.battery_mv) + " mV", centerX, contentY);
-    if (outdoorData.battery_warning) {
-        outdoorSprite.setTextColor(COLOR_BATTERY_LOW);
-        outdoorSprite.drawString("LOW!", centerX, contentY + 18);
+    File file = SD.open(MINMAX_SNAPSHOT_TMP, FILE_WRITE);
+    if (!file) {
+        Serial.println("[MinMax] Failed to open snapshot file!");
+        return;
     }
-    contentY += lineHeight - 12;
-
-    // RSSI (immer anzeigen)
-    outdoorSprite.setTextColor(getRSSIColor(outdoorData.rssi));
-    outdoorSprite.drawString("RSSI: " + String(outdoorData.rssi) + " dBm", centerX, contentY);
-    contentY += lineHeight - 12;
 
-    // Zeit seit letztem Update (immer anzeigen)
-    outdoorSprite.setTextColor(COLOR_TEXT_DIM);
-    outdoorSprite.drawString(formatTime(secondsAgo), centerX, contentY);
+    bool ok = minMax24.save(file, minMaxNow());
+    file.close();
 
-    outdoorSprite.pushSprite(boxX + 2, spriteY);
+    if (ok) {
+        SD.remove(MINMAX_SNAPSHOT_FILE);
+        SD.rename(MINMAX_SNAPSHOT_TMP, MINMAX_SNAPSHOT_FILE);
+    }
 }
 
-// ==================== MIN/MAX FUNKTIONEN ====================
+void loadMinMaxSnapshot() {
+    File file = SD.open(MINMAX_SNAPSHOT_FILE, FILE_READ);
+    if (!file) {
+        Serial.println("[MinMax] No snapshot found - starting empty");
+        return;
+    }
 
-void initMinMax(MinMaxData &minmax) {
-    minmax.tempMin = 999.0;
-    minmax.tempMax = -999.0;
-    minmax.humMin = 999.0;
-    minmax.humMax = -999.0;
-    minmax.pressMin = 9999.0;
-    minmax.pressMax = 0.0;
-    minmax.batteryMin = 65535;
-    minmax.batteryMax = 0;
-    minmax.lastReset = millis();
+    if (minMax24.load(file)) {
+        Serial.println("[MinMax] 24h window restored from snapshot");
+    } else {
+        Serial.println("[MinMax] Snapshot invalid - starting empty");
+    }
+    file.close();
 }
 
-void updateIndoorMinMax() {
-    if (!indoorReceived) return;
+// ==================== DIAGNOSE DISPLAY ====================
 
-    // Prüfen ob 24h vergangen sind
-    if (millis() - indoorMinMax.lastReset > 86400000UL) {  // 24h in ms
-        initMinMax(indoorMinMax);
-    }
+/**
+ * Link-Qualität aller Sensoren (Struct 0x05 der Bridge)
+ * Pro Zeile: Sensor, RSSI Mittel und p10..p90, gleitender Verlust,
+ * Jitter gegen die angekündigte Periode, Wiederholungen, letzter Empfang
+ */
+void drawLinkDiagnostics() {
+    int boxX = 5;
+    int boxY = is480p ? 70 : 55;
+    int boxW = screenWidth - 10;
+    int boxH = screenHeight - boxY - 5;
 
-    // Min/Max aktualisieren
-    if (indoorData.temperature < indoorMinMax.tempMin) indoorMinMax.tempMin = indoorData.temperature;
-    if (indoorData.temperature > indoorMinMax.tempMax) indoorMinMax.tempMax = indoorData.temperature;
+    drawSensorBox(boxX, boxY, boxW, boxH, "LINK QUALITY", COLOR_TEXT);
 
-    if (indoorData.humidity < indoorMinMax.humMin) indoorMinMax.humMin = indoorData.humidity;
-    if (indoorData.humidity > indoorMinMax.humMax) indoorMinMax.humMax = indoorData.humidity;
+    lcd.setFont(&fonts::Font2);
+    lcd.setTextDatum(top_left);
 
-    if (indoorData.pressure < indoorMinMax.pressMin) indoorMinMax.pressMin = indoorData.pressure;
-    if (indoorData.pressure > indoorMinMax.pressMax) indoorMinMax.pressMax = indoorData.pressure;
+    if (!linkStatsReceived || linkStats.count == 0) {
+        lcd.setTextColor(COLOR_TEXT_DIM);
+        lcd.setTextDatum(middle_center);
+        lcd.drawString("No link data yet", screenWidth / 2, boxY + boxH / 2);
+        return;
+    }
 
-    if (indoorData.battery_mv < indoorMinMax.batteryMin) indoorMinMax.batteryMin = indoorData.battery_mv;
-    if (indoorData.battery_mv > indoorMinMax.batteryMax) indoorMinMax.batteryMax = indoorData.battery_mv;
-}
+    // Spalten relativ zur Breite (320 und 480 px)
+    const int colX[] = { 0, 18, 42, 62, 76, 88 };   // Prozent von boxW
+    const char* titles[] = { "Sensor", "RSSI avg p10..p90", "Loss", "Jitter", "Retry", "Seen" };
+    int lineHeight = is480p ? 26 : 20;
+    int y = boxY + 38;
 
-void updateOutdoorMinMax() {
-    if (!outdoorReceived) return;
+    lcd.setTextColor(COLOR_TEXT_DIM);
+    for (int c = 0; c < 6; c++) {
+        lcd.drawString(titles[c], boxX + 6 + boxW * colX[c] / 100, y);
+    }
+    y += lineHeight;
+
+    for (uint8_t i = 0; i < linkStats.count && y + lineHeight <= boxY + boxH; i++) {
+        const LinkStatsEntry& e = linkStats.entries[i];
+        char text[24];
+        int x0 = boxX + 6;
+
+        lcd.setTextColor(e.schema == 2 ? COLOR_INDOOR : COLOR_OUTDOOR);
+        snprintf(text, sizeof(text), "%s%d %02X%02X",
+                 e.schema == 2 ? "In" : "Out", e.ordinal + 1, e.mac[1], e.mac[2]);
+        lcd.drawString(text, x0 + boxW * colX[0] / 100, y);
+
+        // Farbe nach den schwächsten 10%: dort gehen Pakete zuerst verloren
+        lcd.setTextColor(getRSSIColor(e.rssi_p10));
+        snprintf(text, sizeof(text), "%d %d..%d", e.rssi_avg, e.rssi_p10, e.rssi_p90);
+        lcd.drawString(text, x0 + boxW * colX[1] / 100, y);
+
+        lcd.setTextColor(e.loss_recent_pm >= 100 ? COLOR_BATTERY_LOW : COLOR_TEXT);
+        snprintf(text, sizeof(text), "%.1f%%", e.loss_recent_pm / 10.0f);
+        lcd.drawString(text, x0 + boxW * colX[2] / 100, y);
+
+        lcd.setTextColor(COLOR_TEXT);
+        if (e.jitter_ms >= 10000) {
+            snprintf(text, sizeof(text), "%us", e.jitter_ms / 1000);
+        } else {
+            snprintf(text, sizeof(text), "%ums", e.jitter_ms);
+        }
+        lcd.drawString(text, x0 + boxW * colX[3] / 100, y);
 
-    // Prüfen ob 24h vergangen sind
-    if (millis() - outdoorMinMax.lastReset > 86400000UL) {  // 24h in ms
-        initMinMax(outdoorMinMax);
-    }
+        snprintf(text, sizeof(text), "%u", e.retries);
+        lcd.drawString(text, x0 + boxW * colX[4] / 100, y);
 
-    // Min/Max aktualisieren
-    if (outdoorData.temperature < outdoorMinMax.tempMin) outdoorMinMax.tempMin = outdoorData.temperature;
-    if (outdoorData.temperature > outdoorMinMax.tempMax) outdoorMinMax.tempMax = outdoorData.temperature;
+        lcd.setTextColor(COLOR_TEXT_DIM);
+        lcd.drawString(formatTime(e.last_seen_sec).c_str(), x0 + boxW * colX[5] / 100, y);
 
-    if (outdoorData.pressure < outdoorMinMax.pressMin) outdoorMinMax.pressMin = outdoorData.pressure;
-    if (outdoorData.pressure > outdoorMinMax.pressMax) outdoorMinMax.pressMax = outdoorData.pressure;
+        y += lineHeight;
+    }
 
-    if (outdoorData.battery_mv < outdoorMinMax.batteryMin) outdoorMinMax.batteryMin = outdoorData.battery_mv;
-    if (outdoorData.battery_mv > outdoorMinMax.batteryMax) outdoorMinMax.batteryMax = outdoorData.battery_mv;
+    if (linkStats.total > linkStats.count) {
+        char more[32];
+        snprintf(more, sizeof(more), "+%u more (see bridge serial)", linkStats.total - linkStats.count);
+        lcd.setTextColor(COLOR_TEXT_DIM);
+        lcd.drawString(more, boxX + 6, y);
+    }
+    retained.countBytes((uint32_t)boxW * (y - boxY) * 2);
 }
 
 // ==================== MIN/MAX DISPLAY FUNKTIONEN ====================
@@ -560,7 +813,11 @@ void drawIndoorMinMaxSection() {
 
     indoorSprite.fillSprite(COLOR_BG);
 
-    if (!indoorReceived || indoorMinMax.tempMin > 900) {
+    uint32_t now = minMaxNow();
+    float tempMin, tempMax, pressMin, pressMax, battMin, battMax;
+    bool hasTemp = (now != 0) && minMax24[MM_INDOOR_TEMP].get(now, tempMin, tempMax);
+
+    if (!hasTemp) {
         indoorSprite.setFont(&fonts::FreeSans9pt7b);
         indoorSprite.setTextColor(COLOR_TEXT_DIM);
         indoorSprite.setTextDatum(middle_center);
@@ -577,21 +834,23 @@ void drawIndoorMinMaxSection() {
     indoorSprite.setTextColor(COLOR_TEMP);
     indoorSprite.setTextDatum(middle_center);
     char tempStr[32];
-    snprintf(tempStr, sizeof(tempStr), "Temp: %.1f/%.1f C", indoorMinMax.tempMin, indoorMinMax.tempMax);
+    snprintf(tempStr, sizeof(tempStr), "Temp: %.1f/%.1f C", tempMin, tempMax);
     indoorSprite.drawString(tempStr, spriteW / 2, contentY);
     contentY += lineHeight;
 
     // Luftdruck Min/Max
     indoorSprite.setTextColor(COLOR_PRESS);
     char pressStr[32];
-    snprintf(pressStr, sizeof(pressStr), "Press: %.0f/%.0f", indoorMinMax.pressMin, indoorMinMax.pressMax);
+    minMax24[MM_INDOOR_PRESS].get(now, pressMin, pressMax);
+    snprintf(pressStr, sizeof(pressStr), "Press: %.0f/%.0f", pressMin, pressMax);
     indoorSprite.drawString(pressStr, spriteW / 2, contentY);
     contentY += lineHeight;
 
     // Batterie Min/Max
     indoorSprite.setTextColor(COLOR_BATTERY_OK);
     char battStr[32];
-    snprintf(battStr, sizeof(battStr), "Batt: %d/%d mV", indoorMinMax.batteryMin, indoorMinMax.batteryMax);
+    minMax24[MM_INDOOR_BATT].get(now, battMin, battMax);
+    snprintf(battStr, sizeof(battStr), "Batt: %d/%d mV", (int)battMin, (int)battMax);
     indoorSprite.drawString(battStr, spriteW / 2, contentY);
     contentY += lineHeight + 5;
 
@@ -617,7 +876,11 @@ void drawOutdoorMinMaxSection() {
 
     outdoorSprite.fillSprite(COLOR_BG);
 
-    if (!outdoorReceived || outdoorMinMax.tempMin > 900) {
+    uint32_t now = minMaxNow();
+    float tempMin, tempMax, pressMin, pressMax, battMin, battMax;
+    bool hasTemp = (now != 0) && minMax24[MM_OUTDOOR_TEMP].get(now, tempMin, tempMax);
+
+    if (!hasTemp) {
         outdoorSprite.setFont(&fonts::FreeSans9pt7b);
         outdoorSprite.setTextColor(COLOR_TEXT_DIM);
         outdoorSprite.setTextDatum(middle_center);
@@ -634,21 +897,23 @@ void drawOutdoorMinMaxSection() {
     outdoorSprite.setTextColor(COLOR_TEMP);
     outdoorSprite.setTextDatum(middle_center);
     char tempStr[32];
-    snprintf(tempStr, sizeof(tempStr), "Temp: %.1f/%.1f C", outdoorMinMax.tempMin, outdoorMinMax.tempMax);
+    snprintf(tempStr, sizeof(tempStr), "Temp: %.1f/%.1f C", tempMin, tempMax);
     outdoorSprite.drawString(tempStr, spriteW / 2, contentY);
     contentY += lineHeight;
 
     // Luftdruck Min/Max
     outdoorSprite.setTextColor(COLOR_PRESS);
     char pressStr[32];
-    snprintf(pressStr, sizeof(pressStr), "Press: %.0f/%.0f", outdoorMinMax.pressMin, outdoorMinMax.pressMax);
+    minMax24[MM_OUTDOOR_PRESS].get(now, pressMin, pressMax);
+    snprintf(pressStr, sizeof(pressStr), "Press: %.0f/%.0f", pressMin, pressMax);
     outdoorSprite.drawString(pressStr, spriteW / 2, contentY);
     contentY += lineHeight;
 
     // Batterie Min/Max
     outdoorSprite.setTextColor(COLOR_BATTERY_OK);
     char battStr[32];
-    snprintf(battStr, sizeof(battStr), "Batt: %d/%d mV", outdoorMinMax.batteryMin, outdoorMinMax.batteryMax);
+    minMax24[MM_OUTDOOR_BATT].get(now, battMin, battMax);
+    snprintf(battStr, sizeof(battStr), "Batt: %d/%d mV", (int)battMin, (int)battMax);
     outdoorSprite.drawString(battStr, spriteW / 2, contentY);
     contentY += lineHeight + 5;
 
@@ -661,6 +926,73 @@ void drawOutdoorMinMaxSection() {
 
 // ==================== GRAPH FUNKTIONEN ====================
 
+// CSV-Leser über SD-Dateien (fester 512 Byte Block, keine String-Allokationen)
+typedef CsvReader<File> SdCsvReader;
+
+/**
+ * CSV so öffnen, dass die letzten maxRows Datensätze als nächstes folgen
+ * Der Sidecar-Index liefert Zeilenzahl und Offset - kein Zählen der ganzen Datei.
+ * @param offset Dateioffset der Leseposition (für SdCsvReader)
+ * @param skipRows Datensätze, die ab offset noch zu überspringen sind
+ * @return Anzahl zu lesender Datensätze (0 = Datei fehlt oder leer, file geschlossen)
+ */
+int openCsvTail(const String& filename, int maxRows, File& file, uint32_t& offset, uint32_t& skipRows) {
+    CsvIndexState st;
+    if (!CsvIndex::sync(SD, filename.c_str(), st) || st.rows == 0) return 0;
+
+    file = SD.open(filename, FILE_READ);
+    if (!file) return 0;
+
+    uint32_t startRow = (st.rows > (uint32_t)maxRows) ? st.rows - maxRows : 0;
+    CsvIndexEntry entry;
+
+    if (CsvIndex::findRow(SD, filename.c_str(), startRow, entry) && entry.row <= startRow &&
+        file.seek(entry.offset)) {
+        offset = entry.offset;
+        skipRows = startRow - entry.row;
+    } else {
+        // Ohne Index von vorne lesen (Header + Zeilen davor überspringen)
+        file.seek(0);
+        offset = 0;
+        skipRows = startRow + 1;
+    }
+
+    Serial.printf("[Graph] %s: %lu rows, reading from row %lu\n",
+                  filename.c_str(), (unsigned long)st.rows, (unsigned long)startRow);
+    return st.rows - startRow;
+}
+
+// Stunde aus "YYYY-MM-DD HH:MM:SS" (-1 wenn ungültig)
+int csvHour(const CsvField& f) {
+    if (f.len < 13) return -1;
+    return (f.ptr[11] - '0') * 10 + (f.ptr[12] - '0');
+}
+
+/**
+ * Outdoor-Zeile: DateTime,Temperature_C,Pressure_mbar,Battery_mV,...
+ */
+bool parseOutdoorRecord(const SdCsvReader& csv, float& temp, float& press, uint16_t& battery, int& hour) {
+    int32_t batt;
+    if (csv.count() < 5) return false;
+    if (!csvParseFloat(csv.field(1), temp) || !csvParseFloat(csv.field(2), press) ||
+        !csvParseInt(csv.field(3), batt)) {
+        return false;
+    }
+    battery = (uint16_t)batt;
+    hour = csvHour(csv.field(0));
+    return true;
+}
+
+/**
+ * Indoor-Zeile: DateTime,Temperature_C,Humidity_%,Pressure_mbar,Battery_mV,...
+ */
+bool parseIndoorBattery(const SdCsvReader& csv, uint16_t& battery) {
+    int32_t batt;
+    if (csv.count() < 6 || !csvParseInt(csv.field(4), batt)) return false;
+    battery = (uint16_t)batt;
+    return true;
+}
+
 void loadOutdoorGraphDataFromCSV() {
     if (!sdCardAvailable) {
         Serial.println("[Graph] SD card not available");
@@ -675,26 +1007,14 @@ void loadOutdoorGraphDataFromCSV() {
         return;
     }
 
-    // Kleinere Allokation: Max 500 Zeilen statt 3000 (spart 80% RAM)
-    // 500 Zeilen = ~2 Tage, genug für die meisten Fälle
-    const int MAX_BUFFER = 500;
+    const int MAX_BUFFER = GRAPH_LOAD_BUFFER;
 
-    // Allokiere Speicher mit NULL-Checks
-    float* tempData = (float*)malloc(MAX_BUFFER * sizeof(float));
-    float* pressData = (float*)malloc(MAX_BUFFER * sizeof(float));
-    uint16_t* batteryData = (uint16_t*)malloc(MAX_BUFFER * sizeof(uint16_t));
-    bool* midnightData = (bool*)malloc(MAX_BUFFER * sizeof(bool));
-
-    if (!tempData || !pressData || !batteryData || !midnightData) {
-        Serial.println("[Graph] Memory allocation failed!");
-        if (tempData) free(tempData);
-        if (pressData) free(pressData);
-        if (batteryData) free(batteryData);
-        if (midnightData) free(midnightData);
-        graphData.outdoorLoaded = false;
-        graphData.dataCount = 0;
-        return;
-    }
+    // Puffer aus der Scratch-Arena (wird am Funktionsende zurückgesetzt)
+    ArenaScope<GRAPH_ARENA_SIZE> arenaScope(graphArena);
+    float* tempData = graphArena.alloc<float>(MAX_BUFFER);
+    float* pressData = graphArena.alloc<float>(MAX_BUFFER);
+    uint16_t* batteryData = graphArena.alloc<uint16_t>(MAX_BUFFER);
+    bool* midnightData = graphArena.alloc<bool>(MAX_BUFFER);
 
     int totalLines = 0;
     int lastHour = -1;
@@ -703,59 +1023,24 @@ void loadOutdoorGraphDataFromCSV() {
     String filename = "/" + dateStr + "_outdoor.csv";
     int currentMonthLines = 0;
 
-    if (SD.exists(filename)) {
-        // Pass 1: Zeilen zählen
-        File file = SD.open(filename, FILE_READ);
-        if (file) {
-            file.readStringUntil('\n');  // Header überspringen
-            int totalFileLines = 0;
-
-            while (file.available()) {
-                String line = file.readStringUntil('\n');
-                if (line.length() > 10) {  // Nur gültige Zeilen zählen
-                    totalFileLines++;
-                }
-            }
-            file.close();
-
-            // Pass 2: Die letzten MAX_BUFFER Zeilen lesen
-            int skipLines = (totalFileLines > MAX_BUFFER) ? (totalFileLines - MAX_BUFFER) : 0;
-            Serial.printf("[Graph] File has %d lines, skipping first %d\n", totalFileLines, skipLines);
-
-            file = SD.open(filename, FILE_READ);
-            if (file) {
-                file.readStringUntil('\n');  // Header überspringen
-
-                // Skip erste N Zeilen
-                for (int i = 0; i < skipLines; i++) {
-                    file.readStringUntil('\n');
-                }
-
-                // Jetzt die letzten MAX_BUFFER Zeilen lesen
-                while (file.available() && currentMonthLines < MAX_BUFFER) {
-                    String line = file.readStringUntil('\n');
-                    int idx1 = line.indexOf(',');
-                    int idx2 = line.indexOf(',', idx1 + 1);
-                    int idx3 = line.indexOf(',', idx2 + 1);
-                    int idx4 = line.indexOf(',', idx3 + 1);
-
-                    if (idx1 > 0 && idx2 > 0 && idx3 > 0 && idx4 > 0) {
-                        String dateTime = line.substring(0, idx1);
-                        int hourIdx = dateTime.indexOf(' ') + 1;
-                        int hour = dateTime.substring(hourIdx, hourIdx + 2).toInt();
-
-                        tempData[currentMonthLines] = line.substring(idx1 + 1, idx2).toFloat();
-                        pressData[currentMonthLines] = line.substring(idx2 + 1, idx3).toFloat();
-                        batteryData[currentMonthLines] = line.substring(idx3 + 1, idx4).toInt();
-                        midnightData[currentMonthLines] = (hour == 0 && lastHour != 0);
-                        lastHour = hour;
-                        currentMonthLines++;
-                    }
-                }
-                file.close();
-                Serial.printf("[Graph] Current month (%s): %d lines loaded\n", filename.c_str(), currentMonthLines);
+    // Nur die letzten MAX_BUFFER Zeilen lesen (Seek über Index)
+    File file;
+    uint32_t offset, skipRows;
+    if (openCsvTail(filename, MAX_BUFFER, file, offset, skipRows) > 0) {
+        SdCsvReader csv(file, offset);
+        csv.skip(skipRows);
+
+        while (currentMonthLines < MAX_BUFFER && csv.next()) {
+            int hour;
+            if (parseOutdoorRecord(csv, tempData[currentMonthLines], pressData[currentMonthLines],
+                                   batteryData[currentMonthLines], hour)) {
+                midnightData[currentMonthLines] = (hour == 0 && lastHour != 0);
+                lastHour = hour;
+                currentMonthLines++;
             }
         }
+        file.close();
+        Serial.printf("[Graph] Current month (%s): %d lines loaded\n", filename.c_str(), currentMonthLines);
     }
 
     totalLines = currentMonthLines;
@@ -770,109 +1055,64 @@ void loadOutdoorGraphDataFromCSV() {
             int needed = GRAPH_DATA_POINTS - currentMonthLines;
             int prevBufferSize = (needed < MAX_BUFFER) ? needed : MAX_BUFFER;
 
-            float* prevTemp = (float*)malloc(prevBufferSize * sizeof(float));
-            float* prevPress = (float*)malloc(prevBufferSize * sizeof(float));
-            uint16_t* prevBatt = (uint16_t*)malloc(prevBufferSize * sizeof(uint16_t));
-            bool* prevMidnight = (bool*)malloc(prevBufferSize * sizeof(bool));
-
-            if (!prevTemp || !prevPress || !prevBatt || !prevMidnight) {
-                Serial.println("[Graph] Prev month allocation failed - using current month only");
-                if (prevTemp) free(prevTemp);
-                if (prevPress) free(prevPress);
-                if (prevBatt) free(prevBatt);
-                if (prevMidnight) free(prevMidnight);
-            } else {
-                int prevLines = 0;
-                int prevLastHour = -1;
-
-                // Pass 1: Zeilen zählen
-                File file = SD.open(prevFilename, FILE_READ);
-                if (file) {
-                    file.readStringUntil('\n');  // Header überspringen
-                    int totalPrevLines = 0;
-
-                    while (file.available()) {
-                        String line = file.readStringUntil('\n');
-                        if (line.length() > 10) {
-                            totalPrevLines++;
-                        }
-                    }
-                    file.close();
-
-                    // Pass 2: Die letzten prevBufferSize Zeilen lesen
-                    int skipPrevLines = (totalPrevLines > prevBufferSize) ? (totalPrevLines - prevBufferSize) : 0;
-                    Serial.printf("[Graph] Prev file has %d lines, skipping first %d\n", totalPrevLines, skipPrevLines);
-
-                    file = SD.open(prevFilename, FILE_READ);
-                    if (file) {
-                        file.readStringUntil('\n');  // Header überspringen
-
-                        // Skip erste N Zeilen
-                        for (int i = 0; i < skipPrevLines; i++) {
-                            file.readStringUntil('\n');
-                        }
-
-                        // Jetzt die letzten prevBufferSize Zeilen lesen
-                        while (file.available() && prevLines < prevBufferSize) {
-                            String line = file.readStringUntil('\n');
-                            int idx1 = line.indexOf(',');
-                            int idx2 = line.indexOf(',', idx1 + 1);
-                            int idx3 = line.indexOf(',', idx2 + 1);
-                            int idx4 = line.indexOf(',', idx3 + 1);
-
-                            if (idx1 > 0 && idx2 > 0 && idx3 > 0 && idx4 > 0) {
-                                String dateTime = line.substring(0, idx1);
-                                int hourIdx = dateTime.indexOf(' ') + 1;
-                                int hour = dateTime.substring(hourIdx, hourIdx + 2).toInt();
-
-                                prevTemp[prevLines] = line.substring(idx1 + 1, idx2).toFloat();
-                                prevPress[prevLines] = line.substring(idx2 + 1, idx3).toFloat();
-                                prevBatt[prevLines] = line.substring(idx3 + 1, idx4).toInt();
-                                prevMidnight[prevLines] = (hour == 0 && prevLastHour != 0);
-                                prevLastHour = hour;
-                                prevLines++;
-                            }
-                        }
-                        file.close();
+            float* prevTemp = graphArena.alloc<float>(prevBufferSize);
+            float* prevPress = graphArena.alloc<float>(prevBufferSize);
+            uint16_t* prevBatt = graphArena.alloc<uint16_t>(prevBufferSize);
+            bool* prevMidnight = graphArena.alloc<bool>(prevBufferSize);
+
+            int prevLines = 0;
+            int prevLastHour = -1;
+
+            // Nur die letzten prevBufferSize Zeilen lesen (Seek über Index)
+            File prevFile;
+            uint32_t prevOffset, prevSkipRows;
+            if (openCsvTail(prevFilename, prevBufferSize, prevFile, prevOffset, prevSkipRows) > 0) {
+                SdCsvReader csv(prevFile, prevOffset);
+                csv.skip(prevSkipRows);
+
+                while (prevLines < prevBufferSize && csv.next()) {
+                    int hour;
+                    if (parseOutdoorRecord(csv, prevTemp[prevLines], prevPress[prevLines],
+                                           prevBatt[prevLines], hour)) {
+                        prevMidnight[prevLines] = (hour == 0 && prevLastHour != 0);
+                        prevLastHour = hour;
+                        prevLines++;
                     }
                 }
+                prevFile.close();
+            }
 
-                // Alle gelesenen Zeilen verwenden (keine weiteren Berechnungen nötig)
-                int prevCount = prevLines;
-
-                // Prüfe ob genug Platz im Buffer
-                if (currentMonthLines + prevCount <= MAX_BUFFER) {
-                    // Aktuelle Daten nach hinten verschieben
-                    for (int i = currentMonthLines - 1; i >= 0; i--) {
-                        tempData[i + prevCount] = tempData[i];
-                        pressData[i + prevCount] = pressData[i];
-                        batteryData[i + prevCount] = batteryData[i];
-                        midnightData[i + prevCount] = midnightData[i];
-                    }
-
-                    // Vormonatsdaten an den Anfang kopieren (bereits die richtigen Zeilen gelesen)
-                    for (int i = 0; i < prevCount; i++) {
-                        tempData[i] = prevTemp[i];
-                        pressData[i] = prevPress[i];
-                        batteryData[i] = prevBatt[i];
-                        midnightData[i] = prevMidnight[i];
-                    }
+            // Alle gelesenen Zeilen verwenden (keine weiteren Berechnungen nötig)
+            int prevCount = prevLines;
+
+            // Prüfe ob genug Platz im Buffer
+            if (currentMonthLines + prevCount <= MAX_BUFFER) {
+                // Aktuelle Daten nach hinten verschieben
+                for (int i = currentMonthLines - 1; i >= 0; i--) {
+                    tempData[i + prevCount] = tempData[i];
+                    pressData[i + prevCount] = pressData[i];
+                    batteryData[i + prevCount] = batteryData[i];
+                    midnightData[i + prevCount] = midnightData[i];
+                }
 
-                    totalLines = prevCount + currentMonthLines;
-                    Serial.printf("[Graph] Added %d lines from previous month (%s)\n", prevCount, prevFilename.c_str());
-                } else {
-                    Serial.println("[Graph] Buffer overflow prevented - using current month only");
+                // Vormonatsdaten an den Anfang kopieren (bereits die richtigen Zeilen gelesen)
+                for (int i = 0; i < prevCount; i++) {
+                    tempData[i] = prevTemp[i];
+                    pressData[i] = prevPress[i];
+                    batteryData[i] = prevBatt[i];
+                    midnightData[i] = prevMidnight[i];
                 }
 
-                free(prevMidnight);
-                free(prevBatt);
-                free(prevPress);
-                free(prevTemp);
+                totalLines = prevCount + currentMonthLines;
+                Serial.printf("[Graph] Added %d lines from previous month (%s)\n", prevCount, prevFilename.c_str());
+            } else {
+                Serial.println("[Graph] Buffer overflow prevented - using current month only");
             }
         }
     }
 
-    // Die letzten 240 Werte ins graphData kopieren
+    // Die letzten 240 Werte ins graphData kopieren (UI-Task rendert evtl. gerade daraus)
+    DisplayLock lock;
     int startIdx = (totalLines > GRAPH_DATA_POINTS) ? (totalLines - GRAPH_DATA_POINTS) : 0;
     graphData.dataCount = totalLines - startIdx;
 
@@ -883,11 +1123,6 @@ void loadOutdoorGraphDataFromCSV() {
         graphData.midnightMarker[i] = midnightData[startIdx + i];
     }
 
-    free(midnightData);
-    free(batteryData);
-    free(pressData);
-    free(tempData);
-
     graphData.outdoorLoaded = true;
     Serial.printf("[Graph] Loaded %d outdoor data points (total)\n", graphData.dataCount);
 }
@@ -906,17 +1141,11 @@ void loadIndoorGraphDataFromCSV() {
         return;
     }
 
-    // Kleinere Allokation: Max 500 Zeilen statt 3000 (spart 80% RAM)
-    const int MAX_BUFFER = 500;
+    const int MAX_BUFFER = GRAPH_LOAD_BUFFER;
 
-    // Allokiere Speicher mit NULL-Check
-    uint16_t* batteryData = (uint16_t*)malloc(MAX_BUFFER * sizeof(uint16_t));
-
-    if (!batteryData) {
-        Serial.println("[Graph] Indoor memory allocation failed!");
-        graphData.indoorLoaded = false;
-        return;
-    }
+    // Puffer aus der Scratch-Arena (wird am Funktionsende zurückgesetzt)
+    ArenaScope<GRAPH_ARENA_SIZE> arenaScope(graphArena);
+    uint16_t* batteryData = graphArena.alloc<uint16_t>(MAX_BUFFER);
 
     int totalLines = 0;
 
@@ -924,52 +1153,20 @@ void loadIndoorGraphDataFromCSV() {
     String filename = "/" + dateStr + "_indoor.csv";
     int currentMonthLines = 0;
 
-    if (SD.exists(filename)) {
-        // Pass 1: Zeilen zählen
-        File file = SD.open(filename, FILE_READ);
-        if (file) {
-            file.readStringUntil('\n');  // Header überspringen
-            int totalFileLines = 0;
-
-            while (file.available()) {
-                String line = file.readStringUntil('\n');
-                if (line.length() > 10) {
-                    totalFileLines++;
-                }
-            }
-            file.close();
-
-            // Pass 2: Die letzten MAX_BUFFER Zeilen lesen
-            int skipLines = (totalFileLines > MAX_BUFFER) ? (totalFileLines - MAX_BUFFER) : 0;
-            Serial.printf("[Graph] Indoor file has %d lines, skipping first %d\n", totalFileLines, skipLines);
-
-            file = SD.open(filename, FILE_READ);
-            if (file) {
-                file.readStringUntil('\n');  // Header überspringen
+    // Nur die letzten MAX_BUFFER Zeilen lesen (Seek über Index)
+    File file;
+    uint32_t offset, skipRows;
+    if (openCsvTail(filename, MAX_BUFFER, file, offset, skipRows) > 0) {
+        SdCsvReader csv(file, offset);
+        csv.skip(skipRows);
 
-                // Skip erste N Zeilen
-                for (int i = 0; i < skipLines; i++) {
-                    file.readStringUntil('\n');
-                }
-
-                // Jetzt die letzten MAX_BUFFER Zeilen lesen
-                while (file.available() && currentMonthLines < MAX_BUFFER) {
-                    String line = file.readStringUntil('\n');
-                    int idx1 = line.indexOf(',');
-                    int idx2 = line.indexOf(',', idx1 + 1);
-                    int idx3 = line.indexOf(',', idx2 + 1);
-                    int idx4 = line.indexOf(',', idx3 + 1);
-                    int idx5 = line.indexOf(',', idx4 + 1);
-
-                    if (idx1 > 0 && idx5 > 0) {
-                        batteryData[currentMonthLines] = line.substring(idx4 + 1, idx5).toInt();
-                        currentMonthLines++;
-                    }
-                }
-                file.close();
-                Serial.printf("[Graph] Indoor current month: %d lines loaded\n", currentMonthLines);
+        while (currentMonthLines < MAX_BUFFER && csv.next()) {
+            if (parseIndoorBattery(csv, batteryData[currentMonthLines])) {
+                currentMonthLines++;
             }
         }
+        file.close();
+        Serial.printf("[Graph] Indoor current month: %d lines loaded\n", currentMonthLines);
     }
 
     totalLines = currentMonthLines;
@@ -984,85 +1181,50 @@ void loadIndoorGraphDataFromCSV() {
             int needed = GRAPH_DATA_POINTS - currentMonthLines;
             int prevBufferSize = (needed < MAX_BUFFER) ? needed : MAX_BUFFER;
 
-            uint16_t* prevBatt = (uint16_t*)malloc(prevBufferSize * sizeof(uint16_t));
+            uint16_t* prevBatt = graphArena.alloc<uint16_t>(prevBufferSize);
 
-            if (!prevBatt) {
-                Serial.println("[Graph] Indoor prev month allocation failed - using current month only");
-            } else {
-                int prevLines = 0;
-
-                // Pass 1: Zeilen zählen
-                File file = SD.open(prevFilename, FILE_READ);
-                if (file) {
-                    file.readStringUntil('\n');  // Header überspringen
-                    int totalPrevLines = 0;
-
-                    while (file.available()) {
-                        String line = file.readStringUntil('\n');
-                        if (line.length() > 10) {
-                            totalPrevLines++;
-                        }
-                    }
-                    file.close();
-
-                    // Pass 2: Die letzten prevBufferSize Zeilen lesen
-                    int skipPrevLines = (totalPrevLines > prevBufferSize) ? (totalPrevLines - prevBufferSize) : 0;
-                    Serial.printf("[Graph] Indoor prev file has %d lines, skipping first %d\n", totalPrevLines, skipPrevLines);
-
-                    file = SD.open(prevFilename, FILE_READ);
-                    if (file) {
-                        file.readStringUntil('\n');  // Header überspringen
-
-                        // Skip erste N Zeilen
-                        for (int i = 0; i < skipPrevLines; i++) {
-                            file.readStringUntil('\n');
-                        }
-
-                        // Jetzt die letzten prevBufferSize Zeilen lesen
-                        while (file.available() && prevLines < prevBufferSize) {
-                            String line = file.readStringUntil('\n');
-                            int idx1 = line.indexOf(',');
-                            int idx2 = line.indexOf(',', idx1 + 1);
-                            int idx3 = line.indexOf(',', idx2 + 1);
-                            int idx4 = line.indexOf(',', idx3 + 1);
-                            int idx5 = line.indexOf(',', idx4 + 1);
-
-                            if (idx1 > 0 && idx5 > 0) {
-                                prevBatt[prevLines] = line.substring(idx4 + 1, idx5).toInt();
-                                prevLines++;
-                            }
-                        }
-                        file.close();
-                    }
-                }
+            int prevLines = 0;
 
-                // Alle gelesenen Zeilen verwenden
-                int prevCount = prevLines;
+            // Nur die letzten prevBufferSize Zeilen lesen (Seek über Index)
+            File prevFile;
+            uint32_t prevOffset, prevSkipRows;
+            if (openCsvTail(prevFilename, prevBufferSize, prevFile, prevOffset, prevSkipRows) > 0) {
+                SdCsvReader csv(prevFile, prevOffset);
+                csv.skip(prevSkipRows);
 
-                // Prüfe ob genug Platz im Buffer
-                if (currentMonthLines + prevCount <= MAX_BUFFER) {
-                    // Aktuelle Daten nach hinten verschieben
-                    for (int i = currentMonthLines - 1; i >= 0; i--) {
-                        batteryData[i + prevCount] = batteryData[i];
+                while (prevLines < prevBufferSize && csv.next()) {
+                    if (parseIndoorBattery(csv, prevBatt[prevLines])) {
+                        prevLines++;
                     }
+                }
+                prevFile.close();
+            }
 
-                    // Vormonatsdaten an den Anfang kopieren (bereits die richtigen Zeilen gelesen)
-                    for (int i = 0; i < prevCount; i++) {
-                        batteryData[i] = prevBatt[i];
-                    }
+            // Alle gelesenen Zeilen verwenden
+            int prevCount = prevLines;
+
+            // Prüfe ob genug Platz im Buffer
+            if (currentMonthLines + prevCount <= MAX_BUFFER) {
+                // Aktuelle Daten nach hinten verschieben
+                for (int i = currentMonthLines - 1; i >= 0; i--) {
+                    batteryData[i + prevCount] = batteryData[i];
+                }
 
-                    totalLines = prevCount + currentMonthLines;
-                    Serial.printf("[Graph] Added %d lines from previous month (%s)\n", prevCount, prevFilename.c_str());
-                } else {
-                    Serial.println("[Graph] Indoor buffer overflow prevented - using current month only");
+                // Vormonatsdaten an den Anfang kopieren (bereits die richtigen Zeilen gelesen)
+                for (int i = 0; i < prevCount; i++) {
+                    batteryData[i] = prevBatt[i];
                 }
 
-                free(prevBatt);
+                totalLines = prevCount + currentMonthLines;
+                Serial.printf("[Graph] Added %d lines from previous month (%s)\n", prevCount, prevFilename.c_str());
+            } else {
+                Serial.println("[Graph] Indoor buffer overflow prevented - using current month only");
             }
         }
     }
 
-    // Die letzten 240 Werte ins graphData kopieren
+    // Die letzten 240 Werte ins graphData kopieren (UI-Task rendert evtl. gerade daraus)
+    DisplayLock lock;
     int startIdx = (totalLines > GRAPH_DATA_POINTS) ? (totalLines - GRAPH_DATA_POINTS) : 0;
     int count = totalLines - startIdx;
 
@@ -1071,29 +1233,29 @@ void loadIndoorGraphDataFromCSV() {
         graphData.indoorBatteryValues[i] = batteryData[startIdx + i];
     }
 
-    free(batteryData);
-
     graphData.indoorLoaded = true;
     Serial.printf("[Graph] Loaded %d indoor battery values (total)\n", count);
 }
 
-void drawOutdoorGraphSection() {
-    lcd.fillScreen(COLOR_BG);
+// Graph-Seiten zeichnen in ein beliebiges Ziel (Vollbild-Sprite oder Band)
+// yOff = LCD-Zeile, die im Ziel bei y=0 liegt - alle y-Koordinaten sind LCD-Koordinaten - yOff
+void renderOutdoorGraphPage(LovyanGFX& g, int yOff) {
+    g.fillScreen(COLOR_BG);
 
-    lcd.setFont(&fonts::FreeSansBold12pt7b);
-    lcd.setTextColor(COLOR_OUTDOOR);
-    lcd.setTextDatum(top_center);
-    lcd.drawString("OUTDOOR - Last 240 Values", screenWidth / 2, 5);
+    g.setFont(&fonts::FreeSansBold12pt7b);
+    g.setTextColor(COLOR_OUTDOOR);
+    g.setTextDatum(top_center);
+    g.drawString("OUTDOOR - Last 240 Values", screenWidth / 2, 5 - yOff);
 
     if (!graphData.outdoorLoaded || graphData.dataCount < 2) {
-        lcd.setFont(&fonts::FreeSans9pt7b);
-        lcd.setTextColor(COLOR_TEXT_DIM);
-        lcd.drawString("No data available", screenWidth / 2, screenHeight / 2);
+        g.setFont(&fonts::FreeSans9pt7b);
+        g.setTextColor(COLOR_TEXT_DIM);
+        g.drawString("No data available", screenWidth / 2, screenHeight / 2 - yOff);
         return;
     }
 
     int graphX = 40;
-    int graphY = 35;
+    int graphY = 35 - yOff;
     int graphW = screenWidth - 50;
     int graphH = (screenHeight - 45) / 2;
 
@@ -1110,31 +1272,31 @@ void drawOutdoorGraphSection() {
     tempMin -= tempRange * 0.1;
     tempMax += tempRange * 0.1;
 
-    lcd.drawRect(graphX, graphY, graphW, graphH, COLOR_TEMP);
+    g.drawRect(graphX, graphY, graphW, graphH, COLOR_TEMP);
 
-    lcd.setFont(&fonts::Font2);
-    lcd.setTextColor(COLOR_TEMP);
-    lcd.setTextDatum(middle_right);
-    lcd.drawString(String(tempMax, 1), graphX - 3, graphY + 5);
-    lcd.drawString(String(tempMin, 1), graphX - 3, graphY + graphH - 5);
-    lcd.drawString("C", graphX - 3, graphY + graphH / 2);
+    g.setFont(&fonts::Font2);
+    g.setTextColor(COLOR_TEMP);
+    g.setTextDatum(middle_right);
+    g.drawString(String(tempMax, 1), graphX - 3, graphY + 5);
+    g.drawString(String(tempMin, 1), graphX - 3, graphY + graphH - 5);
+    g.drawString("C", graphX - 3, graphY + graphH / 2);
 
     // Mitternachts-Markierungen
     for (int i = 0; i < graphData.dataCount; i++) {
         if (graphData.midnightMarker[i]) {
             int x = graphX + i * graphW / (graphData.dataCount - 1);
-            lcd.drawFastVLine(x, graphY + 1, graphH - 2, COLOR_TEXT_DIM);
+            g.drawFastVLine(x, graphY + 1, graphH - 2, COLOR_TEXT_DIM);
         }
     }
 
     // Kurve
-    lcd.setColor(COLOR_TEMP);
+    uint16_t curveColor = COLOR_TEMP;
     for (int i = 1; i < graphData.dataCount; i++) {
         int x1 = graphX + (i - 1) * graphW / (graphData.dataCount - 1);
         int x2 = graphX + i * graphW / (graphData.dataCount - 1);
         int y1 = graphY + graphH - (int)((graphData.outdoorTempValues[i - 1] - tempMin) / (tempMax - tempMin) * graphH);
         int y2 = graphY + graphH - (int)((graphData.outdoorTempValues[i] - tempMin) / (tempMax - tempMin) * graphH);
-        lcd.drawLine(x1, y1, x2, y2);
+        g.drawLine(x1, y1, x2, y2, curveColor);
     }
 
     // ==== LUFTDRUCK GRAPH ====
@@ -1152,55 +1314,55 @@ void drawOutdoorGraphSection() {
     pressMin -= pressRange * 0.1;
     pressMax += pressRange * 0.1;
 
-    lcd.drawRect(graphX, pressGraphY, graphW, graphH, COLOR_PRESS);
+    g.drawRect(graphX, pressGraphY, graphW, graphH, COLOR_PRESS);
 
-    lcd.setTextColor(COLOR_PRESS);
-    lcd.setTextDatum(middle_right);
-    lcd.drawString(String((int)pressMax), graphX - 3, pressGraphY + 5);
-    lcd.drawString(String((int)pressMin), graphX - 3, pressGraphY + graphH - 5);
-    lcd.drawString("mbar", graphX - 3, pressGraphY + graphH / 2);
+    g.setTextColor(COLOR_PRESS);
+    g.setTextDatum(middle_right);
+    g.drawString(String((int)pressMax), graphX - 3, pressGraphY + 5);
+    g.drawString(String((int)pressMin), graphX - 3, pressGraphY + graphH - 5);
+    g.drawString("mbar", graphX - 3, pressGraphY + graphH / 2);
 
     // Mitternachts-Markierungen
     for (int i = 0; i < graphData.dataCount; i++) {
         if (graphData.midnightMarker[i]) {
             int x = graphX + i * graphW / (graphData.dataCount - 1);
-            lcd.drawFastVLine(x, pressGraphY + 1, graphH - 2, COLOR_TEXT_DIM);
+            g.drawFastVLine(x, pressGraphY + 1, graphH - 2, COLOR_TEXT_DIM);
         }
     }
 
     // Kurve
-    lcd.setColor(COLOR_PRESS);
+    curveColor = COLOR_PRESS;
     for (int i = 1; i < graphData.dataCount; i++) {
         int x1 = graphX + (i - 1) * graphW / (graphData.dataCount - 1);
         int x2 = graphX + i * graphW / (graphData.dataCount - 1);
         int y1 = pressGraphY + graphH - (int)((graphData.outdoorPressValues[i - 1] - pressMin) / (pressMax - pressMin) * graphH);
         int y2 = pressGraphY + graphH - (int)((graphData.outdoorPressValues[i] - pressMin) / (pressMax - pressMin) * graphH);
-        lcd.drawLine(x1, y1, x2, y2);
+        g.drawLine(x1, y1, x2, y2, curveColor);
     }
 
-    lcd.setFont(&fonts::Font2);
-    lcd.setTextColor(COLOR_TEXT_DIM);
-    lcd.setTextDatum(bottom_center);
-    lcd.drawString(String(graphData.dataCount) + " values from CSV", screenWidth / 2, screenHeight - 2);
+    g.setFont(&fonts::Font2);
+    g.setTextColor(COLOR_TEXT_DIM);
+    g.setTextDatum(bottom_center);
+    g.drawString(String(graphData.dataCount) + " values from CSV", screenWidth / 2, screenHeight - 2 - yOff);
 }
 
-void drawBatteryGraphSection() {
-    lcd.fillScreen(COLOR_BG);
+void renderBatteryGraphPage(LovyanGFX& g, int yOff) {
+    g.fillScreen(COLOR_BG);
 
-    lcd.setFont(&fonts::FreeSansBold12pt7b);
-    lcd.setTextColor(COLOR_BATTERY_OK);
-    lcd.setTextDatum(top_center);
-    lcd.drawString("BATTERY - Last 240 Values", screenWidth / 2, 5);
+    g.setFont(&fonts::FreeSansBold12pt7b);
+    g.setTextColor(COLOR_BATTERY_OK);
+    g.setTextDatum(top_center);
+    g.drawString("BATTERY - Last 240 Values", screenWidth / 2, 5 - yOff);
 
     if ((!graphData.outdoorLoaded && !graphData.indoorLoaded) || graphData.dataCount < 2) {
-        lcd.setFont(&fonts::FreeSans9pt7b);
-        lcd.setTextColor(COLOR_TEXT_DIM);
-        lcd.drawString("No data available", screenWidth / 2, screenHeight / 2);
+        g.setFont(&fonts::FreeSans9pt7b);
+        g.setTextColor(COLOR_TEXT_DIM);
+        g.drawString("No data available", screenWidth / 2, screenHeight / 2 - yOff);
         return;
     }
 
     int graphX = 40;
-    int graphY = 40;
+    int graphY = 40 - yOff;
     int graphW = screenWidth - 50;
     int graphH = screenHeight - 60;
 
@@ -1229,121 +1391,271 @@ void drawBatteryGraphSection() {
     battMax += battRange * 0.1;
 
     // Rahmen
-    lcd.drawRect(graphX, graphY, graphW, graphH, COLOR_BATTERY_OK);
+    g.drawRect(graphX, graphY, graphW, graphH, COLOR_BATTERY_OK);
 
     // Y-Achsen Beschriftung
-    lcd.setFont(&fonts::Font2);
-    lcd.setTextColor(COLOR_BATTERY_OK);
-    lcd.setTextDatum(middle_right);
-    lcd.drawString(String(battMax), graphX - 3, graphY + 5);
-    lcd.drawString(String(battMin), graphX - 3, graphY + graphH - 5);
-    lcd.drawString("mV", graphX - 3, graphY + graphH / 2);
+    g.setFont(&fonts::Font2);
+    g.setTextColor(COLOR_BATTERY_OK);
+    g.setTextDatum(middle_right);
+    g.drawString(String(battMax), graphX - 3, graphY + 5);
+    g.drawString(String(battMin), graphX - 3, graphY + graphH - 5);
+    g.drawString("mV", graphX - 3, graphY + graphH / 2);
 
     // Mitternachts-Markierungen
     for (int i = 0; i < graphData.dataCount; i++) {
         if (graphData.midnightMarker[i]) {
             int x = graphX + i * graphW / (graphData.dataCount - 1);
-            lcd.drawFastVLine(x, graphY + 1, graphH - 2, COLOR_TEXT_DIM);
+            g.drawFastVLine(x, graphY + 1, graphH - 2, COLOR_TEXT_DIM);
         }
     }
 
     // Outdoor Kurve (Orange)
     if (graphData.outdoorLoaded) {
-        lcd.setColor(COLOR_OUTDOOR);
+        uint16_t curveColor = COLOR_OUTDOOR;
         for (int i = 1; i < graphData.dataCount; i++) {
             int x1 = graphX + (i - 1) * graphW / (graphData.dataCount - 1);
             int x2 = graphX + i * graphW / (graphData.dataCount - 1);
             int y1 = graphY + graphH - (int)((graphData.outdoorBatteryValues[i - 1] - battMin) / (float)(battMax - battMin) * graphH);
             int y2 = graphY + graphH - (int)((graphData.outdoorBatteryValues[i] - battMin) / (float)(battMax - battMin) * graphH);
-            lcd.drawLine(x1, y1, x2, y2);
+            g.drawLine(x1, y1, x2, y2, curveColor);
         }
     }
 
     // Indoor Kurve (Cyan)
     if (graphData.indoorLoaded) {
-        lcd.setColor(COLOR_INDOOR);
+        uint16_t curveColor = COLOR_INDOOR;
         for (int i = 1; i < graphData.dataCount; i++) {
             int x1 = graphX + (i - 1) * graphW / (graphData.dataCount - 1);
             int x2 = graphX + i * graphW / (graphData.dataCount - 1);
             int y1 = graphY + graphH - (int)((graphData.indoorBatteryValues[i - 1] - battMin) / (float)(battMax - battMin) * graphH);
             int y2 = graphY + graphH - (int)((graphData.indoorBatteryValues[i] - battMin) / (float)(battMax - battMin) * graphH);
-            lcd.drawLine(x1, y1, x2, y2);
+            g.drawLine(x1, y1, x2, y2, curveColor);
         }
     }
 
     // Legende
-    lcd.setFont(&fonts::Font2);
-    lcd.setTextDatum(bottom_left);
-    lcd.setTextColor(COLOR_OUTDOOR);
-    lcd.drawString("Outdoor", graphX + 5, screenHeight - 2);
-    lcd.setTextColor(COLOR_INDOOR);
-    lcd.drawString("Indoor", graphX + 70, screenHeight - 2);
+    g.setFont(&fonts::Font2);
+    g.setTextDatum(bottom_left);
+    g.setTextColor(COLOR_OUTDOOR);
+    g.drawString("Outdoor", graphX + 5, screenHeight - 2 - yOff);
+    g.setTextColor(COLOR_INDOOR);
+    g.drawString("Indoor", graphX + 70, screenHeight - 2 - yOff);
+
+    g.setTextColor(COLOR_TEXT_DIM);
+    g.setTextDatum(bottom_right);
+    g.drawString(String(graphData.dataCount) + " values", screenWidth - 5, screenHeight - 2 - yOff);
+}
 
-    lcd.setTextColor(COLOR_TEXT_DIM);
-    lcd.setTextDatum(bottom_right);
-    lcd.drawString(String(graphData.dataCount) + " values", screenWidth - 5, screenHeight - 2);
+/**
+ * Graph-Daten aus CSV laden und beide Seiten neu rendern
+ * Läuft im Hintergrund nach dem SD-Log, damit der Seitenwechsel nur noch pusht.
+ */
+void refreshGraphPages() {
+    lastGraphRefresh = millis();
+
+    loadOutdoorGraphDataFromCSV();
+    loadIndoorGraphDataFromCSV();
+
+    {
+        DisplayLock lock;
+        graphPages.invalidateAll();
+        graphPages.render(GRAPH_PAGE_OUTDOOR, renderOutdoorGraphPage);
+        graphPages.render(GRAPH_PAGE_BATTERY, renderBatteryGraphPage);
+    }
+
+    // Ohne Zeit/SD bleibt dirty gesetzt, Retry nach GRAPH_REFRESH_RETRY
+    graphPagesDirty = !graphData.outdoorLoaded && !graphData.indoorLoaded;
+
+    Serial.printf("[Graph] Pages refreshed in %lu ms\n", millis() - lastGraphRefresh);
 }
 
 // ==================== TOUCH FUNKTIONEN ====================
 
-void checkTouch() {
-    int16_t touchX, touchY;
+// Zeitpunkt der letzten PENIRQ-Flanke (micros) für die Gestendauer
+volatile uint32_t touchIrqUs = 0;
 
-    // Touch prüfen - getTouch() gibt true zurück wenn Touch erkannt wurde
-    // Die Touch-Konfiguration kommt aus CYD_Display_Config.h
-    if (lcd.getTouch(&touchX, &touchY)) {
+// Erkennungszeitpunkt der Geste, deren Schirm gerade gezeichnet wird (nur unter DisplayLock)
+bool touchFeedbackPending = false;
+uint32_t touchFeedbackUs = 0;
 
-        // Debounce
-        if (millis() - lastTouchTime > TOUCH_DEBOUNCE) {
-            lastTouchTime = millis();
-            lastModeChange = millis();  // Reset Auto-Return Timer
+// PENIRQ geht bei Berührung auf LOW: Touch-Task wecken
+void IRAM_ATTR onTouchIrq() {
+    touchIrqUs = micros();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(touchTaskHandle, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
 
-            // Display-Modus umschalten (zyklisch: 0->1->2->3->0)
-            displayMode = (displayMode + 1) % 4;
+/**
+ * Touch-Task: schläft bis zum IRQ, tastet dann alle TOUCH_SAMPLE_MS ab,
+ * bis losgelassen wurde, und stellt erkannte Gesten in die Queue.
+ */
+void touchTask(void* param) {
+    TouchGestureDetector detector;
+    uint32_t downUs = 0;        // Erste Berührung der laufenden Geste
+
+    for (;;) {
+        bool woken = false;
+        if (TOUCH_IRQ_PIN >= 0 && !detector.isActive()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            woken = true;
+        }
 
-            const char* modeNames[] = {"Normal", "Outdoor Graph", "Battery Graph", "Min/Max"};
-            Serial.printf("[Touch] Mode switched to: %s (at X=%d, Y=%d)\n",
-                         modeNames[displayMode], touchX, touchY);
+        int16_t x = 0, y = 0;
+        bool touched;
+        {
+            // Die Touch-Konfiguration kommt aus CYD_Display_Config.h
+            DisplayLock lock;
+            touched = lcd.getTouch(&x, &y);
+        }
+
+        // Gestendauer ab der ersten Berührung (IRQ-Flanke, sonst erstes Sample);
+        // touch-to-pixel beginnt erst bei der Erkennung
+        if (touched && !detector.isActive()) {
+            downUs = woken ? touchIrqUs : micros();
+        }
 
-            // Graph-Daten bei jedem Wechsel neu laden (zeigt aktuelle Daten)
-            if (displayMode == 1) {
-                loadOutdoorGraphDataFromCSV();
-            } else if (displayMode == 2) {
-                // Beide Sensoren neu laden für aktuellste Daten
-                loadOutdoorGraphDataFromCSV();
-                loadIndoorGraphDataFromCSV();
+        TouchGestureType gesture = detector.update(touched, x, y, millis());
+        if (gesture != GESTURE_NONE) {
+            uint32_t nowUs = micros();
+            TouchEvent ev = { gesture, detector.getStartX(), detector.getStartY(), nowUs, nowUs - downUs };
+            if (xQueueSend(touchQueue, &ev, 0) != pdTRUE) {
+                touchEventsDropped.inc();
             }
+        }
 
-            // Display sofort aktualisieren
-            updateDisplay();
+        if (TOUCH_IRQ_PIN >= 0 && !detector.isActive()) {
+            ulTaskNotifyTake(pdTRUE, 0);  // IRQ-Flanken während der Abtastung verwerfen
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+        }
+    }
+}
+
+/**
+ * Geste in Moduswechsel umsetzen und sofort neu zeichnen
+ * Tap / Swipe links: nächster Schirm, Swipe rechts: vorheriger, Long-Press: Normal
+ */
+void handleGesture(const TouchEvent& ev) {
+    uint8_t mode = displayMode;
+
+    switch (ev.type) {
+        case GESTURE_TAP:
+        case GESTURE_SWIPE_LEFT:
+            mode = (mode + 1) % DISPLAY_MODE_COUNT;
+            break;
+        case GESTURE_SWIPE_RIGHT:
+            mode = (mode + DISPLAY_MODE_COUNT - 1) % DISPLAY_MODE_COUNT;
+            break;
+        case GESTURE_LONG_PRESS:
+            mode = 0;
+            break;
+        default:
+            return;
+    }
+
+    {
+        // Moduswechsel und Zeichnen unter einem Lock: loop() sieht den neuen Modus
+        // erst, wenn der neue Schirm steht
+        DisplayLock lock;
+        lastModeChange = millis();  // Reset Auto-Return Timer
+        displayMode = mode;
+        touchFeedbackUs = ev.timeUs;
+        touchFeedbackPending = true;
+        updateDisplay();
+    }
+    gestureDuration.observe(ev.durationUs);
+
+    const char* gestureNames[] = {"-", "Tap", "Swipe left", "Swipe right", "Long press"};
+    const char* modeNames[] = {"Normal", "Outdoor Graph", "Battery Graph", "Min/Max", "Diagnostics"};
+    Serial.printf("[Touch] %s at X=%d, Y=%d -> %s (held %lu us, drawn after %lu us)\n",
+                  gestureNames[ev.type], ev.x, ev.y, modeNames[mode],
+                  (unsigned long)ev.durationUs, (unsigned long)(micros() - ev.timeUs));
+}
+
+/**
+ * UI-Task: höhere Priorität als loop(), damit SD-Logging, Graph-Laden oder
+ * WiFi den Seitenwechsel nicht verzögern (die SD hängt an eigenem SPI-Bus)
+ */
+void uiTask(void* param) {
+    TouchEvent ev;
+    for (;;) {
+        if (xQueueReceive(touchQueue, &ev, portMAX_DELAY) == pdTRUE) {
+            handleGesture(ev);
         }
     }
 }
 
+void setupTouch() {
+    touchQueue = xQueueCreate(TOUCH_QUEUE_LENGTH, sizeof(TouchEvent));
+
+    // Gleicher Core wie loop(), höhere Priorität -> verdrängt loop() sofort
+    xTaskCreatePinnedToCore(uiTask, "ui", 6144, nullptr, 2, nullptr, ARDUINO_RUNNING_CORE);
+    xTaskCreatePinnedToCore(touchTask, "touch", 3072, nullptr, 3, &touchTaskHandle, ARDUINO_RUNNING_CORE);
+
+    if (TOUCH_IRQ_PIN >= 0) {
+        pinMode(TOUCH_IRQ_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(TOUCH_IRQ_PIN), onTouchIrq, FALLING);
+        Serial.printf("[Touch] IRQ on GPIO%d, gesture task started\n", TOUCH_IRQ_PIN);
+    } else {
+        Serial.println("[Touch] No IRQ pin - polling every 10 ms");
+    }
+}
+
+/**
+ * Touch-to-Pixel erfassen, sobald nach einer Geste das erste Bild gepusht ist
+ * (Löschen des Schirms bzw. vorgerenderte Graph-Seite). Aufruf unter DisplayLock.
+ */
+void observeTouchFeedback() {
+    if (touchFeedbackPending) {
+        touchFeedbackPending = false;
+        touchLatency.observe(micros() - touchFeedbackUs);
+    }
+}
+
 void updateDisplay() {
+    DisplayLock lock;
+    ScopedLatency frameTimer(frameLatency);
+    retained.beginFrame();
+
+    // Vollbild löschen (alle Modi ausser den Graphen zeichnen danach neu)
+    if (displayMode == 0 || displayMode == 3 || displayMode == 4) {
+        lcd.fillScreen(COLOR_BG);
+        retained.countBytes((uint32_t)screenWidth * screenHeight * 2);
+        observeTouchFeedback();
+    }
+
     if (displayMode == 0) {
         // Normal - mit Header
-        lcd.fillScreen(COLOR_BG);
         drawHeader();
         if (indoorReceived) drawIndoorSection();
         if (outdoorReceived) drawOutdoorSection();
     } else if (displayMode == 1) {
-        // Outdoor Graph - ohne Header (vollbild)
-        drawOutdoorGraphSection();
+        // Outdoor Graph - ohne Header (vollbild, vorgerendert)
+        retained.countBytes(graphPages.show(GRAPH_PAGE_OUTDOOR, renderOutdoorGraphPage));
+        observeTouchFeedback();
     } else if (displayMode == 2) {
-        // Battery Graph - ohne Header (vollbild)
-        drawBatteryGraphSection();
+        // Battery Graph - ohne Header (vollbild, vorgerendert)
+        retained.countBytes(graphPages.show(GRAPH_PAGE_BATTERY, renderBatteryGraphPage));
+        observeTouchFeedback();
     } else if (displayMode == 3) {
         // Min/Max - mit Header
-        lcd.fillScreen(COLOR_BG);
         drawHeader();
         drawIndoorMinMaxSection();
         drawOutdoorMinMaxSection();
+    } else if (displayMode == 4) {
+        // Link-Diagnose - mit Header
+        drawHeader();
+        drawLinkDiagnostics();
     }
+
+    retained.endFrame();
 }
 
 void checkAutoReturn() {
     // Nach 30 Sekunden automatisch zurück zu Schirm 1 (nur wenn nicht schon dort)
+    // Lock, damit eine gleichzeitige Geste im UI-Task nicht überschrieben wird
+    DisplayLock lock;
     if (displayMode != 0 && (millis() - lastModeChange > AUTO_RETURN_TIME)) {
         Serial.println("[Auto-Return] Returning to normal view after 30 seconds");
         displayMode = 0;
@@ -1352,17 +1664,74 @@ void checkAutoReturn() {
     }
 }
 
+/**
+ * Weck-Timer auf den nächsten fresh/late/lost-Wechsel stellen
+ * Nach jedem Empfang und jedem Redraw neu aufziehen.
+ */
+void armFreshnessTimer(unsigned long now) {
+    freshnessTimerStart = now;
+    freshnessTimerMs = freshnessSooner(indoorFreshness.nextChange(now),
+                                       outdoorFreshness.nextChange(now));
+}
+
+// Normal-Schirm beim nächsten loop() aktualisieren (neue Daten, WiFi-/SD-Status)
+void requestRedraw() {
+    redrawRequested = true;
+}
+
+// Millisekunden bis die Uhr im Header die Minute wechselt
+unsigned long clockNextChange() {
+    if (!timeConfigured) return FRESHNESS_NEVER;
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < 1000000000L) return 1000;   // NTP noch nicht synchronisiert
+
+    unsigned long intoMinute = (tv.tv_sec % 60) * 1000UL + tv.tv_usec / 1000;
+    return 60000UL - intoMinute + 20;           // Kleiner Vorlauf, damit die neue Minute gilt
+}
+
+/**
+ * Redraw-Timer auf den nächsten Termin stellen: Minutenwechsel der Uhr
+ * oder fresh/late/lost-Wechsel eines Sensors. Nach jedem Redraw neu aufziehen.
+ */
+void armRedrawTimer(unsigned long now) {
+    redrawTimerStart = now;
+    redrawTimerMs = freshnessSooner(clockNextChange(),
+                                    freshnessSooner(indoorFreshness.nextChange(now),
+                                                    outdoorFreshness.nextChange(now)));
+}
+
 // ==================== I2C FUNKTIONEN ====================
 
+// Struct von der Bridge lesen und Dauer/Fehler für /metrics erfassen
+template<typename T>
+bool readBridgeStruct(uint8_t structId, T& buffer) {
+    ScopedLatency t(i2cLatency);
+    bool ok = i2cBridge.readStruct(BRIDGE_ADDRESS_1, structId, buffer);
+    if (!ok) i2cErrors.inc();
+    return ok;
+}
+
 void pollI2CData() {
     // Bridge 1 abfragen
-    if (!i2cBridge.ping(BRIDGE_ADDRESS_1)) {
+    bool bridgeOk;
+    {
+        ScopedLatency t(i2cLatency);
+        bridgeOk = i2cBridge.ping(BRIDGE_ADDRESS_1);
+    }
+    if (!bridgeOk) {
+        i2cErrors.inc();
         Serial.println("[I2C] Bridge not responding!");
         return;
     }
     
     // Neue Daten prüfen
-    uint8_t newDataMask = i2cBridge.checkNewData(BRIDGE_ADDRESS_1);
+    uint8_t newDataMask;
+    {
+        ScopedLatency t(i2cLatency);
+        newDataMask = i2cBridge.checkNewData(BRIDGE_ADDRESS_1);
+    }
     
     if (newDataMask == 0) {
         return; // Keine neuen Daten
@@ -1372,9 +1741,12 @@ void pollI2CData() {
     
     // Indoor Daten (ID 0x01)
     if (newDataMask & 0x02) {  // Bit 1 für ID 0x01
-        if (i2cBridge.readStruct(BRIDGE_ADDRESS_1, 0x01, indoorData)) {
+        if (readBridgeStruct(0x01, indoorData)) {
             indoorReceived = true;
             lastIndoorUpdate = millis();
+            indoorFreshness.arrival(lastIndoorUpdate, indoorData.sleep_time_sec);
+            armFreshnessTimer(lastIndoorUpdate);
+            requestRedraw();
 
             // Min/Max aktualisieren
             updateIndoorMinMax();
@@ -1386,9 +1758,12 @@ void pollI2CData() {
 
     // Outdoor Daten (ID 0x02)
     if (newDataMask & 0x04) {  // Bit 2 für ID 0x02
-        if (i2cBridge.readStruct(BRIDGE_ADDRESS_1, 0x02, outdoorData)) {
+        if (readBridgeStruct(0x02, outdoorData)) {
             outdoorReceived = true;
             lastOutdoorUpdate = millis();
+            outdoorFreshness.arrival(lastOutdoorUpdate, outdoorData.sleep_time_sec);
+            armFreshnessTimer(lastOutdoorUpdate);
+            requestRedraw();
 
             // Min/Max aktualisieren
             updateOutdoorMinMax();
@@ -1398,9 +1773,18 @@ void pollI2CData() {
         }
     }
     
+    // Link-Statistik (ID 0x05)
+    if (newDataMask & 0x20) {  // Bit 5 für ID 0x05
+        if (readBridgeStruct(0x05, linkStats)) {
+            linkStatsReceived = true;
+            if (displayMode == 4) updateDisplay();
+        }
+    }
+
     // System Status (ID 0x03)
     if (newDataMask & 0x08) {  // Bit 3 für ID 0x03
-        if (i2cBridge.readStruct(BRIDGE_ADDRESS_1, 0x03, systemStatus)) {
+        if (readBridgeStruct(0x03, systemStatus)) {
+            requestRedraw();  // Alter der Sensoren und Bridge-Status
             Serial.printf("[Status] Indoor: %lu ms ago, Outdoor: %lu ms ago, Packets: %d\n",
                          systemStatus.indoor_last_seen,
                          systemStatus.outdoor_last_seen,
@@ -1409,6 +1793,36 @@ void pollI2CData() {
     }
 }
 
+/**
+ * NTP-Zeit an die Bridge schreiben (Struct 0x04)
+ * Die Bridge gibt sie als Zeit-Beacon an die Sensoren weiter.
+ */
+void pushTimeToBridge() {
+    if (!timeConfigured) return;
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < 1600000000) return;  // NTP noch nicht synchronisiert
+
+    struct tm local;
+    localtime_r(&tv.tv_sec, &local);
+
+    timeSyncData.epoch = (uint32_t)tv.tv_sec;
+    timeSyncData.epoch_ms = tv.tv_usec / 1000;
+    timeSyncData.utc_offset_min = (GMT_OFFSET_SEC + (local.tm_isdst > 0 ? DAYLIGHT_OFFSET_SEC : 0)) / 60;
+    timeSyncData.valid = 1;
+
+    bool ok;
+    {
+        ScopedLatency t(i2cLatency);
+        ok = i2cBridge.writeStruct(BRIDGE_ADDRESS_1, 0x04, timeSyncData);
+    }
+    if (!ok) {
+        i2cErrors.inc();
+        Serial.println("[I2C] Time sync to bridge failed");
+    }
+}
+
 // ==================== WiFi & NTP ====================
 
 void setupWiFi() {
@@ -1435,9 +1849,11 @@ void setupWiFi() {
         configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
         timeConfigured = true;
         Serial.println("[NTP] Time configured");
+        requestRedraw();
     } else {
         Serial.println("\n[WiFi] Connection failed - will retry later");
         wifiConnected = false;
+        requestRedraw();
     }
 }
 
@@ -1485,9 +1901,13 @@ void sendIndoorToInfluxDB() {
 
     // Daten senden
     if (!influxClient.writePoint(indoorPoint)) {
+        influxWritesFailed.inc();
+        influxQueueDepth++;
         Serial.print("[InfluxDB] Write Indoor failed: ");
         Serial.println(influxClient.getLastErrorMessage());
     } else {
+        influxWritesOk.inc();
+        influxQueueDepth = 0;
         Serial.println("[InfluxDB] Indoor data written");
     }
 }
@@ -1513,9 +1933,13 @@ void sendOutdoorToInfluxDB() {
 
     // Daten senden
     if (!influxClient.writePoint(outdoorPoint)) {
+        influxWritesFailed.inc();
+        influxQueueDepth++;
         Serial.print("[InfluxDB] Write Outdoor failed: ");
         Serial.println(influxClient.getLastErrorMessage());
     } else {
+        influxWritesOk.inc();
+        influxQueueDepth = 0;
         Serial.println("[InfluxDB] Outdoor data written");
     }
 }
@@ -1619,6 +2043,13 @@ void logIndoorData() {
     if (dateStr == "unknown") return; // Keine gültige Zeit
 
     String filename = "/" + dateStr + "_indoor.csv";
+
+    // Sidecar-Index nach Boot / Monatswechsel einmalig synchronisieren
+    if (!indoorIndex.valid || filename != indoorIndex.csvPath) {
+        CsvIndex::sync(SD, filename.c_str(), indoorIndex);
+    }
+
+    uint32_t writeStartUs = micros();
     bool fileExists = SD.exists(filename);
 
     File file = SD.open(filename, FILE_APPEND);
@@ -1633,7 +2064,9 @@ void logIndoorData() {
     }
 
     // Daten schreiben
-    file.print(getDateTimeString());
+    String dateTime = getDateTimeString();
+    uint32_t recordOffset = file.size();
+    file.print(dateTime);
     file.print(",");
     file.print(indoorData.temperature, 1);
     file.print(",");
@@ -1648,8 +2081,20 @@ void logIndoorData() {
     file.print(indoorData.battery_warning ? "1" : "0");
     file.print(",");
     file.println(indoorData.sleep_time_sec);
+    sdWriteLatency.observe(micros() - writeStartUs);
+
+    {
+        ScopedLatency t(sdFlushLatency);
+        file.close();
+    }
+
+    // Neue Stunde -> Index-Eintrag (Zeit, Offset, Zeile) anhängen
+    uint32_t key;
+    CsvField dateTimeField = { dateTime.c_str(), (uint16_t)dateTime.length() };
+    if (CsvIndex::parseDateTime(dateTimeField, key)) {
+        CsvIndex::recordAppended(SD, indoorIndex, key, recordOffset);
+    }
 
-    file.close();
     Serial.printf("[SD] Indoor data logged to %s\n", filename.c_str());
 }
 
@@ -1660,6 +2105,13 @@ void logOutdoorData() {
     if (dateStr == "unknown") return; // Keine gültige Zeit
 
     String filename = "/" + dateStr + "_outdoor.csv";
+
+    // Sidecar-Index nach Boot / Monatswechsel einmalig synchronisieren
+    if (!outdoorIndex.valid || filename != outdoorIndex.csvPath) {
+        CsvIndex::sync(SD, filename.c_str(), outdoorIndex);
+    }
+
+    uint32_t writeStartUs = micros();
     bool fileExists = SD.exists(filename);
 
     File file = SD.open(filename, FILE_APPEND);
@@ -1674,7 +2126,9 @@ void logOutdoorData() {
     }
 
     // Daten schreiben
-    file.print(getDateTimeString());
+    String dateTime = getDateTimeString();
+    uint32_t recordOffset = file.size();
+    file.print(dateTime);
     file.print(",");
     file.print(outdoorData.temperature, 1);
     file.print(",");
@@ -1687,8 +2141,20 @@ void logOutdoorData() {
     file.print(outdoorData.battery_warning ? "1" : "0");
     file.print(",");
     file.println(outdoorData.sleep_time_sec);
+    sdWriteLatency.observe(micros() - writeStartUs);
+
+    {
+        ScopedLatency t(sdFlushLatency);
+        file.close();
+    }
+
+    // Neue Stunde -> Index-Eintrag (Zeit, Offset, Zeile) anhängen
+    uint32_t key;
+    CsvField dateTimeField = { dateTime.c_str(), (uint16_t)dateTime.length() };
+    if (CsvIndex::parseDateTime(dateTimeField, key)) {
+        CsvIndex::recordAppended(SD, outdoorIndex, key, recordOffset);
+    }
 
-    file.close();
     Serial.printf("[SD] Outdoor data logged to %s\n", filename.c_str());
 }
 
@@ -1804,13 +2270,178 @@ void handleDownload() {
         return;
     }
 
-    server.streamFile(file, "text/csv");
+    size_t fileSize = file.size();
+    time_t lastWrite = file.getLastWrite();
+
+    // Validatoren: Dateien werden nur angehängt, Grösse + Änderungszeit reichen als ETag
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%x-%lx\"", (unsigned int)fileSize, (unsigned long)lastWrite);
+
+    char lastModified[32];
+    struct tm gmt;
+    gmtime_r(&lastWrite, &gmt);
+    strftime(lastModified, sizeof(lastModified), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Last-Modified", lastModified);
+    server.sendHeader("Accept-Ranges", "bytes");
+
+    // Conditional GET: unverändert -> 304 ohne Body
+    // If-None-Match hat Vorrang; If-Modified-Since wird wie üblich exakt verglichen
+    bool notModified = false;
+    if (server.hasHeader("If-None-Match")) {
+        notModified = (server.header("If-None-Match") == etag);
+    } else if (server.hasHeader("If-Modified-Since")) {
+        notModified = (server.header("If-Modified-Since") == lastModified);
+    }
+
+    if (notModified) {
+        file.close();
+        server.send(304, "text/csv", "");
+        return;
+    }
+
+    // Range nur auswerten wenn If-Range fehlt oder noch passt (sonst volle Datei)
+    size_t rangeStart = 0;
+    size_t rangeEnd = fileSize ? fileSize - 1 : 0;
+    bool partial = false;
+
+    if (server.hasHeader("Range") &&
+        (!server.hasHeader("If-Range") || server.header("If-Range") == etag)) {
+
+        int rangeResult = parseRangeHeader(server.header("Range"), fileSize, rangeStart, rangeEnd);
+
+        if (rangeResult < 0) {
+            char contentRange[32];
+            snprintf(contentRange, sizeof(contentRange), "bytes */%u", (unsigned int)fileSize);
+            server.sendHeader("Content-Range", contentRange);
+            file.close();
+            server.send(416, "text/plain", "Range not satisfiable");
+            return;
+        }
+        partial = (rangeResult > 0);
+    }
+
+    if (!partial) {
+        server.streamFile(file, "text/csv");
+        file.close();
+        return;
+    }
+
+    // 206 Partial Content: nur den angefragten Bereich senden (z.B. neu angehängte Zeilen)
+    size_t length = rangeEnd - rangeStart + 1;
+    char contentRange[48];
+    snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u",
+             (unsigned int)rangeStart, (unsigned int)rangeEnd, (unsigned int)fileSize);
+    server.sendHeader("Content-Range", contentRange);
+    server.setContentLength(length);
+    server.send(206, "text/csv", "");
+
+    if (!file.seek(rangeStart)) {
+        Serial.println("[Web] Seek failed");
+        file.close();
+        return;
+    }
+
+    uint8_t buffer[1024];
+    WiFiClient client = server.client();
+    size_t remaining = length;
+
+    while (remaining > 0 && client.connected()) {
+        size_t chunk = file.read(buffer, min(remaining, sizeof(buffer)));
+        if (chunk == 0) break;
+        client.write(buffer, chunk);
+        remaining -= chunk;
+    }
+
     file.close();
+    Serial.printf("[Web] %s: sent bytes %u-%u of %u\n", filepath.c_str(),
+                  (unsigned int)rangeStart, (unsigned int)rangeEnd, (unsigned int)fileSize);
+}
+
+/**
+ * Range-Header auswerten (nur ein einzelner Byte-Bereich)
+ * Unterstützt "bytes=a-b", "bytes=a-" und "bytes=-n"
+ * @return 1 = gültiger Bereich, 0 = ignorieren (volle Datei), -1 = nicht erfüllbar (416)
+ */
+int parseRangeHeader(const String& range, size_t fileSize, size_t& start, size_t& end) {
+    if (!range.startsWith("bytes=") || range.indexOf(',') >= 0) {
+        return 0;  // Unbekannte Einheit oder Multi-Range: volle Datei senden
+    }
+
+    int dash = range.indexOf('-');
+    if (dash < 0) return 0;
+
+    String first = range.substring(6, dash);
+    String last = range.substring(dash + 1);
+    first.trim();
+    last.trim();
+
+    if (first.length() == 0) {
+        // Suffix-Range: die letzten n Bytes
+        if (last.length() == 0) return 0;
+        size_t suffix = strtoul(last.c_str(), nullptr, 10);
+        if (suffix == 0 || fileSize == 0) return -1;
+        start = (suffix >= fileSize) ? 0 : fileSize - suffix;
+        end = fileSize - 1;
+        return 1;
+    }
+
+    start = strtoul(first.c_str(), nullptr, 10);
+    if (start >= fileSize) return -1;  // z.B. Sync-Skript ist bereits aktuell
+
+    end = (last.length() == 0) ? fileSize - 1 : strtoul(last.c_str(), nullptr, 10);
+    if (end >= fileSize) end = fileSize - 1;
+    if (end < start) return 0;
+
+    return 1;
+}
+
+void handleMetrics() {
+    String out;
+    out.reserve(4096);
+
+    i2cLatency.writePrometheus(out, "cyd_i2c_transaction_seconds", "I2C transaction latency (ping, status, struct read)");
+    writePrometheusCounter(out, "cyd_i2c_errors_total", "Failed I2C transactions", i2cErrors.get());
+    writePrometheusCounter(out, "cyd_bridge_esp_now_packets_total", "ESP-NOW packets received by the bridge", systemStatus.esp_now_packets);
+    writePrometheusCounter(out, "cyd_bridge_frames_dropped_total", "ESP-NOW frames dropped by the bridge (ring full)", systemStatus.frames_dropped);
+
+    sdWriteLatency.writePrometheus(out, "cyd_sd_write_seconds", "SD log line write latency (open + print)");
+    sdFlushLatency.writePrometheus(out, "cyd_sd_flush_seconds", "SD flush latency (file close)");
+    loopLatency.writePrometheus(out, "cyd_loop_seconds", "Main loop iteration time without idle delay");
+    frameLatency.writePrometheus(out, "cyd_display_frame_seconds", "Display update time");
+    touchLatency.writePrometheus(out, "cyd_touch_to_pixel_seconds", "Gesture recognized until the first push of the new screen");
+    gestureDuration.writePrometheus(out, "cyd_touch_gesture_duration_seconds", "First touch until the gesture is recognized");
+    writePrometheusCounter(out, "cyd_touch_events_dropped_total", "Gestures dropped because the UI queue was full", touchEventsDropped.get());
+
+    writePrometheusCounter(out, "cyd_display_spi_bytes_total", "Pixel bytes pushed to the LCD", retained.getBytesTotal());
+    writePrometheusGauge(out, "cyd_display_frame_spi_bytes", "Pixel bytes pushed by the last display update", retained.getBytesLastFrame());
+    writePrometheusCounter(out, "cyd_display_fields_redrawn_total", "Retained text fields re-rasterized", retained.getFieldsRedrawn());
+
+    writePrometheusGauge(out, "cyd_heap_free_bytes", "Free heap", ESP.getFreeHeap());
+    writePrometheusGauge(out, "cyd_heap_min_free_bytes", "Lowest free heap since boot", ESP.getMinFreeHeap());
+    writePrometheusGauge(out, "cyd_heap_largest_free_block_bytes", "Largest allocatable heap block", ESP.getMaxAllocHeap());
+    writePrometheusGauge(out, "cyd_graph_arena_high_water_bytes", "Peak graph arena use", graphArena.getHighWater());
+    writePrometheusGauge(out, "cyd_graph_arena_capacity_bytes", "Graph arena size", graphArena.capacity());
+    writePrometheusGauge(out, "cyd_uptime_seconds", "Time since boot", millis() / 1000.0);
+
+    #ifdef ENABLE_INFLUXDB
+    writePrometheusGauge(out, "cyd_influxdb_queue_depth", "Points not yet confirmed by InfluxDB", influxQueueDepth);
+    writePrometheusCounter(out, "cyd_influxdb_writes_total", "Successful InfluxDB writes", influxWritesOk.get());
+    writePrometheusCounter(out, "cyd_influxdb_write_errors_total", "Failed InfluxDB writes", influxWritesFailed.get());
+    #endif
+
+    server.send(200, "text/plain; version=0.0.4", out);
 }
 
 void setupWebServer() {
+    // Header für Range/Conditional GET müssen explizit gesammelt werden
+    const char* headerKeys[] = {"Range", "If-Range", "If-None-Match", "If-Modified-Since"};
+    server.collectHeaders(headerKeys, sizeof(headerKeys) / sizeof(headerKeys[0]));
+
     server.on("/", handleRoot);
     server.on("/download", handleDownload);
+    server.on("/metrics", handleMetrics);
     server.begin();
     Serial.println("[Web] Server started on http://" + WiFi.localIP().toString());
 }
@@ -1825,10 +2456,12 @@ void setup() {
     
     // ========== Display initialisieren ==========
     Serial.println("[Display] Initializing...");
+    displayMutex = xSemaphoreCreateRecursiveMutex();
     
     lcd.init();
     lcd.setRotation(DISPLAY_ROTATION);
     lcd.setBrightness(128);
+    lcd.initDMA();  // Graph-Seiten werden per DMA gepusht (ohne DMA-Kanal: synchron)
 
     screenWidth = lcd.width();
     screenHeight = lcd.height();
@@ -1837,7 +2470,9 @@ void setup() {
     Serial.printf("[Display] Size: %dx%d\n", screenWidth, screenHeight);
     Serial.printf("[Display] Rotation: %d\n", DISPLAY_ROTATION);
     Serial.println("[Touch] Touch configured via CYD_Display_Config.h");
-    
+
+    setupRetainedFields();
+
     lcd.fillScreen(COLOR_BG);
     drawHeader();
     
@@ -1853,6 +2488,9 @@ void setup() {
     outdoorSprite.createSprite(spriteW, spriteH);
     
     Serial.printf("[Display] Sprites created: %dx%d\n", spriteW, spriteH);
+
+    // Graph-Seiten früh allozieren, solange der Heap noch am Stück ist
+    graphPages.begin(screenWidth, screenHeight);
     
     // ========== I2C Bridge initialisieren ==========
     Serial.println("\n[I2C] Initializing master...");
@@ -1863,6 +2501,8 @@ void setup() {
     i2cBridge.registerStruct(0x01, &indoorData, 1, "Indoor");
     i2cBridge.registerStruct(0x02, &outdoorData, 1, "Outdoor");
     i2cBridge.registerStruct(0x03, &systemStatus, 1, "Status");
+    i2cBridge.registerStruct(0x04, &timeSyncData, 1, "TimeSync");
+    i2cBridge.registerStruct(0x05, &linkStats, 1, "LinkStats");
     
     Serial.printf("[I2C] Master mode on SDA=%d, SCL=%d\n", extSDA, extSCL);
     Serial.printf("[I2C] Scanning for bridge at 0x%02X...\n", BRIDGE_ADDRESS_1);
@@ -1878,8 +2518,7 @@ void setup() {
 
     // ========== Min/Max Tracking initialisieren ==========
     Serial.println("\n[MinMax] Initializing tracking...");
-    initMinMax(indoorMinMax);
-    initMinMax(outdoorMinMax);
+    minMax24.begin();
 
     // ========== Graph initialisieren ==========
     graphData.dataCount = 0;
@@ -1908,6 +2547,12 @@ void setup() {
     // SD-Karte braucht separaten VSPI und muss NACH Display-Setup kommen
     delay(100);  // Kurze Pause damit Display/Touch komplett ready sind
     sdCardAvailable = initSDCard();
+    if (sdCardAvailable) {
+        loadMinMaxSnapshot();
+    }
+
+    // Touch erst starten, wenn Display, Graph-Seiten und SD bereit sind
+    setupTouch();
 
     Serial.println("\n[READY] System running!\n");
     if (sdCardAvailable) {
@@ -1928,9 +2573,7 @@ void setup() {
 
 void loop() {
     unsigned long now = millis();
-
-    // Touch prüfen (für Display-Modus-Wechsel)
-    checkTouch();
+    uint32_t loopStartUs = micros();
 
     // Auto-Return nach 30 Sekunden prüfen
     checkAutoReturn();
@@ -1941,19 +2584,49 @@ void loop() {
         pollI2CData();
     }
 
+    // Uhrzeit an die Bridge (für die Zeit-Beacons der Sensoren)
+    if (now - lastTimeSync >= TIME_SYNC_INTERVAL) {
+        lastTimeSync = now;
+        pushTimeToBridge();
+    }
+
+    // Zustandswechsel fresh/late/lost: genau zum berechneten Zeitpunkt neu zeichnen
+    bool freshnessDue = (freshnessTimerMs != FRESHNESS_NEVER) &&
+                        (now - freshnessTimerStart >= freshnessTimerMs);
+    if (freshnessDue) {
+        armFreshnessTimer(now);
+        Serial.printf("[FRESH] Indoor: %s, Outdoor: %s\n",
+                     SensorFreshness::stateName(indoorFreshness.state(now)),
+                     SensorFreshness::stateName(outdoorFreshness.state(now)));
+    }
+
     // Display aktualisieren - NUR im Normal-Modus (0)
     // Modi 1 (Min/Max) und 2 (Graph) werden nicht automatisch aktualisiert
-    if (displayMode == 0 && now - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-        lastDisplayUpdate = now;
+    // Nur geänderte Felder werden neu gezeichnet (Retained-Mode)
+    // Kein Polling: neue Daten/Status (requestRedraw), Minutenwechsel oder fresh/late/lost
+    bool redrawDue = redrawRequested || freshnessDue ||
+                     (redrawTimerMs != FRESHNESS_NEVER && now - redrawTimerStart >= redrawTimerMs);
+    // Der UI-Task (höhere Priorität) kann vor dem Lock auf einen anderen Schirm
+    // wechseln: Modus unter dem Lock erneut prüfen, erst dann quittieren
+    if (displayMode == 0 && redrawDue) {
+        DisplayLock lock;
+        if (displayMode == 0) {
+            redrawRequested = false;
+            armRedrawTimer(now);
+            ScopedLatency frameTimer(frameLatency);
+            retained.beginFrame();
+
+            updateHeaderFields();
 
-        drawHeader();
+            if (indoorReceived) {
+                updateIndoorFields();
+            }
 
-        if (indoorReceived) {
-            drawIndoorSection();
-        }
+            if (outdoorReceived) {
+                updateOutdoorFields();
+            }
 
-        if (outdoorReceived) {
-            drawOutdoorSection();
+            retained.endFrame();
         }
     }
 
@@ -1969,6 +2642,12 @@ void loop() {
             logOutdoorData();
         }
 
+        // 24h Min/Max sichern (Reboot ohne Log-Rescan)
+        saveMinMaxSnapshot();
+
+        // Neue CSV-Zeilen -> Graph-Seiten im Leerlauf neu rendern
+        graphPagesDirty = true;
+
         // InfluxDB: Parallel zu SD-Karte senden
         #ifdef ENABLE_INFLUXDB
         if (influxDBConnected) {
@@ -1982,6 +2661,16 @@ void loop() {
         #endif
     }
 
+    // Graph-Seiten im Hintergrund aktualisieren (SD-Laden ohne Display-Lock,
+    // Touch bleibt bedienbar); ein gerade angezeigter Graph wird neu gepusht
+    if (sdCardAvailable && graphPagesDirty &&
+        (lastGraphRefresh == 0 || now - lastGraphRefresh >= GRAPH_REFRESH_RETRY)) {
+        refreshGraphPages();
+        if (displayMode == 1 || displayMode == 2) {
+            updateDisplay();
+        }
+    }
+
     // InfluxDB Reconnect (falls nicht verbunden aber WiFi aktiv)
     #ifdef ENABLE_INFLUXDB
     if (wifiConnected && !influxDBConnected && now - lastInfluxRetry >= INFLUX_RETRY_INTERVAL) {
@@ -2008,5 +2697,7 @@ void loop() {
         server.handleClient();
     }
 
+    loopLatency.observe(micros() - loopStartUs);
+
     delay(10);
 }
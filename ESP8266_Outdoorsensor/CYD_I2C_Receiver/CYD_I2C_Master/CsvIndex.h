@@ -0,0 +1,312 @@
+/*
+ * CsvIndex.h
+ * Zeitstempel-Index (Sidecar-Datei) für die monatlichen CSV-Logs
+ *
+ * Zu jeder YYYYMM_xxx.csv gehört eine YYYYMM_xxx.idx mit einem Eintrag pro
+ * Stunde: {Zeit-Schlüssel, Byte-Offset, Zeilennummer}. Der Logger hängt beim
+ * Schreiben den Eintrag an, Leser finden per Binärsuche direkt im Index
+ * (O(log n) kleine Reads) den Offset zu einer Zeit oder Zeilennummer.
+ *
+ * Fehlt der Index oder passt er nicht zur CSV (alte Firmware, gelöschte Datei),
+ * wird er beim ersten Zugriff neu aufgebaut bzw. vom letzten gültigen Eintrag
+ * aus nachgeführt.
+ *
+ * Schlüssel = lokale Sekunden seit 1970 aus "YYYY-MM-DD HH:MM:SS" (ohne Zeitzone).
+ * Bei der Zeitumstellung im Herbst ist die doppelte Stunde nicht monoton,
+ * Zeilennummern sind es immer.
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef CSV_INDEX_H
+#define CSV_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "CsvReader.h"
+
+// ==================== KONFIGURATION ====================
+
+#define CSV_INDEX_MAGIC 0x31584943UL   // "CIX1"
+#define CSV_INDEX_VERSION 1
+#define CSV_INDEX_INTERVAL 3600        // Ein Eintrag pro Stunde
+#define CSV_INDEX_PATH_LEN 40
+
+// ==================== DATENSTRUKTUREN ====================
+
+struct CsvIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;
+};
+
+struct CsvIndexEntry {
+    uint32_t key;       // Lokale Sekunden seit 1970
+    uint32_t offset;    // Byte-Offset des Datensatzes in der CSV
+    uint32_t row;       // Zeilennummer (0 = erster Datensatz nach dem Header)
+};
+
+// Zustand einer CSV-Datei für den Logger (nach sync() gültig)
+struct CsvIndexState {
+    char csvPath[CSV_INDEX_PATH_LEN];
+    uint32_t rows;      // Anzahl Datensätze in der CSV
+    uint32_t lastSlot;  // key / CSV_INDEX_INTERVAL des letzten Index-Eintrags
+    bool valid;
+};
+
+// ==================== INDEX ====================
+
+class CsvIndex {
+private:
+    static void indexPath(const char* csvPath, char* out, size_t len) {
+        strncpy(out, csvPath, len - 1);
+        out[len - 1] = '\0';
+        char* dot = strrchr(out, '.');
+        if (dot && (size_t)(dot - out) + 4 < len) {
+            strcpy(dot, ".idx");
+        }
+    }
+
+    // Tage seit 1970-01-01 (proleptischer Gregorianischer Kalender)
+    static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+        y -= m <= 2;
+        const int32_t era = (y >= 0 ? y : y - 399) / 400;
+        const uint32_t yoe = (uint32_t)(y - era * 400);
+        const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (int32_t)doe - 719468;
+    }
+
+    static bool readEntry(File& idx, uint32_t i, CsvIndexEntry& e) {
+        if (!idx.seek(sizeof(CsvIndexHeader) + i * sizeof(CsvIndexEntry))) return false;
+        return idx.read((uint8_t*)&e, sizeof(e)) == sizeof(e);
+    }
+
+    static uint32_t entryCount(File& idx) {
+        size_t size = idx.size();
+        if (size < sizeof(CsvIndexHeader)) return 0;
+        return (size - sizeof(CsvIndexHeader)) / sizeof(CsvIndexEntry);
+    }
+
+    static bool headerValid(File& idx) {
+        CsvIndexHeader hdr;
+        if (!idx.seek(0) || idx.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+        return hdr.magic == CSV_INDEX_MAGIC && hdr.version == CSV_INDEX_VERSION &&
+               hdr.entrySize == sizeof(CsvIndexEntry);
+    }
+
+    /**
+     * CSV ab einem Datensatz scannen und fehlende Stunden-Einträge anhängen
+     */
+    static void scan(File& csv, File& idx, uint32_t startOffset, uint32_t startRow,
+                     bool skipHeader, CsvIndexState& st) {
+        csv.seek(startOffset);
+        CsvReader<File> reader(csv, startOffset);
+        if (skipHeader) reader.next();
+
+        uint32_t row = startRow;
+        while (reader.next()) {
+            uint32_t key;
+            if (parseDateTime(reader.field(0), key) && key / CSV_INDEX_INTERVAL != st.lastSlot) {
+                CsvIndexEntry e = { key, reader.offset(), row };
+                idx.write((const uint8_t*)&e, sizeof(e));
+                st.lastSlot = key / CSV_INDEX_INTERVAL;
+            }
+            row++;
+        }
+        st.rows = row;
+    }
+
+    static bool rebuild(fs::FS& fs, const char* csvPath, const char* idxPath, CsvIndexState& st) {
+        File csv = fs.open(csvPath, FILE_READ);
+        File idx = fs.open(idxPath, FILE_WRITE);
+        if (!csv || !idx) {
+            if (csv) csv.close();
+            if (idx) idx.close();
+            return false;
+        }
+
+        CsvIndexHeader hdr = { CSV_INDEX_MAGIC, CSV_INDEX_VERSION, sizeof(CsvIndexEntry) };
+        idx.write((const uint8_t*)&hdr, sizeof(hdr));
+
+        st.lastSlot = 0;
+        scan(csv, idx, 0, 0, true, st);
+
+        idx.close();
+        csv.close();
+        Serial.printf("[Index] Rebuilt %s (%lu rows)\n", idxPath, (unsigned long)st.rows);
+        return true;
+    }
+
+public:
+    /**
+     * "YYYY-MM-DD HH:MM:SS" in lokale Sekunden seit 1970 umrechnen
+     */
+    static bool parseDateTime(const CsvField& f, uint32_t& key) {
+        const char* p = f.ptr;
+        if (f.len < 19 || p[4] != '-' || p[7] != '-' || p[10] != ' ' || p[13] != ':' || p[16] != ':') {
+            return false;
+        }
+
+        int v[6];
+        const uint8_t pos[6] = { 0, 5, 8, 11, 14, 17 };
+        const uint8_t digits[6] = { 4, 2, 2, 2, 2, 2 };
+        for (int i = 0; i < 6; i++) {
+            v[i] = 0;
+            for (int k = 0; k < digits[i]; k++) {
+                char c = p[pos[i] + k];
+                if (c < '0' || c > '9') return false;
+                v[i] = v[i] * 10 + (c - '0');
+            }
+        }
+
+        if (v[1] < 1 || v[1] > 12 || v[2] < 1 || v[2] > 31) return false;
+
+        int32_t days = daysFromCivil(v[0], v[1], v[2]);
+        key = (uint32_t)days * 86400UL + v[3] * 3600UL + v[4] * 60UL + v[5];
+        return true;
+    }
+
+    /**
+     * Index prüfen und nachführen, Zeilenzahl der CSV ermitteln
+     * Gültig = letzter Eintrag zeigt auf einen Datensatz derselben Stunde.
+     * Danach folgende Datensätze werden nachindiziert, sonst Neuaufbau.
+     * @return false wenn CSV/Index nicht lesbar sind (st.valid = false)
+     */
+    static bool sync(fs::FS& fs, const char* csvPath, CsvIndexState& st) {
+        char idxPath[CSV_INDEX_PATH_LEN];
+        indexPath(csvPath, idxPath, sizeof(idxPath));
+
+        strncpy(st.csvPath, csvPath, sizeof(st.csvPath) - 1);
+        st.csvPath[sizeof(st.csvPath) - 1] = '\0';
+        st.rows = 0;
+        st.lastSlot = 0;
+        st.valid = false;
+
+        if (!fs.exists(csvPath)) {
+            // Neue Datei: alter Index wäre falsch
+            if (fs.exists(idxPath)) fs.remove(idxPath);
+            st.valid = true;
+            return true;
+        }
+
+        if (fs.exists(idxPath)) {
+            File idx = fs.open(idxPath, FILE_READ);
+            CsvIndexEntry last;
+            bool ok = idx && headerValid(idx);
+            uint32_t count = ok ? entryCount(idx) : 0;
+            ok = ok && count > 0 && readEntry(idx, count - 1, last);
+            if (idx) idx.close();
+
+            if (ok) {
+                // Letzten Eintrag gegen die CSV prüfen
+                File csv = fs.open(csvPath, FILE_READ);
+                ok = csv && last.offset < csv.size() && csv.seek(last.offset);
+                if (ok) {
+                    CsvReader<File> reader(csv, last.offset);
+                    uint32_t key;
+                    ok = reader.next() && parseDateTime(reader.field(0), key) &&
+                         key / CSV_INDEX_INTERVAL == last.key / CSV_INDEX_INTERVAL;
+                }
+
+                if (ok) {
+                    File idxAppend = fs.open(idxPath, FILE_APPEND);
+                    if (idxAppend) {
+                        st.lastSlot = last.key / CSV_INDEX_INTERVAL;
+                        scan(csv, idxAppend, last.offset, last.row, false, st);
+                        idxAppend.close();
+                    } else {
+                        ok = false;
+                    }
+                }
+                if (csv) csv.close();
+            }
+
+            if (ok) {
+                st.valid = true;
+                return true;
+            }
+        }
+
+        st.valid = rebuild(fs, csvPath, idxPath, st);
+        return st.valid;
+    }
+
+    /**
+     * Logger: Datensatz wurde an die CSV angehängt
+     * @param key Zeitschlüssel des Datensatzes (parseDateTime)
+     * @param offset Byte-Offset, an dem der Datensatz beginnt
+     */
+    static void recordAppended(fs::FS& fs, CsvIndexState& st, uint32_t key, uint32_t offset) {
+        if (!st.valid) return;
+
+        if (key / CSV_INDEX_INTERVAL != st.lastSlot) {
+            char idxPath[CSV_INDEX_PATH_LEN];
+            indexPath(st.csvPath, idxPath, sizeof(idxPath));
+
+            bool isNew = !fs.exists(idxPath);
+            File idx = fs.open(idxPath, FILE_APPEND);
+            if (idx) {
+                if (isNew) {
+                    CsvIndexHeader hdr = { CSV_INDEX_MAGIC, CSV_INDEX_VERSION, sizeof(CsvIndexEntry) };
+                    idx.write((const uint8_t*)&hdr, sizeof(hdr));
+                }
+                CsvIndexEntry e = { key, offset, st.rows };
+                idx.write((const uint8_t*)&e, sizeof(e));
+                idx.close();
+                st.lastSlot = key / CSV_INDEX_INTERVAL;
+            } else {
+                st.valid = false;  // Beim nächsten Log neu synchronisieren
+            }
+        }
+        st.rows++;
+    }
+
+    /**
+     * Binärsuche: letzter Eintrag mit row <= value (byTime = false)
+     * bzw. key <= value (byTime = true). Liegt value vor dem ersten
+     * Eintrag, wird der erste geliefert.
+     * @return false wenn kein (gültiger) Index existiert
+     */
+    static bool find(fs::FS& fs, const char* csvPath, uint32_t value, bool byTime, CsvIndexEntry& out) {
+        char idxPath[CSV_INDEX_PATH_LEN];
+        indexPath(csvPath, idxPath, sizeof(idxPath));
+
+        File idx = fs.open(idxPath, FILE_READ);
+        if (!idx) return false;
+
+        uint32_t count = headerValid(idx) ? entryCount(idx) : 0;
+        if (count == 0 || !readEntry(idx, 0, out)) {
+            idx.close();
+            return false;
+        }
+
+        uint32_t lo = 0;
+        uint32_t hi = count;    // Invariante: Eintrag lo passt (oder lo = 0)
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            CsvIndexEntry e;
+            if (!readEntry(idx, mid, e)) break;
+
+            if ((byTime ? e.key : e.row) <= value) {
+                lo = mid;
+                out = e;
+            } else {
+                hi = mid;
+            }
+        }
+
+        idx.close();
+        return true;
+    }
+
+    static bool findRow(fs::FS& fs, const char* csvPath, uint32_t row, CsvIndexEntry& out) {
+        return find(fs, csvPath, row, false, out);
+    }
+
+    static bool findTime(fs::FS& fs, const char* csvPath, uint32_t key, CsvIndexEntry& out) {
+        return find(fs, csvPath, key, true, out);
+    }
+};
+
+#endif // CSV_INDEX_H
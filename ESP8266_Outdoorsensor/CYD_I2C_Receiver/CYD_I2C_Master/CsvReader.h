@@ -0,0 +1,243 @@
+/*
+ * CsvReader.h
+ * Allokationsfreier Streaming-CSV-Leser für SD-Logdateien
+ *
+ * Liest blockweise in einen festen Puffer und liefert pro Datensatz
+ * Feld-Spans (Zeiger + Länge) direkt in diesen Puffer - kein String,
+ * kein malloc. Dazu ein Festkomma-Parser für Werte wie "-3.4".
+ *
+ * Funktioniert mit:
+ * - CYD Monatsdateien (YYYYMM_indoor.csv / YYYYMM_outdoor.csv)
+ * - ESP32_C3_Datalogger Logs (/indoor_log.csv) inkl. leerer Felder ("ts,,,21.50,...")
+ *
+ * Quelle: jede Klasse mit read(uint8_t* buf, size_t len) (z.B. SD File).
+ * Keine Anführungszeichen-Behandlung (kommt in den Logs nicht vor).
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ==================== KONFIGURATION ====================
+
+#define CSV_BLOCK_SIZE 512          // Lese-Block = max. Zeilenlänge
+#define CSV_MAX_FIELDS 16           // Felder pro Datensatz (Rest wird ignoriert)
+
+// ==================== FELD ====================
+
+struct CsvField {
+    const char* ptr;
+    uint16_t len;
+
+    bool isEmpty() const { return len == 0; }
+};
+
+// ==================== FESTKOMMA-PARSER ====================
+
+/**
+ * Dezimalzahl als Festkomma parsen ("-3.4" mit decimals=2 -> -340)
+ * Überzählige Nachkommastellen werden abgeschnitten.
+ * @return false bei leerem Feld oder ungültigem Zeichen
+ */
+inline bool csvParseFixed(const CsvField& f, int32_t& out, uint8_t decimals) {
+    const char* p = f.ptr;
+    const char* end = f.ptr + f.len;
+
+    while (p < end && *p == ' ') p++;
+    if (p == end) return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    int32_t value = 0;
+    uint8_t fracDigits = 0;
+    bool inFraction = false;
+    bool anyDigit = false;
+
+    for (; p < end; p++) {
+        char c = *p;
+        if (c >= '0' && c <= '9') {
+            anyDigit = true;
+            if (inFraction) {
+                if (fracDigits >= decimals) continue;
+                fracDigits++;
+            }
+            value = value * 10 + (c - '0');
+        } else if (c == '.' && !inFraction) {
+            inFraction = true;
+        } else if (c == ' ') {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    if (!anyDigit) return false;
+
+    while (fracDigits < decimals) {
+        value *= 10;
+        fracDigits++;
+    }
+
+    out = negative ? -value : value;
+    return true;
+}
+
+/**
+ * Ganzzahl parsen (Nachkommastellen werden abgeschnitten)
+ */
+inline bool csvParseInt(const CsvField& f, int32_t& out) {
+    return csvParseFixed(f, out, 0);
+}
+
+/**
+ * Float über Festkomma (2 Nachkommastellen reichen für alle Logwerte)
+ */
+inline bool csvParseFloat(const CsvField& f, float& out) {
+    int32_t fixed;
+    if (!csvParseFixed(f, fixed, 2)) return false;
+    out = fixed / 100.0f;
+    return true;
+}
+
+// ==================== LESER ====================
+
+template <typename Source>
+class CsvReader {
+private:
+    Source& source;
+    char block[CSV_BLOCK_SIZE];
+    size_t pos;                     // Beginn des nächsten Datensatzes im Block
+    size_t fill;                    // Gültige Bytes im Block
+    uint32_t blockOffset;           // Dateioffset von block[0]
+    uint32_t recordStart;           // Dateioffset des aktuellen Datensatzes
+    bool eof;
+
+    CsvField fields[CSV_MAX_FIELDS];
+    uint8_t fieldCount;
+
+    // Restdaten an den Blockanfang schieben und nachfüllen
+    bool refill() {
+        if (eof) return false;
+
+        if (pos > 0) {
+            memmove(block, block + pos, fill - pos);
+            blockOffset += pos;
+            fill -= pos;
+            pos = 0;
+        }
+
+        if (fill >= CSV_BLOCK_SIZE) return false;  // Zeile länger als Block
+
+        int n = source.read((uint8_t*)block + fill, CSV_BLOCK_SIZE - fill);
+        if (n <= 0) {
+            eof = true;
+            return false;
+        }
+        fill += n;
+        return true;
+    }
+
+    void split(char* line, size_t len) {
+        fieldCount = 0;
+        size_t start = 0;
+
+        for (size_t i = 0; i <= len && fieldCount < CSV_MAX_FIELDS; i++) {
+            if (i == len || line[i] == ',') {
+                fields[fieldCount].ptr = line + start;
+                fields[fieldCount].len = (uint16_t)(i - start);
+                fieldCount++;
+                start = i + 1;
+            }
+        }
+    }
+
+public:
+    /**
+     * @param src Quelle mit read(uint8_t*, size_t)
+     * @param startOffset Dateioffset, an dem die Quelle aktuell steht (nach seek)
+     */
+    CsvReader(Source& src, uint32_t startOffset = 0)
+        : source(src), pos(0), fill(0), blockOffset(startOffset),
+          recordStart(startOffset), eof(false), fieldCount(0) {}
+
+    /**
+     * Nächsten Datensatz lesen und in Felder zerlegen
+     * Leere Zeilen und zu lange Zeilen werden übersprungen.
+     * @return false am Dateiende
+     */
+    bool next() {
+        while (true) {
+            char* nl = (char*)memchr(block + pos, '\n', fill - pos);
+
+            if (!nl) {
+                if (refill()) continue;
+
+                if (fill - pos >= CSV_BLOCK_SIZE) {
+                    // Überlange Zeile verwerfen und bis zum nächsten '\n' vorspulen
+                    pos = fill;
+                    while (refill()) {
+                        nl = (char*)memchr(block, '\n', fill);
+                        if (nl) {
+                            pos = nl - block + 1;
+                            break;
+                        }
+                        pos = fill;
+                    }
+                    continue;
+                }
+
+                if (pos == fill) return false;  // Dateiende
+
+                // Letzte Zeile ohne '\n'
+                nl = block + fill;
+            }
+
+            char* line = block + pos;
+            size_t len = nl - line;
+            recordStart = blockOffset + pos;
+            pos = (nl < block + fill) ? (nl - block + 1) : fill;
+
+            if (len > 0 && line[len - 1] == '\r') len--;
+            if (len == 0) continue;
+
+            split(line, len);
+            return true;
+        }
+    }
+
+    /**
+     * N Datensätze überspringen (ohne Felder zu zerlegen)
+     * @return Anzahl tatsächlich übersprungener Datensätze
+     */
+    uint32_t skip(uint32_t n) {
+        uint32_t skipped = 0;
+        while (skipped < n && next()) {
+            skipped++;
+        }
+        return skipped;
+    }
+
+    uint8_t count() const { return fieldCount; }
+
+    const CsvField& field(uint8_t i) const {
+        static const CsvField empty = { "", 0 };
+        return (i < fieldCount) ? fields[i] : empty;
+    }
+
+    /** Dateioffset des zuletzt gelesenen Datensatzes */
+    uint32_t offset() const { return recordStart; }
+
+    /** Dateioffset hinter dem zuletzt gelesenen Datensatz */
+    uint32_t nextOffset() const { return blockOffset + pos; }
+};
+
+#endif // CSV_READER_H
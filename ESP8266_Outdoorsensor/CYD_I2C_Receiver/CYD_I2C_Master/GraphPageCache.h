@@ -0,0 +1,187 @@
+/*
+ * GraphPageCache.h
+ * Vorgerenderte Vollbild-Seiten (Graphen) mit DMA-Push
+ *
+ * Jede Seite wird - wenn der Speicher reicht - im Hintergrund in ein
+ * Vollbild-Sprite gerendert (PSRAM bevorzugt, sonst Heap). Ein Seitenwechsel
+ * ist dann ein einziger DMA-Push ohne sichtbaren Bildaufbau.
+ *
+ * Passt kein Vollbild-Sprite in den Speicher, wird die Seite beim Anzeigen
+ * in Streifen (Bands) gerendert: zwei kleine Band-Sprites wechseln sich ab,
+ * während eines per DMA gesendet wird, wird das nächste gezeichnet.
+ * Der Speicherbedarf bleibt damit auf 2 × Breite × GRAPH_BAND_HEIGHT begrenzt.
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef GRAPH_PAGE_CACHE_H
+#define GRAPH_PAGE_CACHE_H
+
+#include <LovyanGFX.hpp>
+
+// ==================== KONFIGURATION ====================
+
+#define GRAPH_PAGE_COUNT 2          // Outdoor Graph, Battery Graph
+#define GRAPH_BAND_HEIGHT 30        // Zeilen pro Band im Fallback-Modus
+#define GRAPH_HEAP_RESERVE 100000   // Min. freier Heap nach Seiten-Allokation (WiFi, SD, Webserver)
+
+// Zeichnet eine Seite in g; yOffset = LCD-Zeile, die in g bei y=0 liegt
+// Die Funktion muss den Hintergrund selbst füllen (g.fillScreen)
+typedef void (*PageRenderFn)(LovyanGFX& g, int yOffset);
+
+// ==================== HAUPT-KLASSE ====================
+
+class GraphPageCache {
+private:
+    lgfx::LGFX_Device* display;
+    LGFX_Sprite pages[GRAPH_PAGE_COUNT];
+    bool pageAllocated[GRAPH_PAGE_COUNT];
+    bool pageValid[GRAPH_PAGE_COUNT];       // Sprite-Inhalt entspricht aktuellen Daten
+
+    LGFX_Sprite bands[2];
+    bool bandsAllocated;
+
+    int width;
+    int height;
+
+    // Sprite-Puffer per DMA an Zeile y senden (rows <= Sprite-Höhe)
+    void pushDMA(LGFX_Sprite& sprite, int y, int rows) {
+        display->pushImageDMA(0, y, width, rows, (lgfx::swap565_t*)sprite.getBuffer());
+    }
+
+    bool allocateBands() {
+        if (bandsAllocated) return true;
+
+        for (int i = 0; i < 2; i++) {
+            bands[i].setColorDepth(16);
+            bands[i].setPsram(false);  // Band-Puffer müssen DMA-fähig sein
+            if (!bands[i].createSprite(width, GRAPH_BAND_HEIGHT)) {
+                Serial.println("[Pages] Band allocation failed!");
+                bands[0].deleteSprite();
+                return false;
+            }
+        }
+
+        bandsAllocated = true;
+        return true;
+    }
+
+public:
+    GraphPageCache(lgfx::LGFX_Device* parent) : display(parent) {
+        bandsAllocated = false;
+        width = 0;
+        height = 0;
+
+        for (int i = 0; i < GRAPH_PAGE_COUNT; i++) {
+            pageAllocated[i] = false;
+            pageValid[i] = false;
+        }
+    }
+
+    /**
+     * Seiten-Sprites einmalig allozieren (danach keine Allokationen mehr)
+     * @param w Display-Breite
+     * @param h Display-Höhe
+     */
+    void begin(int w, int h) {
+        width = w;
+        height = h;
+        bool usePsram = psramFound();
+
+        uint32_t pageBytes = (uint32_t)width * height * 2;
+
+        for (int i = 0; i < GRAPH_PAGE_COUNT; i++) {
+            // Ohne PSRAM nur so viele Vollbild-Seiten, wie der Heap verkraftet
+            if (!usePsram && (ESP.getMaxAllocHeap() < pageBytes ||
+                              ESP.getFreeHeap() < pageBytes + GRAPH_HEAP_RESERVE)) {
+                pageAllocated[i] = false;
+            } else {
+                pages[i].setColorDepth(16);
+                pages[i].setPsram(usePsram);
+                pageAllocated[i] = (pages[i].createSprite(width, height) != nullptr);
+            }
+
+            Serial.printf("[Pages] Page %d: %s\n", i,
+                          pageAllocated[i] ? (usePsram ? "full sprite (PSRAM)" : "full sprite (heap)")
+                                           : "band rendering");
+        }
+
+        // Band-Puffer nur anlegen, wenn mindestens eine Seite sie braucht
+        for (int i = 0; i < GRAPH_PAGE_COUNT; i++) {
+            if (!pageAllocated[i]) {
+                allocateBands();
+                break;
+            }
+        }
+    }
+
+    /**
+     * Alle Seiten als veraltet markieren (neue Daten)
+     */
+    void invalidateAll() {
+        for (int i = 0; i < GRAPH_PAGE_COUNT; i++) {
+            pageValid[i] = false;
+        }
+    }
+
+    /**
+     * Seite im Hintergrund rendern (nur mit Vollbild-Sprite möglich)
+     * @return true wenn die Seite jetzt gecacht ist
+     */
+    bool render(uint8_t page, PageRenderFn renderFn) {
+        if (page >= GRAPH_PAGE_COUNT || !pageAllocated[page]) return false;
+
+        renderFn(pages[page], 0);
+        pageValid[page] = true;
+        return true;
+    }
+
+    /**
+     * Seite anzeigen: gecacht = ein DMA-Push, sonst Band für Band rendern
+     * @return Anzahl gesendeter Pixel-Bytes
+     */
+    uint32_t show(uint8_t page, PageRenderFn renderFn) {
+        if (page >= GRAPH_PAGE_COUNT) return 0;
+
+        if (pageAllocated[page]) {
+            if (!pageValid[page]) {
+                render(page, renderFn);
+            }
+
+            display->startWrite();
+            pushDMA(pages[page], 0, height);
+            display->waitDMA();
+            display->endWrite();
+            return (uint32_t)width * height * 2;
+        }
+
+        if (!allocateBands()) {
+            // Letzter Ausweg: direkt auf das Display zeichnen
+            renderFn(*display, 0);
+            return (uint32_t)width * height * 2;
+        }
+
+        // Band-Rendering: Band n zeichnen, während Band n-1 per DMA läuft
+        // pushImageDMA wartet selbst auf den vorherigen Transfer, danach ist
+        // der andere Puffer wieder frei.
+        display->startWrite();
+        int band = 0;
+        for (int y = 0; y < height; y += GRAPH_BAND_HEIGHT, band++) {
+            LGFX_Sprite& sprite = bands[band & 1];
+            int rows = min(GRAPH_BAND_HEIGHT, height - y);
+
+            renderFn(sprite, y);
+            pushDMA(sprite, y, rows);
+        }
+        display->waitDMA();
+        display->endWrite();
+
+        return (uint32_t)width * height * 2;
+    }
+
+    bool isCached(uint8_t page) const {
+        return page < GRAPH_PAGE_COUNT && pageAllocated[page] && pageValid[page];
+    }
+};
+
+#endif // GRAPH_PAGE_CACHE_H
@@ -5,8 +5,14 @@
  * Ermöglicht die Übertragung beliebiger Struct-Daten zwischen
  * mehreren ESP32-Slaves und einem Master über I2C
  * 
+ * Seit 1.1.0 kann der Master auch Structs zum Slave schreiben
+ * (CMD_WRITE_STRUCT, z.B. die NTP-Zeit für die Bridge)
+ * 
+ * Seit 1.1.1 wird ein geschriebenes Struct unter einem Spinlock übernommen
+ * und mit takeWrittenStruct() ausgelesen - loop() sieht nie einen halben Stand
+ * 
  * Author: Stefan
- * Version: 1.0.0
+ * Version: 1.1.1
  */
 
 #ifndef I2C_SENSOR_BRIDGE_H
@@ -27,6 +33,7 @@
 #define CMD_GET_INFO        0x04  // Struct-Info abfragen (Size, Version)
 #define CMD_PING            0x05  // Verbindungstest
 #define CMD_GET_COUNT       0x06  // Anzahl registrierter Structs
+#define CMD_WRITE_STRUCT    0x07  // Struct-Daten vom Master zum Slave
 
 // Fehler-Codes
 #define I2C_BRIDGE_OK           0
@@ -49,6 +56,7 @@ private:
         unsigned long lastUpdate;                // Timestamp letztes Update
         char name[16];                           // Debug-Name
         bool inUse;                             // Slot belegt?
+        volatile bool written;                  // Vom Master geschrieben (nur Slave)
     };
     
     // Member-Variablen
@@ -67,6 +75,7 @@ private:
     volatile uint8_t currentCommand;                 // Aktueller Befehl
     volatile uint8_t currentStructId;                // Angeforderter Struct
     volatile bool requestPending;                    // Request ausstehend
+    portMUX_TYPE writeMux;                           // Schützt vom Master geschriebene Structs
     
     // Singleton für Wire Callbacks
     static I2CSensorBridge* activeInstance;
@@ -81,11 +90,13 @@ public:
         currentCommand = 0;
         currentStructId = 0;
         requestPending = false;
+        writeMux = portMUX_INITIALIZER_UNLOCKED;
         
         // Registry initialisieren
         for (int i = 0; i < I2C_BRIDGE_MAX_STRUCTS; i++) {
             registry[i].inUse = false;
             registry[i].hasNewData = false;
+            registry[i].written = false;
         }
     }
     
@@ -177,6 +188,7 @@ public:
         registry[id].version = version;
         registry[id].dataPtr = (void*)dataPtr;
         registry[id].hasNewData = false;
+        registry[id].written = false;
         registry[id].lastUpdate = 0;
         registry[id].inUse = true;
         
@@ -353,6 +365,36 @@ public:
         return (totalReceived == expectedSize);
     }
     
+    /**
+     * Struct zum Slave schreiben (Slave muss dieselbe ID mit gleicher Größe registriert haben)
+     * @param slaveAddress I2C Adresse
+     * @param structId Struct ID
+     * @param data Zu sendende Daten
+     * @return true wenn der Slave die Übertragung bestätigt hat
+     */
+    template<typename T>
+    bool writeStruct(uint8_t slaveAddress, uint8_t structId, const T& data) {
+        if (!isMaster) return false;
+        
+        // Kommando + ID + Daten in einer Übertragung
+        if (sizeof(T) + 2 > I2C_BRIDGE_BUFFER_SIZE) {
+            return false;
+        }
+        
+        wireInterface->beginTransmission(slaveAddress);
+        wireInterface->write(CMD_WRITE_STRUCT);
+        wireInterface->write(structId);
+        wireInterface->write((const uint8_t*)&data, sizeof(T));
+        bool ok = (wireInterface->endTransmission() == 0);
+        
+        #if I2C_BRIDGE_DEBUG
+        Serial.printf("[I2C Bridge] Write %d bytes to struct ID=%d: %s\n",
+                     sizeof(T), structId, ok ? "OK" : "failed");
+        #endif
+        
+        return ok;
+    }
+    
     /**
      * Anzahl registrierter Structs beim Slave abfragen
      */
@@ -400,6 +442,50 @@ public:
         }
     }
     
+    /**
+     * Hat der Master das Struct seit dem letzten clearWrittenFlag() geschrieben? (Slave)
+     */
+    bool wasWritten(uint8_t id) const {
+        if (id >= I2C_BRIDGE_MAX_STRUCTS) return false;
+        return registry[id].inUse && registry[id].written;
+    }
+    
+    /**
+     * Written-Flag zurücksetzen (Slave)
+     */
+    void clearWrittenFlag(uint8_t id) {
+        if (id < I2C_BRIDGE_MAX_STRUCTS && registry[id].inUse) {
+            registry[id].written = false;
+        }
+    }
+    
+    /**
+     * Vom Master geschriebenes Struct konsistent kopieren und Written-Flag löschen (Slave)
+     * Der I2C-Callback schreibt unter demselben Spinlock, die Kopie ist nie halb alt/halb neu.
+     * @param id Struct ID
+     * @param out Ziel
+     * @param updateMs Optional: millis() des Schreibens
+     * @return true wenn seit dem letzten Aufruf neu geschrieben wurde
+     */
+    template<typename T>
+    bool takeWrittenStruct(uint8_t id, T& out, unsigned long* updateMs = nullptr) {
+        if (id >= I2C_BRIDGE_MAX_STRUCTS || !registry[id].inUse ||
+            registry[id].size != sizeof(T)) {
+            return false;
+        }
+
+        portENTER_CRITICAL(&writeMux);
+        bool written = registry[id].written;
+        if (written) {
+            memcpy(&out, registry[id].dataPtr, sizeof(T));
+            if (updateMs) *updateMs = registry[id].lastUpdate;
+            registry[id].written = false;
+        }
+        portEXIT_CRITICAL(&writeMux);
+
+        return written;
+    }
+    
     /**
      * Zeitstempel des letzten Updates
      */
@@ -500,6 +586,23 @@ private:
                     }
                 }
                 break;
+                
+            case CMD_WRITE_STRUCT:
+                if (bytes >= 2) {
+                    uint8_t id = wireInterface->read();
+                    // Nur vollständige Structs übernehmen (Größe muss exakt passen)
+                    if (id < I2C_BRIDGE_MAX_STRUCTS && registry[id].inUse &&
+                        bytes - 2 == registry[id].size) {
+                        wireInterface->readBytes(rxBuffer, registry[id].size);
+                        unsigned long now = millis();
+                        portENTER_CRITICAL(&writeMux);
+                        memcpy(registry[id].dataPtr, rxBuffer, registry[id].size);
+                        registry[id].lastUpdate = now;
+                        registry[id].written = true;
+                        portEXIT_CRITICAL(&writeMux);
+                    }
+                }
+                break;
         }
         
         // Restliche Bytes verwerfen
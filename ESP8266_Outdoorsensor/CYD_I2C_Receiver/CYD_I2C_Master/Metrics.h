@@ -0,0 +1,185 @@
+/*
+ * Metrics.h
+ * Interne Performance-Zähler für den CYD Master (Prometheus Text-Format)
+ *
+ * Counter und Histogramme verwenden nur relaxed Atomics:
+ * Der Hot-Path (I2C, SD, Loop, Display) zahlt ein paar Additionen,
+ * ein Scrape über /metrics sperrt nichts und bremst das Gerät nicht aus.
+ *
+ * HELP/TYPE und Samples werden stückweise an den String gehängt - kein
+ * Zeilenpuffer, der bei langen Namen oder Hilfetexten abschneiden könnte.
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+
+// ==================== KONFIGURATION ====================
+
+// Bucket-Grenzen in Mikrosekunden (letzter Bucket = +Inf)
+#define METRICS_HIST_BUCKETS 11
+static const uint32_t METRICS_BUCKET_BOUNDS_US[METRICS_HIST_BUCKETS - 1] = {
+    100, 500, 1000, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+
+// ==================== TEXT-FORMAT ====================
+
+/**
+ * "# HELP" und "# TYPE" Zeilen anhängen
+ * @param type "counter", "gauge" oder "histogram"
+ */
+inline void metricsAppendHeader(String& out, const char* name, const char* help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+/**
+ * Sample-Zeile "<name><suffix> <wert>" anhängen
+ * @param fmt printf-Format für genau einen Wert
+ * @return false wenn der Wert nicht formatiert werden konnte (Zeile entfällt)
+ */
+inline bool metricsAppendSample(String& out, const char* name, const char* suffix,
+                                const char* fmt, ...) {
+    char value[40];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(value, sizeof(value), fmt, args);
+    va_end(args);
+    if (n < 0 || n >= (int)sizeof(value)) {
+        return false;
+    }
+
+    out += name;
+    out += suffix;
+    out += ' ';
+    out += value;
+    out += '\n';
+    return true;
+}
+
+// ==================== COUNTER ====================
+
+class MetricCounter {
+private:
+    std::atomic<uint32_t> value;
+
+public:
+    MetricCounter() : value(0) {}
+
+    void inc(uint32_t n = 1) {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint32_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// ==================== HISTOGRAMM ====================
+
+class LatencyHistogram {
+private:
+    std::atomic<uint32_t> buckets[METRICS_HIST_BUCKETS];  // Nicht kumulativ, erst beim Scrape
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> sumLowUs;                        // Summe in µs (untere 32 Bit)
+    std::atomic<uint32_t> sumWraps;                        // Überläufe von sumLowUs
+
+public:
+    LatencyHistogram() : count(0), sumLowUs(0), sumWraps(0) {
+        for (int i = 0; i < METRICS_HIST_BUCKETS; i++) {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Messwert erfassen (lock-free, O(Buckets))
+     * @param us Dauer in Mikrosekunden
+     */
+    void observe(uint32_t us) {
+        int i = 0;
+        while (i < METRICS_HIST_BUCKETS - 1 && us > METRICS_BUCKET_BOUNDS_US[i]) {
+            i++;
+        }
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t old = sumLowUs.fetch_add(us, std::memory_order_relaxed);
+        if (old + us < old) {
+            sumWraps.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t getCount() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Histogramm im Prometheus Text-Format anhängen (Werte in Sekunden)
+     */
+    void writePrometheus(String& out, const char* name, const char* help) const {
+        metricsAppendHeader(out, name, help, "histogram");
+
+        uint32_t cumulative = 0;
+        for (int i = 0; i < METRICS_HIST_BUCKETS; i++) {
+            cumulative += buckets[i].load(std::memory_order_relaxed);
+
+            char suffix[32];
+            if (i < METRICS_HIST_BUCKETS - 1) {
+                snprintf(suffix, sizeof(suffix), "_bucket{le=\"%g\"}", METRICS_BUCKET_BOUNDS_US[i] / 1e6);
+            } else {
+                snprintf(suffix, sizeof(suffix), "_bucket{le=\"+Inf\"}");
+            }
+            metricsAppendSample(out, name, suffix, "%lu", (unsigned long)cumulative);
+        }
+
+        uint64_t sumUs = ((uint64_t)sumWraps.load(std::memory_order_relaxed) << 32) |
+                         sumLowUs.load(std::memory_order_relaxed);
+        metricsAppendSample(out, name, "_sum", "%.6f", sumUs / 1e6);
+        metricsAppendSample(out, name, "_count", "%lu", (unsigned long)cumulative);
+    }
+};
+
+// ==================== HILFSFUNKTIONEN ====================
+
+/**
+ * Misst die Lebensdauer des Scopes und trägt sie ins Histogramm ein
+ */
+class ScopedLatency {
+private:
+    LatencyHistogram& hist;
+    uint32_t startUs;
+
+public:
+    explicit ScopedLatency(LatencyHistogram& h) : hist(h), startUs(micros()) {}
+    ~ScopedLatency() { hist.observe(micros() - startUs); }
+};
+
+/**
+ * Counter im Prometheus Text-Format anhängen
+ */
+inline void writePrometheusCounter(String& out, const char* name, const char* help, uint32_t value) {
+    metricsAppendHeader(out, name, help, "counter");
+    metricsAppendSample(out, name, "", "%lu", (unsigned long)value);
+}
+
+/**
+ * Gauge im Prometheus Text-Format anhängen
+ */
+inline void writePrometheusGauge(String& out, const char* name, const char* help, double value) {
+    metricsAppendHeader(out, name, help, "gauge");
+    metricsAppendSample(out, name, "", "%.6g", value);
+}
+
+#endif // METRICS_H
@@ -0,0 +1,199 @@
+/*
+ * RetainedText.h
+ * Retained-Mode Textfelder für inkrementelles Display-Rendering
+ *
+ * Jedes Feld merkt sich Text, Farbe und belegten Bereich des letzten Zeichnens.
+ * Nur geänderte Felder werden neu gerastert: der Bereich (alte ∪ neue Textbreite)
+ * wird in einem statischen Puffer gezeichnet und als kleines Rechteck gepusht.
+ * Damit schrumpft ein typisches 5 s Update ("x min ago") von ~100 KB auf ~1 KB SPI.
+ * Felder, deren Bereich grösser als der Puffer ist (Uhrzeit im 480px Header),
+ * werden in mehreren Streifen nebeneinander gezeichnet statt abgeschnitten.
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef RETAINED_TEXT_H
+#define RETAINED_TEXT_H
+
+#include <LovyanGFX.hpp>
+
+// ==================== KONFIGURATION ====================
+
+#define RETAINED_MAX_W 280      // Puffergrösse in Pixeln = RETAINED_MAX_W × RETAINED_MAX_H,
+#define RETAINED_MAX_H 48       // grössere Felder werden in schmaleren Streifen gezeichnet
+#define RETAINED_BUF_PIXELS (RETAINED_MAX_W * RETAINED_MAX_H)
+#define RETAINED_TEXT_LEN 32    // Max Textlänge pro Feld
+
+// Hintergrund-Callback für Felder auf nicht-einfarbigem Grund (z.B. Header-Verlauf)
+// Zeichnet den Hintergrund des LCD-Bereichs (x, y, w, h) in das Sprite an (0, 0)
+typedef void (*RetainedBackgroundFn)(LGFX_Sprite& dst, int x, int y, int w, int h);
+
+// ==================== FELD ====================
+
+struct RetainedField {
+    // Layout (einmal gesetzt)
+    int16_t anchorX, anchorY;       // Textanker auf dem LCD
+    uint8_t datum;                  // LovyanGFX textdatum (top_center, middle_left, ...)
+    int16_t boxX, boxY, boxW, boxH; // Maximaler Bereich des Feldes (Clipping)
+    const lgfx::IFont* font;
+    uint16_t bgColor;
+    RetainedBackgroundFn bgFn;      // nullptr = einfarbig bgColor
+
+    // Zustand des letzten Zeichnens
+    char lastText[RETAINED_TEXT_LEN];
+    uint16_t lastColor;
+    int16_t lastX, lastW;           // Belegter Bereich (lastW = 0: leer)
+    bool valid;                     // false = muss neu gezeichnet werden
+};
+
+// ==================== LAYER ====================
+
+class RetainedTextLayer {
+private:
+    LGFX_Sprite scratch;            // Sprite ohne eigenen Speicher (setBuffer)
+    uint16_t buffer[RETAINED_BUF_PIXELS];
+
+    uint32_t bytesTotal;            // Gesendete Pixel-Bytes seit Start
+    uint32_t bytesFrame;            // Pixel-Bytes des laufenden Frames
+    uint32_t bytesLastFrame;        // Pixel-Bytes des letzten abgeschlossenen Frames
+    uint32_t fieldsRedrawn;         // Neu gerasterte Felder seit Start
+
+    // Horizontaler Textbereich aus Datum und Breite
+    static void textSpan(const RetainedField& f, int w, int& x0) {
+        switch (f.datum & 3) {
+            case 1:  x0 = f.anchorX - w / 2; break;  // *_center
+            case 2:  x0 = f.anchorX - w;     break;  // *_right
+            default: x0 = f.anchorX;         break;  // *_left
+        }
+    }
+
+public:
+    RetainedTextLayer(LovyanGFX* parent) : scratch(parent) {
+        bytesTotal = 0;
+        bytesFrame = 0;
+        bytesLastFrame = 0;
+        fieldsRedrawn = 0;
+    }
+
+    /**
+     * Feld-Layout setzen und Feld als ungültig markieren
+     * @param box* Maximaler Bereich, in dem das Feld Text darstellen darf
+     */
+    static void setup(RetainedField& f, int anchorX, int anchorY, uint8_t datum,
+                      int boxX, int boxY, int boxW, int boxH,
+                      const lgfx::IFont* font, uint16_t bgColor,
+                      RetainedBackgroundFn bgFn = nullptr) {
+        f.anchorX = anchorX;
+        f.anchorY = anchorY;
+        f.datum = datum;
+        f.boxX = boxX;
+        f.boxY = boxY;
+        f.boxW = boxW;
+        f.boxH = min(boxH, RETAINED_BUF_PIXELS);
+        f.font = font;
+        f.bgColor = bgColor;
+        f.bgFn = bgFn;
+        invalidate(f);
+    }
+
+    /**
+     * Feld beim nächsten draw() neu zeichnen (z.B. nach fillScreen)
+     * Der Bereich gilt dann als bereits gelöscht.
+     */
+    static void invalidate(RetainedField& f) {
+        f.lastText[0] = '\0';
+        f.lastW = 0;
+        f.valid = false;
+    }
+
+    /**
+     * Text anzeigen, nur wenn sich Text oder Farbe geändert haben
+     * @param text Neuer Text ("" = Feld leeren)
+     * @return true wenn gezeichnet wurde
+     */
+    bool draw(RetainedField& f, const char* text, uint16_t color) {
+        if (f.valid && f.lastColor == color && strncmp(f.lastText, text, RETAINED_TEXT_LEN) == 0) {
+            return false;
+        }
+
+        scratch.setFont(f.font);
+        int newW = (text[0] != '\0') ? scratch.textWidth(text) + 2 : 0;
+        int newX = 0;
+        textSpan(f, newW, newX);
+        newX -= 1;
+
+        // Dirty-Region = alter ∪ neuer Textbereich, auf Feldbox begrenzt
+        int x0 = f.boxX + f.boxW;
+        int x1 = f.boxX;
+        if (f.lastW > 0) {
+            x0 = min(x0, (int)f.lastX);
+            x1 = max(x1, f.lastX + f.lastW);
+        }
+        if (newW > 0) {
+            x0 = min(x0, newX);
+            x1 = max(x1, newX + newW);
+        }
+        x0 = max(x0, (int)f.boxX);
+        x1 = min(x1, f.boxX + f.boxW);
+
+        // Grösser als der Puffer: in Streifen so breit, wie der Puffer bei
+        // dieser Höhe erlaubt; jeder Streifen rastert denselben Text mit Versatz
+        if (x1 > x0 && f.boxH > 0) {
+            int h = f.boxH;
+            int stripeW = RETAINED_BUF_PIXELS / h;
+            for (int sx = x0; sx < x1; sx += stripeW) {
+                int w = min(x1 - sx, stripeW);
+
+                scratch.setBuffer(buffer, w, h, lgfx::rgb565_2Byte);
+                if (f.bgFn) {
+                    f.bgFn(scratch, sx, f.boxY, w, h);
+                } else {
+                    scratch.fillScreen(f.bgColor);
+                }
+
+                if (newW > 0) {
+                    scratch.setFont(f.font);
+                    scratch.setTextColor(color);
+                    scratch.setTextDatum(f.datum);
+                    scratch.drawString(text, f.anchorX - sx, f.anchorY - f.boxY);
+                }
+
+                scratch.pushSprite(sx, f.boxY);
+                countBytes((uint32_t)w * h * 2);
+            }
+        }
+
+        strncpy(f.lastText, text, RETAINED_TEXT_LEN - 1);
+        f.lastText[RETAINED_TEXT_LEN - 1] = '\0';
+        f.lastColor = color;
+        f.lastX = newX;
+        f.lastW = newW;
+        f.valid = true;
+        fieldsRedrawn++;
+        return true;
+    }
+
+    // ==================== SPI ZÄHLER ====================
+
+    /**
+     * Pixel-Bytes zählen, die ausserhalb der Felder gesendet werden (Vollbild, Sprites)
+     */
+    void countBytes(uint32_t bytes) {
+        bytesTotal += bytes;
+        bytesFrame += bytes;
+    }
+
+    void beginFrame() {
+        bytesFrame = 0;
+    }
+
+    void endFrame() {
+        bytesLastFrame = bytesFrame;
+    }
+
+    uint32_t getBytesTotal() const { return bytesTotal; }
+    uint32_t getBytesLastFrame() const { return bytesLastFrame; }
+    uint32_t getFieldsRedrawn() const { return fieldsRedrawn; }
+};
+
+#endif // RETAINED_TEXT_H
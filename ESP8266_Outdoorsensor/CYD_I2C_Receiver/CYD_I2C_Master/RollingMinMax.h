@@ -0,0 +1,321 @@
+/*
+ * RollingMinMax.h
+ * Gleitendes 24h Min/Max-Fenster mit monotonen Deques
+ *
+ * Pro Messgrösse je eine monotone Deque für Min und Max:
+ * Neue Werte verdrängen am Ende alle Einträge, die nie mehr Extremwert
+ * werden können, am Anfang fallen Einträge aus dem Fenster.
+ * Update und Abfrage sind damit O(1) amortisiert, ohne Log-Dateien neu zu lesen.
+ *
+ * Samples werden in Zeit-Buckets (MINMAX_BUCKET_SEC) zusammengefasst, damit die
+ * Deque-Grösse unabhängig von der Sensor-Sendeperiode fest begrenzt ist.
+ * Der Zustand wird als Binär-Snapshot gespeichert und nach einem Reboot geladen.
+ *
+ * Kein Arduino-Code: läuft auch in tools/replay.cpp auf dem PC.
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef ROLLING_MINMAX_H
+#define ROLLING_MINMAX_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ==================== KONFIGURATION ====================
+
+#define MINMAX_WINDOW_SEC 86400     // 24h Fenster
+#define MINMAX_BUCKET_SEC 600       // Auflösung der Fenstergrenze (10 min)
+#define MINMAX_CAPACITY (MINMAX_WINDOW_SEC / MINMAX_BUCKET_SEC + 2)
+
+#define MINMAX_SNAPSHOT_MAGIC 0x4D4D3234UL   // "MM24"
+#define MINMAX_SNAPSHOT_VERSION 1
+
+// ==================== MONOTONE DEQUE ====================
+
+class MonotonicDeque {
+private:
+    struct Entry {
+        uint32_t bucket;    // Bucket-Startzeit in Sekunden
+        float value;
+    };
+
+    Entry entries[MINMAX_CAPACITY];
+    uint16_t head;
+    uint16_t count;
+    bool keepMax;           // true = Max-Deque (fallend), false = Min-Deque (steigend)
+
+    Entry& at(uint16_t i) { return entries[(head + i) % MINMAX_CAPACITY]; }
+    const Entry& at(uint16_t i) const { return entries[(head + i) % MINMAX_CAPACITY]; }
+
+    // true wenn a mindestens so extrem ist wie b
+    bool dominates(float a, float b) const {
+        return keepMax ? (a >= b) : (a <= b);
+    }
+
+public:
+    void begin(bool isMax) {
+        keepMax = isMax;
+        clear();
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * Wert einfügen (Zeit muss monoton steigen)
+     * @param t Zeit in Sekunden
+     */
+    void push(uint32_t t, float value) {
+        uint32_t bucket = t - (t % MINMAX_BUCKET_SEC);
+
+        // Hinten alles entfernen, was vom neuen Wert dominiert wird
+        while (count > 0 && dominates(value, at(count - 1).value)) {
+            count--;
+        }
+
+        // Gleicher Bucket und hinterer Wert extremer: neuer Wert läuft gleichzeitig ab -> unnötig
+        if (count > 0 && at(count - 1).bucket == bucket) {
+            return;
+        }
+
+        if (count == MINMAX_CAPACITY) {
+            // Kann nur bei Zeitsprüngen passieren: ältesten Eintrag opfern
+            head = (head + 1) % MINMAX_CAPACITY;
+            count--;
+        }
+
+        Entry& e = at(count);
+        e.bucket = bucket;
+        e.value = value;
+        count++;
+    }
+
+    /**
+     * Einträge entfernen, die vollständig ausserhalb des Fensters liegen
+     */
+    void expire(uint32_t now) {
+        while (count > 0 && at(0).bucket + MINMAX_BUCKET_SEC + MINMAX_WINDOW_SEC <= now) {
+            head = (head + 1) % MINMAX_CAPACITY;
+            count--;
+        }
+    }
+
+    /**
+     * Alle Zeitstempel verschieben (Wechsel Uptime -> Epoch nach NTP-Sync)
+     */
+    void rebase(int32_t delta) {
+        for (uint16_t i = 0; i < count; i++) {
+            Entry& e = at(i);
+            uint32_t t = e.bucket + delta;
+            e.bucket = t - (t % MINMAX_BUCKET_SEC);
+        }
+    }
+
+    bool isEmpty() const { return count == 0; }
+    float front() const { return at(0).value; }
+    uint16_t size() const { return count; }
+
+    // ==================== SNAPSHOT ====================
+
+    template <typename Writer>
+    void save(Writer& w, uint32_t& crc) const {
+        w.write((const uint8_t*)&count, sizeof(count));
+        crc = minMaxCrc32(crc, (const uint8_t*)&count, sizeof(count));
+        for (uint16_t i = 0; i < count; i++) {
+            const Entry& e = at(i);
+            w.write((const uint8_t*)&e, sizeof(Entry));
+            crc = minMaxCrc32(crc, (const uint8_t*)&e, sizeof(Entry));
+        }
+    }
+
+    template <typename Reader>
+    bool load(Reader& r, uint32_t& crc) {
+        uint16_t n = 0;
+        if (r.read((uint8_t*)&n, sizeof(n)) != sizeof(n) || n > MINMAX_CAPACITY) return false;
+        crc = minMaxCrc32(crc, (const uint8_t*)&n, sizeof(n));
+
+        clear();
+        for (uint16_t i = 0; i < n; i++) {
+            Entry& e = entries[i];
+            if (r.read((uint8_t*)&e, sizeof(Entry)) != sizeof(Entry)) return false;
+            crc = minMaxCrc32(crc, (const uint8_t*)&e, sizeof(Entry));
+        }
+        count = n;
+        return true;
+    }
+
+    static uint32_t minMaxCrc32(uint32_t crc, const uint8_t* data, size_t len) {
+        crc = ~crc;
+        while (len--) {
+            crc ^= *data++;
+            for (int k = 0; k < 8; k++) {
+                crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+};
+
+// ==================== MIN/MAX PRO GRÖSSE ====================
+
+class RollingMinMax {
+private:
+    MonotonicDeque minQ;
+    MonotonicDeque maxQ;
+
+public:
+    void begin() {
+        minQ.begin(false);
+        maxQ.begin(true);
+    }
+
+    void update(uint32_t now, float value) {
+        minQ.expire(now);
+        maxQ.expire(now);
+        minQ.push(now, value);
+        maxQ.push(now, value);
+    }
+
+    /**
+     * Extremwerte der letzten 24h
+     * @return false wenn im Fenster keine Werte liegen
+     */
+    bool get(uint32_t now, float& minValue, float& maxValue) {
+        minQ.expire(now);
+        maxQ.expire(now);
+        if (minQ.isEmpty() || maxQ.isEmpty()) return false;
+
+        minValue = minQ.front();
+        maxValue = maxQ.front();
+        return true;
+    }
+
+    void rebase(int32_t delta) {
+        minQ.rebase(delta);
+        maxQ.rebase(delta);
+    }
+
+    template <typename Writer>
+    void save(Writer& w, uint32_t& crc) const {
+        minQ.save(w, crc);
+        maxQ.save(w, crc);
+    }
+
+    template <typename Reader>
+    bool load(Reader& r, uint32_t& crc) {
+        return minQ.load(r, crc) && maxQ.load(r, crc);
+    }
+};
+
+// ==================== SET MIT SNAPSHOT ====================
+
+/**
+ * Feste Anzahl Messgrössen mit gemeinsamer Zeitbasis und Snapshot-Datei
+ *
+ * Zeitbasis: Epoch-Sekunden sobald NTP verfügbar, vorher Uptime-Sekunden.
+ * Beim ersten gültigen Epoch-Wert werden alle Einträge umgerechnet.
+ * Nur Epoch-basierte Zustände werden gespeichert (Uptime überlebt keinen Reboot).
+ */
+template <uint8_t N>
+class RollingMinMaxSet {
+private:
+    RollingMinMax items[N];
+    bool epochBased;
+
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t itemCount;
+        uint32_t capacity;
+        uint32_t savedAt;       // Epoch-Sekunden
+    };
+
+public:
+    RollingMinMaxSet() : epochBased(false) {}
+
+    void begin() {
+        for (uint8_t i = 0; i < N; i++) {
+            items[i].begin();
+        }
+        epochBased = false;
+    }
+
+    /**
+     * Aktuelle Zeit wählen und bei NTP-Sync einmalig umrechnen
+     * @param epochNow Epoch-Sekunden (0 = noch keine gültige Zeit)
+     * @param uptimeNow Sekunden seit Boot
+     */
+    uint32_t now(uint32_t epochNow, uint32_t uptimeNow) {
+        if (epochNow == 0) {
+            return epochBased ? 0 : uptimeNow;
+        }
+        if (!epochBased) {
+            int32_t delta = (int32_t)(epochNow - uptimeNow);
+            for (uint8_t i = 0; i < N; i++) {
+                items[i].rebase(delta);
+            }
+            epochBased = true;
+        }
+        return epochNow;
+    }
+
+    RollingMinMax& operator[](uint8_t i) { return items[i]; }
+
+    bool isEpochBased() const { return epochBased; }
+
+    /**
+     * Snapshot schreiben (Header, Deques, CRC32)
+     * @return false wenn die Zeitbasis noch nicht Epoch ist
+     */
+    template <typename Writer>
+    bool save(Writer& w, uint32_t epochNow) const {
+        if (!epochBased) return false;
+
+        SnapshotHeader hdr = { MINMAX_SNAPSHOT_MAGIC, MINMAX_SNAPSHOT_VERSION, N, MINMAX_CAPACITY, epochNow };
+        uint32_t crc = 0;
+        w.write((const uint8_t*)&hdr, sizeof(hdr));
+        crc = MonotonicDeque::minMaxCrc32(crc, (const uint8_t*)&hdr, sizeof(hdr));
+
+        for (uint8_t i = 0; i < N; i++) {
+            items[i].save(w, crc);
+        }
+
+        w.write((const uint8_t*)&crc, sizeof(crc));
+        return true;
+    }
+
+    /**
+     * Snapshot laden; bei Fehler bleibt der Zustand leer
+     */
+    template <typename Reader>
+    bool load(Reader& r) {
+        SnapshotHeader hdr;
+        if (r.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+        if (hdr.magic != MINMAX_SNAPSHOT_MAGIC || hdr.version != MINMAX_SNAPSHOT_VERSION ||
+            hdr.itemCount != N || hdr.capacity != MINMAX_CAPACITY) {
+            return false;
+        }
+
+        uint32_t crc = MonotonicDeque::minMaxCrc32(0, (const uint8_t*)&hdr, sizeof(hdr));
+        for (uint8_t i = 0; i < N; i++) {
+            if (!items[i].load(r, crc)) {
+                begin();
+                return false;
+            }
+        }
+
+        uint32_t storedCrc = 0;
+        if (r.read((uint8_t*)&storedCrc, sizeof(storedCrc)) != sizeof(storedCrc) || storedCrc != crc) {
+            begin();
+            return false;
+        }
+
+        epochBased = true;
+        return true;
+    }
+};
+
+#endif // ROLLING_MINMAX_H
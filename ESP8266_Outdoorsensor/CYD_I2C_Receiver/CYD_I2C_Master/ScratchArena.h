@@ -0,0 +1,70 @@
+/*
+ * ScratchArena.h
+ * Statisch reservierter Bump-Allocator für temporäre Lade-Puffer
+ *
+ * Die Graph-Loader holen ihre Arrays aus einem festen Puffer statt vom Heap.
+ * Allokieren = Zeiger weiterschieben, Freigeben = reset() nach dem Laden.
+ * Damit gibt es keine Heap-Fragmentierung und (bei per static_assert
+ * geprüfter Grösse) keinen "Memory allocation failed"-Pfad mehr.
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Worst-Case Platzbedarf für count Elemente vom Typ T (inkl. Ausrichtung)
+#define ARENA_BYTES(T, count) ((count) * sizeof(T) + alignof(T) - 1)
+
+template <size_t SIZE>
+class ScratchArena {
+private:
+    alignas(8) uint8_t buffer[SIZE];
+    size_t used;
+    size_t highWater;       // Max. Belegung seit Boot (für /metrics)
+
+public:
+    ScratchArena() : used(0), highWater(0) {}
+
+    /**
+     * Platz für count Elemente reservieren (uninitialisiert)
+     * @return nullptr nur wenn SIZE zu klein gewählt wurde
+     */
+    template <typename T>
+    T* alloc(size_t count) {
+        size_t start = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        size_t bytes = count * sizeof(T);
+        if (start + bytes > SIZE) return nullptr;
+
+        used = start + bytes;
+        if (used > highWater) highWater = used;
+        return reinterpret_cast<T*>(buffer + start);
+    }
+
+    /**
+     * Alle Allokationen auf einmal freigeben
+     */
+    void reset() { used = 0; }
+
+    size_t getUsed() const { return used; }
+    size_t getHighWater() const { return highWater; }
+    static constexpr size_t capacity() { return SIZE; }
+};
+
+/**
+ * Setzt die Arena am Ende des Scopes zurück (auch bei frühem return)
+ */
+template <size_t SIZE>
+class ArenaScope {
+private:
+    ScratchArena<SIZE>& arena;
+
+public:
+    explicit ArenaScope(ScratchArena<SIZE>& a) : arena(a) {}
+    ~ArenaScope() { arena.reset(); }
+};
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,128 @@
+/*
+ * TouchGesture.h
+ * Gesten-Erkennung (Tap, Swipe links/rechts, Long-Press) für Touch-Samples
+ *
+ * Reine Zustandsmaschine ohne Hardware-Zugriff: der Touch-Task füttert sie
+ * mit Samples (berührt ja/nein + Koordinaten) und bekommt fertige Gesten.
+ * Swipe und Long-Press werden schon während der Berührung erkannt,
+ * Tap beim Loslassen.
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// ==================== KONFIGURATION ====================
+
+#define GESTURE_TAP_MAX_MS 400          // Max. Dauer für Tap
+#define GESTURE_TAP_MAX_MOVE 20         // Max. Bewegung (px) für Tap/Long-Press
+#define GESTURE_SWIPE_MIN_PX 60         // Min. horizontale Strecke für Swipe
+#define GESTURE_LONG_PRESS_MS 700       // Haltedauer für Long-Press
+#define GESTURE_RELEASE_SAMPLES 3       // Fehlende Samples bis "losgelassen" (Entprellung)
+
+// ==================== DATENSTRUKTUREN ====================
+
+enum TouchGestureType : uint8_t {
+    GESTURE_NONE = 0,
+    GESTURE_TAP,
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_LONG_PRESS
+};
+
+struct TouchEvent {
+    TouchGestureType type;
+    int16_t x, y;           // Startpunkt der Berührung
+    uint32_t timeUs;        // Geste erkannt (micros), Start der Touch-to-Pixel Latenz
+    uint32_t durationUs;    // Erste Berührung bis Erkennung (Haltedauer + Entprellung)
+};
+
+// ==================== ERKENNUNG ====================
+
+class TouchGestureDetector {
+private:
+    enum State : uint8_t { IDLE, DOWN, CONSUMED };
+
+    State state;
+    int16_t startX, startY;
+    int16_t lastX, lastY;
+    uint32_t downMs;
+    uint32_t lastTouchMs;   // Letztes Sample mit Berührung
+    uint8_t missedSamples;
+
+public:
+    TouchGestureDetector() : state(IDLE), startX(0), startY(0), lastX(0), lastY(0),
+                             downMs(0), lastTouchMs(0), missedSamples(0) {}
+
+    /**
+     * Ein Touch-Sample verarbeiten
+     * @param touched true wenn der Controller eine Berührung meldet
+     * @param nowMs Zeit in Millisekunden
+     * @return erkannte Geste oder GESTURE_NONE
+     */
+    TouchGestureType update(bool touched, int16_t x, int16_t y, uint32_t nowMs) {
+        if (touched) {
+            missedSamples = 0;
+            lastTouchMs = nowMs;
+
+            if (state == IDLE) {
+                state = DOWN;
+                startX = lastX = x;
+                startY = lastY = y;
+                downMs = nowMs;
+                return GESTURE_NONE;
+            }
+
+            lastX = x;
+            lastY = y;
+
+            if (state != DOWN) return GESTURE_NONE;
+
+            int dx = lastX - startX;
+            int dy = lastY - startY;
+
+            // Swipe: horizontale Strecke erreicht und dominiert
+            if (abs(dx) >= GESTURE_SWIPE_MIN_PX && abs(dx) > 2 * abs(dy)) {
+                state = CONSUMED;
+                return (dx < 0) ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT;
+            }
+
+            // Long-Press: lange genug ruhig gehalten
+            if (nowMs - downMs >= GESTURE_LONG_PRESS_MS &&
+                abs(dx) <= GESTURE_TAP_MAX_MOVE && abs(dy) <= GESTURE_TAP_MAX_MOVE) {
+                state = CONSUMED;
+                return GESTURE_LONG_PRESS;
+            }
+
+            return GESTURE_NONE;
+        }
+
+        // Kein Touch: erst nach mehreren fehlenden Samples als losgelassen werten
+        if (state == IDLE) return GESTURE_NONE;
+        if (++missedSamples < GESTURE_RELEASE_SAMPLES) return GESTURE_NONE;
+
+        State previous = state;
+        state = IDLE;
+        missedSamples = 0;
+
+        if (previous == DOWN &&
+            lastTouchMs - downMs <= GESTURE_TAP_MAX_MS &&
+            abs(lastX - startX) <= GESTURE_TAP_MAX_MOVE &&
+            abs(lastY - startY) <= GESTURE_TAP_MAX_MOVE) {
+            return GESTURE_TAP;
+        }
+        return GESTURE_NONE;
+    }
+
+    /** true solange eine Berührung verfolgt wird */
+    bool isActive() const { return state != IDLE; }
+
+    int16_t getStartX() const { return startX; }
+    int16_t getStartY() const { return startY; }
+};
+
+#endif // TOUCH_GESTURE_H
@@ -4,6 +4,14 @@
  * ESP32-C3 als Bridge zwischen ESP-NOW Sensoren und CYD Display
  * Empfängt Daten via ESP-NOW und stellt sie über I2C bereit
  * 
+ * Zeit-Synchronisation: Der CYD Master schreibt seine NTP-Zeit per I2C
+ * (Struct 0x04), die Bridge verteilt sie als ESP-NOW Zeit-Beacon an die
+ * Sensoren (Broadcast alle TIME_BEACON_INTERVAL_MS und als Antwort auf
+ * Pakete mit SENSOR_FLAG_TIME_REQUEST).
+ * 
+ * Link-Qualität aller Sensoren (Verlust, RSSI-Perzentile, Jitter,
+ * Wiederholungen) steht alle 5 Sekunden in Struct 0x05.
+ * 
  * Hardware:
  * - ESP32-C3
  * - I2C: GPIO 8 (SDA), GPIO 9 (SCL)
@@ -14,6 +22,8 @@
 #include <esp_now.h>
 #include <esp_wifi.h>
 #include "I2CSensorBridge.h"
+#include "SensorIngest.h"
+#include "FrameRing.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -25,6 +35,14 @@
 #define I2C_SDA_PIN 8                 // GPIO 8 für SDA (nur für Info)
 #define I2C_SCL_PIN 9                 // GPIO 9 für SCL (nur für Info)
 
+// Zeit-Beacon
+#define TIME_BEACON_INTERVAL_MS 10000 // Periodischer Broadcast
+#define TIME_BEACON_MIN_GAP_MS 200    // Mindestabstand bei Antworten auf Zeit-Anfragen
+#define TIME_SYNC_MAX_AGE_SEC 7200    // Ältere Master-Zeit wird nicht mehr verteilt
+
+// Link-Statistik über I2C (Struct 0x05 <= I2C_BRIDGE_BUFFER_SIZE)
+#define LINK_EXPORT_MAX 5             // Sensoren pro Tabelle (Registrierungs-Reihenfolge)
+
 // Debug-Ausgaben
 #define DEBUG_SERIAL 1                // Serielle Debug-Ausgaben
 
@@ -59,48 +77,67 @@ struct SystemStatus {
     unsigned long outdoor_last_seen;  // ms seit letztem Empfang
     uint16_t esp_now_packets;         // Anzahl empfangener Pakete
     uint8_t wifi_channel;
+    uint16_t frames_dropped;          // Verworfen weil Empfangs-Ring voll
 } __attribute__((packed));
 
-// ==================== ESP-NOW EMPFANGS-STRUKTUREN ====================
-
-// Original Sensor-Struktur (wie von ESP8266 gesendet)
-typedef struct sensor_data_indoor_raw {
-    uint32_t timestamp;
-    float temperature;
-    float pressure;
-    float humidity;
-    uint8_t am2321_readings;
-    uint16_t battery_voltage;
-    uint16_t duration;
-    uint8_t battery_warning;
-    uint8_t sensor_error;
-    uint8_t reset_reason;
-    uint8_t sensor_type;
-    uint16_t sleep_time_sec;
-} sensor_data_indoor_raw;
-
-typedef struct sensor_data_outdoor_raw {
-    uint32_t timestamp;
-    float temperature;
-    float pressure;
-    uint16_t battery_voltage;
-    uint16_t duration;
-    uint8_t battery_warning;
-    uint8_t sensor_error;
-    uint8_t reset_reason;
-    uint8_t sensor_type;
-    uint16_t sleep_time_sec;
-} sensor_data_outdoor_raw;
+// Uhrzeit vom Master (wird vom Master geschrieben)
+struct TimeSyncData {
+    uint32_t epoch;         // UTC Sekunden
+    uint16_t epoch_ms;      // Millisekunden-Anteil
+    int16_t utc_offset_min; // Lokalzeit = UTC + Offset (inkl. Sommerzeit)
+    uint8_t valid;          // 1 = NTP-Zeit gültig
+} __attribute__((packed));
+
+// Link-Qualität eines Sensors (Werte sättigen bei 0xFFFF)
+struct LinkStatsEntry {
+    uint8_t mac[3];             // Letzte 3 Bytes der Sender-MAC
+    uint8_t schema;             // 1 = Outdoor, 2 = Indoor (SensorSchema)
+    uint8_t ordinal;            // 0 = primärer Sensor des Schemas
+    int8_t rssi_avg;            // dBm (EWMA)
+    int8_t rssi_p10;            // dBm, schwächste 10%
+    int8_t rssi_p50;
+    int8_t rssi_p90;
+    uint16_t packets;
+    uint16_t lost;              // Per Sequenz erkannte Verluste
+    uint16_t loss_recent_pm;    // Gleitende Verlustrate in Promille
+    uint16_t retries;           // Vom Sender gemeldete Wiederholungen
+    uint16_t jitter_ms;         // Mittlere Abweichung des Paketabstands
+    uint16_t last_seen_sec;     // Sekunden seit dem letzten Paket
+} __attribute__((packed));
+
+struct LinkStatsTable {
+    uint8_t count;              // Gültige Einträge
+    uint8_t total;              // Sensoren in der Geräte-Tabelle der Bridge
+    LinkStatsEntry entries[LINK_EXPORT_MAX];
+} __attribute__((packed));
 
 // ==================== GLOBALE VARIABLEN ====================
 
 // I2C Bridge
 I2CSensorBridge i2cBridge;
 
+// Geräte-Tabelle (Schema, letzter Messwert, Link-Statistik pro Sender-MAC)
+SensorIngest ingest;
+
+// Empfangs-Ring: Callback -> loop() (Arduino Loop-Task als Worker)
+FrameRing<> frameRing;
+TaskHandle_t workerTaskHandle = nullptr;
+
 // Daten-Instanzen
 IndoorData indoorData;
 OutdoorData outdoorData;
 SystemStatus systemStatus;
+TimeSyncData timeSync;
+LinkStatsTable linkStats;
+
+// Zeit-Anker: Master-Zeit zum millis()-Zeitpunkt des I2C-Schreibens
+TimeSyncData timeAnchor;
+unsigned long timeAnchorMs = 0;
+bool timeAnchorValid = false;
+unsigned long lastBeaconSent = 0;
+uint16_t beaconSequence = 0;
+
+const uint8_t BROADCAST_MAC[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
 
 // Timing
 unsigned long lastIndoorReceived = 0;
@@ -109,41 +146,78 @@ uint16_t totalPacketsReceived = 0;
 
 // ==================== ESP-NOW CALLBACK ====================
 
+// Läuft im WiFi-Task: nur kopieren und Worker wecken
 void onDataReceive(const esp_now_recv_info* recv_info, const uint8_t* data, int data_len) {
+    frameRing.push(recv_info->src_addr, data, data_len, recv_info->rx_ctrl->rssi, millis());
+    if (workerTaskHandle) xTaskNotifyGive(workerTaskHandle);
+}
+
+// ==================== WORKER ====================
+
+void processFrame(const RawFrame& frame) {
     // MAC-Adresse des Senders für Debug
     #if DEBUG_SERIAL
     Serial.printf("\n[ESP-NOW] Data received from %02X:%02X:%02X:%02X:%02X:%02X\n",
-                  recv_info->src_addr[0], recv_info->src_addr[1], 
-                  recv_info->src_addr[2], recv_info->src_addr[3],
-                  recv_info->src_addr[4], recv_info->src_addr[5]);
-    Serial.printf("          Size: %d bytes, RSSI: %d dBm\n", 
-                  data_len, recv_info->rx_ctrl->rssi);
+                  frame.mac[0], frame.mac[1], frame.mac[2],
+                  frame.mac[3], frame.mac[4], frame.mac[5]);
+    Serial.printf("          Size: %d bytes, RSSI: %d dBm\n", frame.len, frame.rssi);
     #endif
     
     totalPacketsReceived++;
-    
-    // Indoor oder Outdoor anhand der Größe erkennen
-    bool isIndoor = (data_len >= sizeof(sensor_data_indoor_raw));
-    
-    if (isIndoor) {
-        // Indoor Daten verarbeiten
-        sensor_data_indoor_raw raw;
-        memcpy(&raw, data, min(data_len, (int)sizeof(raw)));
-        
+
+    SensorDevice* dev = ingest.ingest(frame.mac, frame.data, frame.len, frame.rssi, frame.rxMs);
+    if (!dev) {
+        #if DEBUG_SERIAL
+        Serial.println("[INGEST]  Packet dropped (unknown schema or table full)");
+        #endif
+        return;
+    }
+
+    // Zeit-Anfrage sofort beantworten, der Sensor hört nur kurz mit
+    if ((dev->lastFlags & SENSOR_FLAG_TIME_REQUEST) &&
+        millis() - lastBeaconSent >= TIME_BEACON_MIN_GAP_MS) {
+        bool sent = sendTimeBeacon();
+        #if DEBUG_SERIAL
+        Serial.printf("[TIME]    Time request answered: %s\n", sent ? "yes" : "no time available");
+        #endif
+    }
+
+    #if DEBUG_SERIAL
+    // Batch-Paket: über I2C geht nur der aktuelle Wert, der Master loggt selbst
+    uint8_t batchCount = SensorIngest::getBatchCount(*dev, frame.data, frame.len);
+    if (batchCount > 0) {
+        Serial.printf("[INGEST]  Batch with %u buffered samples (not forwarded)\n", batchCount);
+    }
+    #endif
+
+    // Nur der erste Sensor pro Schema wird über I2C bereitgestellt,
+    // weitere Sensoren erscheinen in der Geräte-Tabelle
+    if (dev->ordinal != 0) {
+        #if DEBUG_SERIAL
+        Serial.printf("[INGEST]  %s sensor #%d (%.1f°C) - not mapped to I2C\n",
+                     SensorIngest::getSchemaName(dev->schema), dev->ordinal + 1,
+                     dev->last.temperature);
+        #endif
+        return;
+    }
+
+    const SensorSample& sample = dev->last;
+
+    if (dev->schema == SCHEMA_INDOOR) {
         // In Bridge-Format konvertieren
-        indoorData.temperature = raw.temperature;
-        indoorData.humidity = raw.humidity;
-        indoorData.pressure = raw.pressure;
-        indoorData.battery_mv = raw.battery_voltage;
-        indoorData.timestamp = millis();
-        indoorData.rssi = recv_info->rx_ctrl->rssi;
-        indoorData.battery_warning = raw.battery_warning;
-        indoorData.sleep_time_sec = raw.sleep_time_sec;
+        indoorData.temperature = sample.temperature;
+        indoorData.humidity = sample.humidity;
+        indoorData.pressure = sample.pressure;
+        indoorData.battery_mv = sample.battery_voltage;
+        indoorData.timestamp = frame.rxMs;
+        indoorData.rssi = dev->link.rssi;
+        indoorData.battery_warning = sample.battery_warning;
+        indoorData.sleep_time_sec = sample.sleep_time_sec;
         
         // Via I2C Bridge aktualisieren
         i2cBridge.updateStruct(0x01, indoorData);
 
-        lastIndoorReceived = millis();
+        lastIndoorReceived = frame.rxMs;
 
         #if DEBUG_SERIAL
         Serial.printf("[INDOOR]  Temp: %.1f°C, Hum: %.1f%%, Press: %.0f mbar, Batt: %d mV\n",
@@ -151,24 +225,20 @@ void onDataReceive(const esp_now_recv_info* recv_info, const uint8_t* data, int
                      indoorData.pressure, indoorData.battery_mv);
         #endif
         
-    } else {
-        // Outdoor Daten verarbeiten
-        sensor_data_outdoor_raw raw;
-        memcpy(&raw, data, min(data_len, (int)sizeof(raw)));
-        
+    } else if (dev->schema == SCHEMA_OUTDOOR) {
         // In Bridge-Format konvertieren
-        outdoorData.temperature = raw.temperature;
-        outdoorData.pressure = raw.pressure;
-        outdoorData.battery_mv = raw.battery_voltage;
-        outdoorData.timestamp = millis();
-        outdoorData.rssi = recv_info->rx_ctrl->rssi;
-        outdoorData.battery_warning = raw.battery_warning;
-        outdoorData.sleep_time_sec = raw.sleep_time_sec;
+        outdoorData.temperature = sample.temperature;
+        outdoorData.pressure = sample.pressure;
+        outdoorData.battery_mv = sample.battery_voltage;
+        outdoorData.timestamp = frame.rxMs;
+        outdoorData.rssi = dev->link.rssi;
+        outdoorData.battery_warning = sample.battery_warning;
+        outdoorData.sleep_time_sec = sample.sleep_time_sec;
         
         // Via I2C Bridge aktualisieren
         i2cBridge.updateStruct(0x02, outdoorData);
 
-        lastOutdoorReceived = millis();
+        lastOutdoorReceived = frame.rxMs;
 
         #if DEBUG_SERIAL
         Serial.printf("[OUTDOOR] Temp: %.1f°C, Press: %.0f mbar, Batt: %d mV\n",
@@ -176,11 +246,102 @@ void onDataReceive(const esp_now_recv_info* recv_info, const uint8_t* data, int
                      outdoorData.battery_mv);
         #endif
     }
+    dev->hasNewData = false;
     
     // System Status aktualisieren
     updateSystemStatus();
 }
 
+// Empfangs-Ring abarbeiten; Dekodieren, Serial und I2C-Update laufen im Loop-Task
+void drainFrameRing() {
+    const RawFrame* frame;
+    while ((frame = frameRing.peek()) != nullptr) {
+        processFrame(*frame);
+        frameRing.release();
+    }
+}
+
+// ==================== LINK-STATISTIK ====================
+
+uint16_t saturate16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : value;
+}
+
+// Geräte-Tabelle in Struct 0x05 kopieren (die ersten LINK_EXPORT_MAX Sensoren)
+void updateLinkStats() {
+    unsigned long now = millis();
+
+    memset(&linkStats, 0, sizeof(linkStats));
+    linkStats.total = ingest.getCount();
+    linkStats.count = linkStats.total < LINK_EXPORT_MAX ? linkStats.total : LINK_EXPORT_MAX;
+
+    for (uint8_t i = 0; i < linkStats.count; i++) {
+        const SensorDevice* dev = ingest.getDevice(i);
+        const LinkStats& link = dev->link;
+        LinkStatsEntry& e = linkStats.entries[i];
+
+        memcpy(e.mac, dev->mac + 3, 3);
+        e.schema = dev->schema;
+        e.ordinal = dev->ordinal;
+        e.rssi_avg = link.rssiAvg();
+        e.rssi_p10 = link.rssiPercentile(10);
+        e.rssi_p50 = link.rssiPercentile(50);
+        e.rssi_p90 = link.rssiPercentile(90);
+        e.packets = saturate16(link.packets);
+        e.lost = saturate16(link.lost);
+        e.loss_recent_pm = (uint16_t)(link.lossRecentPct() * 10.0f + 0.5f);
+        e.retries = saturate16(link.retries);
+        e.jitter_ms = saturate16(link.jitterMs);
+        e.last_seen_sec = saturate16((now - link.lastSeen) / 1000);
+    }
+
+    i2cBridge.updateStruct(0x05, linkStats);
+}
+
+// ==================== ZEIT-SYNCHRONISATION ====================
+
+// Neue Master-Zeit übernehmen (Struct 0x04 wurde per I2C geschrieben)
+void applyTimeSync() {
+    // Kopie unter Spinlock: der I2C-Callback kann timeSync jederzeit überschreiben
+    TimeSyncData t;
+    unsigned long writtenMs = 0;
+    if (!i2cBridge.takeWrittenStruct(0x04, t, &writtenMs)) return;
+    if (!t.valid) return;
+
+    timeAnchor = t;
+    timeAnchorMs = writtenMs;
+    timeAnchorValid = true;
+
+    #if DEBUG_SERIAL
+    Serial.printf("[TIME]    Master time %lu.%03u UTC, offset %d min\n",
+                  (unsigned long)t.epoch, t.epoch_ms, t.utc_offset_min);
+    #endif
+}
+
+/**
+ * Aktuelle Zeit als Beacon-Broadcast senden
+ * @return false ohne (frische) Master-Zeit oder bei Sendefehler
+ */
+bool sendTimeBeacon() {
+    if (!timeAnchorValid) return false;
+
+    unsigned long elapsed = millis() - timeAnchorMs;
+    uint32_t ageSec = elapsed / 1000;
+    if (ageSec > TIME_SYNC_MAX_AGE_SEC) return false;
+
+    uint32_t ms = timeAnchor.epoch_ms + elapsed;
+    TimeBeaconV1 beacon;
+    beacon.epoch = timeAnchor.epoch + ms / 1000;
+    beacon.epoch_ms = ms % 1000;
+    beacon.utc_offset_min = timeAnchor.utc_offset_min;
+    beacon.source_age_sec = ageSec > 0xFFFF ? 0xFFFF : ageSec;
+
+    uint8_t buf[sizeof(SensorPacketHeader) + sizeof(TimeBeaconV1)];
+    int len = sensorTimeBeaconBuild(buf, beaconSequence++, beacon);
+    lastBeaconSent = millis();
+    return esp_now_send(BROADCAST_MAC, buf, len) == ESP_OK;
+}
+
 // ==================== HILFSFUNKTIONEN ====================
 
 void updateSystemStatus() {
@@ -194,6 +355,7 @@ void updateSystemStatus() {
 
     systemStatus.esp_now_packets = totalPacketsReceived;
     systemStatus.wifi_channel = ESPNOW_CHANNEL;
+    systemStatus.frames_dropped = frameRing.getDropped();
 
     // Status via I2C aktualisieren
     i2cBridge.updateStruct(0x03, systemStatus);
@@ -234,9 +396,21 @@ void setup() {
         ESP.restart();
     }
 
+    // setup() läuft bereits im Loop-Task, der die Frames verarbeitet
+    workerTaskHandle = xTaskGetCurrentTaskHandle();
+
     // Callback registrieren
     esp_now_register_recv_cb(onDataReceive);
 
+    // Broadcast-Peer für Zeit-Beacons
+    esp_now_peer_info_t peerInfo = {};
+    memcpy(peerInfo.peer_addr, BROADCAST_MAC, 6);
+    peerInfo.channel = ESPNOW_CHANNEL;
+    peerInfo.encrypt = false;
+    if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+        Serial.println("[ERROR] Failed to add broadcast peer (no time beacons)");
+    }
+
     Serial.println("[ESP-NOW] Initialized and listening");
     Serial.flush();
     delay(500);  // Wichtig: WiFi stabilisieren lassen
@@ -257,10 +431,12 @@ void setup() {
     i2cBridge.registerStruct(0x01, &indoorData, 1, "Indoor");
     i2cBridge.registerStruct(0x02, &outdoorData, 1, "Outdoor");
     i2cBridge.registerStruct(0x03, &systemStatus, 1, "Status");
+    i2cBridge.registerStruct(0x04, &timeSync, 1, "TimeSync");
+    i2cBridge.registerStruct(0x05, &linkStats, 1, "LinkStats");
 
     Serial.printf("[I2C]  Slave Address: 0x%02X\n", I2C_SLAVE_ADDRESS);
     Serial.printf("[I2C]  SDA: GPIO %d, SCL: GPIO %d\n", I2C_SDA_PIN, I2C_SCL_PIN);
-    Serial.println("[I2C]  Registered 3 data structures");
+    Serial.println("[I2C]  Registered 5 data structures");
     Serial.flush();
     delay(100);
     
@@ -270,6 +446,8 @@ void setup() {
     memset(&indoorData, 0, sizeof(indoorData));
     memset(&outdoorData, 0, sizeof(outdoorData));
     memset(&systemStatus, 0, sizeof(systemStatus));
+    memset(&timeSync, 0, sizeof(timeSync));
+    memset(&linkStats, 0, sizeof(linkStats));
     
     systemStatus.wifi_channel = ESPNOW_CHANNEL;
     
@@ -288,12 +466,22 @@ void setup() {
 // ==================== MAIN LOOP ====================
 
 void loop() {
+    // Empfangene Frames verarbeiten
+    drainFrameRing();
+
+    // Master-Zeit übernehmen und periodisch an die Sensoren verteilen
+    applyTimeSync();
+    if (timeAnchorValid && millis() - lastBeaconSent >= TIME_BEACON_INTERVAL_MS) {
+        sendTimeBeacon();
+    }
+
     // System Status periodisch aktualisieren
     static unsigned long lastStatusUpdate = 0;
     
     if (millis() - lastStatusUpdate >= 5000) {  // Alle 5 Sekunden
         lastStatusUpdate = millis();
         updateSystemStatus();
+        updateLinkStats();
         
         #if DEBUG_SERIAL
         // Status-Report
@@ -303,6 +491,30 @@ void loop() {
         Serial.printf("Outdoor: last seen %lu ms ago\n",
                      systemStatus.outdoor_last_seen);
         Serial.printf("Total packets: %d\n", systemStatus.esp_now_packets);
+        if (timeAnchorValid) {
+            Serial.printf("Time: master sync %lu s ago, %u beacons sent\n",
+                         (millis() - timeAnchorMs) / 1000, beaconSequence);
+        } else {
+            Serial.println("Time: no master time yet");
+        }
+        Serial.printf("Frame ring: %lu dropped, high water %lu/%lu\n",
+                     (unsigned long)frameRing.getDropped(), (unsigned long)frameRing.getHighWater(),
+                     (unsigned long)frameRing.capacity());
+
+        // Geräte-Tabelle
+        for (uint8_t i = 0; i < ingest.getCount(); i++) {
+            SensorDevice* dev = ingest.getDevice(i);
+            char mac[18];
+            SensorIngest::formatMac(dev->mac, mac);
+            Serial.printf("Sensor %s (%s #%d): %lu pkts, %lu lost (%.1f%% recent), %lu retries, "
+                         "RSSI %d dBm (avg %d, p10/p50/p90 %d/%d/%d), jitter %lu ms, last %lu s ago\n",
+                         mac, SensorIngest::getSchemaName(dev->schema), dev->ordinal + 1,
+                         (unsigned long)dev->link.packets, (unsigned long)dev->link.lost,
+                         dev->link.lossRecentPct(), (unsigned long)dev->link.retries,
+                         dev->link.rssi, dev->link.rssiAvg(), dev->link.rssiPercentile(10),
+                         dev->link.rssiPercentile(50), dev->link.rssiPercentile(90),
+                         (unsigned long)dev->link.jitterMs, (millis() - dev->link.lastSeen) / 1000);
+        }
 
         // I2C Status
         uint8_t i2cStatus = i2cBridge.getStatusByte();
@@ -311,6 +523,6 @@ void loop() {
         #endif
     }
     
-    // Kleine Pause für stabilen Betrieb
-    delay(10);
+    // Warten bis der Callback einen Frame meldet (max. 10ms für den Status-Timer)
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
 }
@@ -0,0 +1,110 @@
+/*
+ * CaptureFormat.h
+ * Mitschnitt roher ESP-NOW Frames (Empfangszeit, MAC, RSSI, Bytes)
+ *
+ * Der Datalogger schreibt mit CAPTURE_ENABLE jeden Frame so, wie er aus dem
+ * FrameRing kommt, vor jeder Dekodierung - also auch Zeit-Beacons, fremde
+ * und defekte Pakete. tools/replay.cpp spielt die Dateien auf dem PC durch
+ * dieselbe Dekodierung (SensorIngest.h), Min/Max (RollingMinMax.h) und
+ * Log-Formatierung (LogRecord.h) wie die Empfänger.
+ *
+ * Datei:  CaptureFileHeaderV1, danach Frames hintereinander
+ * Frame:  CaptureFrameHeaderV1 (12 Bytes) + len Bytes Nutzdaten
+ *
+ * Kein Arduino-Code: wird auch auf dem PC genutzt.
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef CAPTURE_FORMAT_H
+#define CAPTURE_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "FrameRing.h"
+
+// ==================== FORMAT ====================
+
+#define CAPTURE_MAGIC 0x50414345UL      // "ECAP"
+#define CAPTURE_VERSION 1
+
+struct __attribute__((packed)) CaptureFileHeaderV1 {
+    uint32_t magic;             // CAPTURE_MAGIC
+    uint8_t version;            // CAPTURE_VERSION
+    uint8_t frame_header_size;  // sizeof(CaptureFrameHeaderV1)
+    uint16_t frame_max_len;     // FRAME_MAX_LEN des Aufzeichners
+    uint32_t start_ms;          // millis() beim Anlegen
+    uint32_t start_epoch;       // UTC beim Anlegen, 0 = unbekannt
+};
+
+struct __attribute__((packed)) CaptureFrameHeaderV1 {
+    uint32_t rx_ms;             // millis() beim Empfang (Callback)
+    uint8_t mac[6];             // Sender-MAC
+    int8_t rssi;                // dBm
+    uint8_t len;                // Nutzdaten-Länge
+};
+
+static_assert(sizeof(CaptureFileHeaderV1) == 16, "CaptureFileHeaderV1 size");
+static_assert(sizeof(CaptureFrameHeaderV1) == 12, "CaptureFrameHeaderV1 size");
+
+// ==================== HILFSFUNKTIONEN ====================
+
+inline void captureHeaderBuild(CaptureFileHeaderV1& hdr, uint32_t startMs, uint32_t startEpoch) {
+    hdr.magic = CAPTURE_MAGIC;
+    hdr.version = CAPTURE_VERSION;
+    hdr.frame_header_size = sizeof(CaptureFrameHeaderV1);
+    hdr.frame_max_len = FRAME_MAX_LEN;
+    hdr.start_ms = startMs;
+    hdr.start_epoch = startEpoch;
+}
+
+inline bool captureHeaderValid(const CaptureFileHeaderV1& hdr) {
+    return hdr.magic == CAPTURE_MAGIC && hdr.version == CAPTURE_VERSION &&
+           hdr.frame_header_size == sizeof(CaptureFrameHeaderV1);
+}
+
+/** Bytes, die ein Frame im Mitschnitt belegt */
+inline size_t captureFrameSize(const RawFrame& frame) {
+    return sizeof(CaptureFrameHeaderV1) + frame.len;
+}
+
+/**
+ * Frame in den Mitschnitt-Puffer schreiben
+ * @return geschriebene Bytes, 0 wenn out zu klein ist
+ */
+inline size_t captureFrameEncode(const RawFrame& frame, uint8_t* out, size_t outLen) {
+    size_t size = captureFrameSize(frame);
+    if (size > outLen) return 0;
+
+    CaptureFrameHeaderV1 fh;
+    fh.rx_ms = frame.rxMs;
+    memcpy(fh.mac, frame.mac, 6);
+    fh.rssi = frame.rssi;
+    fh.len = frame.len;
+
+    memcpy(out, &fh, sizeof(fh));
+    memcpy(out + sizeof(fh), frame.data, frame.len);
+    return size;
+}
+
+/**
+ * Frame aus dem Mitschnitt lesen
+ * @return verbrauchte Bytes, 0 bei unvollständigem oder ungültigem Frame
+ */
+inline size_t captureFrameDecode(const uint8_t* in, size_t inLen, RawFrame& frame) {
+    if (inLen < sizeof(CaptureFrameHeaderV1)) return 0;
+
+    CaptureFrameHeaderV1 fh;
+    memcpy(&fh, in, sizeof(fh));
+    if (fh.len > FRAME_MAX_LEN || sizeof(fh) + fh.len > inLen) return 0;
+
+    frame.rxMs = fh.rx_ms;
+    memcpy(frame.mac, fh.mac, 6);
+    frame.rssi = fh.rssi;
+    frame.len = fh.len;
+    memcpy(frame.data, in + sizeof(fh), fh.len);
+    return sizeof(fh) + fh.len;
+}
+
+#endif // CAPTURE_FORMAT_H
@@ -10,12 +10,21 @@
  *
  * Features:
  * - Empfängt ESP-NOW Daten von Indoor/Outdoor Sensoren
- * - Speichert alle Daten als CSV auf SD-Karte
+ * - Speichert alle Daten auf SD-Karte in rotierenden Segmenten (LogSegments.h)
+ *   /logs/indoor_NNNNN.csv, /logs/outdoor_NNNNN.csv, Index in /logs/index.csv
+ *   (weitere Sensoren je Schema als sensor_XXXXXX_NNNNN, letzte 3 MAC-Bytes)
+ * - Optional kompaktes Binärformat (LOG_FORMAT_BINARY, LogRecord.h),
+ *   Umwandlung nach CSV mit tools/logdump.cpp
+ * - Optional Mitschnitt aller rohen ESP-NOW Frames (CAPTURE_ENABLE,
+ *   CaptureFormat.h) zum Nachspielen auf dem PC mit tools/replay.cpp
+ * - Date/Time Spalten in Lokalzeit, sobald die Uhrzeit bekannt ist
+ *   (Messzeitpunkt vom Sensor oder Zeit-Beacon der Bridge)
  * - OLED zeigt: Indoor/Outdoor Datensatz-Counter
  * - RGB LED Status:
  *   - BLAU:   Keine Daten von beiden Sensoren
  *   - AUS:    Normalbetrieb (Daten OK)
- *   - ROT:    Timeout erkannt
+ *   - ROT:    Sensor verloren (siehe Freshness.h)
+ * - Display/LED nur bei Paket oder Zustandswechsel fresh/late/lost
  */
 
 #include <WiFi.h>
@@ -23,9 +32,15 @@
 #include <esp_wifi.h>
 #include <SD.h>
 #include <SPI.h>
+#include <time.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_NeoPixel.h>
+#include "SensorIngest.h"
+#include "FrameRing.h"
+#include "Freshness.h"
+#include "LogSegments.h"
+#include "CaptureFormat.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -48,44 +63,22 @@
 #define OLED_RESET -1
 #define SCREEN_ADDRESS 0x3C
 
-// CSV Dateien
-#define INDOOR_CSV_FILE  "/indoor_log.csv"
-#define OUTDOOR_CSV_FILE "/outdoor_log.csv"
+// Log-Segmente (Rotation, Puffer, Index: siehe LogSegments.h)
+#define LOG_FORMAT_BINARY 0     // 1 = 26-Byte Datensätze (.bin) statt CSV
 
-// Timeout (2.1 × Sleep-Zeit, wie im Master)
-#define TIMEOUT_MULTIPLIER 2.1
+// Mitschnitt roher Frames für tools/replay.cpp (CaptureFormat.h)
+#define CAPTURE_ENABLE 0
+#define CAPTURE_DIR "/capture"
+#define CAPTURE_MAX_BYTES (4UL * 1024UL * 1024UL)   // Danach neue Datei
+#define INDOOR_STREAM  "indoor"
+#define OUTDOOR_STREAM "outdoor"
+
+// Serielle Statuszeile
+#define STATUS_INTERVAL 5000
 
 // ==================== DATENSTRUKTUREN ====================
 
-// Indoor Sensor (mit Luftfeuchtigkeit)
-typedef struct sensor_data_indoor {
-    uint32_t timestamp;
-    float temperature;
-    float pressure;
-    float humidity;
-    uint8_t am2321_readings;
-    uint16_t battery_voltage;
-    uint16_t duration;
-    uint8_t battery_warning;
-    uint8_t sensor_error;
-    uint8_t reset_reason;
-    uint8_t sensor_type;
-    uint16_t sleep_time_sec;
-} sensor_data_indoor;
-
-// Outdoor Sensor (ohne Luftfeuchtigkeit)
-typedef struct sensor_data_outdoor {
-    uint32_t timestamp;
-    float temperature;
-    float pressure;
-    uint16_t battery_voltage;
-    uint16_t duration;
-    uint8_t battery_warning;
-    uint8_t sensor_error;
-    uint8_t reset_reason;
-    uint8_t sensor_type;
-    uint16_t sleep_time_sec;
-} sensor_data_outdoor;
+// Pakete, Schemas und Geräte-Tabelle: siehe SensorIngest.h
 
 // ==================== GLOBALE VARIABLEN ====================
 
@@ -93,20 +86,47 @@ typedef struct sensor_data_outdoor {
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 Adafruit_NeoPixel pixel(RGB_COUNT, RGB_PIN, NEO_GRB + NEO_KHZ800);
 
-// Daten
-sensor_data_indoor indoorData;
-sensor_data_outdoor outdoorData;
+// Geräte-Tabelle (pro Sender-MAC)
+SensorIngest ingest;
+
+// Empfangs-Ring: Callback -> loop() (Arduino Loop-Task als Worker)
+FrameRing<> frameRing;
+TaskHandle_t workerTaskHandle = nullptr;
+
+// Daten der primären Sensoren (erster Sensor je Schema)
+SensorSample indoorData;
+SensorSample outdoorData;
 
 // Status
 bool indoorReceived = false;
 bool outdoorReceived = false;
 unsigned long lastIndoorTime = 0;
 unsigned long lastOutdoorTime = 0;
+SensorFreshness indoorFreshness;   // fresh/late/lost aus den Paketabständen
+SensorFreshness outdoorFreshness;
 uint32_t indoorCount = 0;
 uint32_t outdoorCount = 0;
 
 // SD-Karte
 bool sdCardOK = false;
+LogSegmentWriter logWriter;
+
+#if CAPTURE_ENABLE
+// Mitschnitt: eigener Block-Puffer, geschrieben wie die Log-Segmente
+uint8_t captureBlock[LOG_BLOCK_SIZE];
+uint16_t captureFill = 0;
+unsigned long capturePendingSince = 0;
+uint32_t captureBytes = 0;
+uint32_t captureFile = 0;           // Laufende Nummer von /capture/cap_NNNNN.ecap
+uint32_t capturedFrames = 0;
+bool captureReady = false;
+#endif
+
+// Uhrzeit aus den Zeit-Beacons der Bridge
+uint32_t clockEpoch = 0;           // UTC beim letzten Beacon (0 = unbekannt)
+uint16_t clockEpochMs = 0;
+int16_t clockOffsetMin = 0;        // Lokalzeit = UTC + Offset
+unsigned long clockAnchorMs = 0;   // millis() beim Empfang des Beacons
 
 // RGB LED Farben
 #define COLOR_OFF     pixel.Color(0, 0, 0)
@@ -116,22 +136,55 @@ bool sdCardOK = false;
 
 // ==================== ESP-NOW CALLBACK ====================
 
+// Läuft im WiFi-Task: nur kopieren und loop() wecken
 void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int data_len) {
-    unsigned long now = millis();
+    frameRing.push(recv_info->src_addr, data, data_len, recv_info->rx_ctrl->rssi, millis());
+    if (workerTaskHandle) xTaskNotifyGive(workerTaskHandle);
+}
+
+// Dekodierung und Weiterverarbeitung im Loop-Task
+void processFrame(const RawFrame& frame) {
+    unsigned long now = frame.rxMs;
+
+    // Zeit-Beacon der Bridge: nur Uhr stellen, kein Messwert
+    TimeBeaconV1 beacon;
+    if (sensorTimeBeaconParse(frame.data, frame.len, beacon)) {
+        if (clockEpoch == 0) {
+            Serial.printf("[TIME] Clock set from beacon: %lu UTC, offset %d min\n",
+                         (unsigned long)beacon.epoch, beacon.utc_offset_min);
+        }
+        clockEpoch = beacon.epoch;
+        clockEpochMs = beacon.epoch_ms;
+        clockOffsetMin = beacon.utc_offset_min;
+        clockAnchorMs = now;
+        return;
+    }
 
-    // Indoor oder Outdoor anhand der Größe erkennen
-    bool isIndoor = (data_len >= sizeof(sensor_data_indoor));
+    SensorDevice* dev = ingest.ingest(frame.mac, frame.data, frame.len, frame.rssi, now);
+    if (!dev) {
+        Serial.println("[INGEST] Packet dropped (unknown schema or table full)");
+        return;
+    }
+    dev->hasNewData = false;
 
-    if (isIndoor) {
+    if (dev->ordinal != 0) {
+        // Weiterer Sensor: eigene Datei, Zähler und Status nur für die primären
+        logExtraSensor(*dev, frame);
+        return;
+    }
+
+    if (dev->schema == SCHEMA_INDOOR) {
         // Indoor Daten
-        memcpy(&indoorData, data, min((int)sizeof(indoorData), data_len));
+        indoorData = dev->last;
 
         indoorReceived = true;
         lastIndoorTime = now;
+        indoorFreshness.arrival(now, indoorData.sleep_time_sec);
         indoorCount++;
 
-        // Auf SD-Karte speichern
-        logIndoorData();
+        // Auf SD-Karte speichern (gepufferte Batch-Werte zuerst)
+        logBatchSamples(*dev, frame, INDOOR_STREAM);
+        logSample(INDOOR_STREAM, SCHEMA_INDOOR, indoorData, now, false);
 
         Serial.println("\n=== Indoor Data ===");
         Serial.printf("Temp: %.1f°C, Hum: %.1f%%, Press: %.1f mbar\n",
@@ -139,16 +192,18 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
         Serial.printf("Battery: %d mV, Count: %lu\n",
                      indoorData.battery_voltage, indoorCount);
 
-    } else {
+    } else if (dev->schema == SCHEMA_OUTDOOR) {
         // Outdoor Daten
-        memcpy(&outdoorData, data, min((int)sizeof(outdoorData), data_len));
+        outdoorData = dev->last;
 
         outdoorReceived = true;
         lastOutdoorTime = now;
+        outdoorFreshness.arrival(now, outdoorData.sleep_time_sec);
         outdoorCount++;
 
-        // Auf SD-Karte speichern
-        logOutdoorData();
+        // Auf SD-Karte speichern (gepufferte Batch-Werte zuerst)
+        logBatchSamples(*dev, frame, OUTDOOR_STREAM);
+        logSample(OUTDOOR_STREAM, SCHEMA_OUTDOOR, outdoorData, now, false);
 
         Serial.println("\n=== Outdoor Data ===");
         Serial.printf("Temp: %.1f°C, Press: %.1f mbar\n",
@@ -164,6 +219,17 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
     updateLED();
 }
 
+void drainFrameRing() {
+    const RawFrame* frame;
+    while ((frame = frameRing.peek()) != nullptr) {
+#if CAPTURE_ENABLE
+        captureFrame(*frame);
+#endif
+        processFrame(*frame);
+        frameRing.release();
+    }
+}
+
 // ==================== SD-KARTE FUNKTIONEN ====================
 
 bool initSDCard() {
@@ -196,96 +262,143 @@ bool initSDCard() {
     uint64_t cardSize = SD.cardSize() / (1024 * 1024);
     Serial.printf("[SD] Size: %lluMB\n", cardSize);
 
-    // CSV Header erstellen falls Dateien nicht existieren
-    createCSVHeaders();
+    // Log-Verzeichnis und Segment-Index
+    if (!logWriter.begin(SD, LOG_FORMAT_BINARY)) {
+        Serial.println("[SD] Log directory not writable");
+        return false;
+    }
+    Serial.printf("[SD] Logging to " LOG_DIR " (%s, max %lu KB per segment)\n",
+                 LOG_FORMAT_BINARY ? "binary" : "CSV", LOG_SEGMENT_MAX_BYTES / 1024);
 
     return true;
 }
 
-void createCSVHeaders() {
-    // Indoor CSV Header
-    if (!SD.exists(INDOOR_CSV_FILE)) {
-        File file = SD.open(INDOOR_CSV_FILE, FILE_WRITE);
-        if (file) {
-            file.println("Timestamp,Date,Time,Temperature,Humidity,Pressure,Battery_mV,Battery_Warning,RSSI,Sleep_Sec,Duration_ms,Error,Reset_Reason");
-            file.close();
-            Serial.println("[SD] Indoor CSV header created");
-        }
-    }
+// UTC-Sekunden zum Receiver-millis() ms, 0 solange kein Beacon empfangen wurde
+uint32_t wallClock(unsigned long ms) {
+    if (clockEpoch == 0) return 0;
+    long diff = (long)(ms - clockAnchorMs);   // Batch-Werte liegen vor dem Anker
+    int64_t t = (int64_t)clockEpoch * 1000 + clockEpochMs + diff;
+    return (uint32_t)(t / 1000);
+}
 
-    // Outdoor CSV Header
-    if (!SD.exists(OUTDOOR_CSV_FILE)) {
-        File file = SD.open(OUTDOOR_CSV_FILE, FILE_WRITE);
-        if (file) {
-            file.println("Timestamp,Date,Time,Temperature,Pressure,Battery_mV,Battery_Warning,RSSI,Sleep_Sec,Duration_ms,Error,Reset_Reason");
-            file.close();
-            Serial.println("[SD] Outdoor CSV header created");
-        }
+// Batch-Paket: gepufferte Messwerte mit ihrem ursprünglichen Messzeitpunkt loggen
+void logBatchSamples(const SensorDevice& dev, const RawFrame& frame, const char* stream) {
+    uint8_t count = SensorIngest::getBatchCount(dev, frame.data, frame.len);
+    if (count == 0) return;
+
+    Serial.printf("[SD] Batch: %u buffered samples\n", count);
+
+    SensorSample sample;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!SensorIngest::getBatchSample(dev, frame.data, frame.len, i, sample)) break;
+        unsigned long ts = frame.rxMs - sample.age_sec * 1000UL;
+        logSample(stream, dev.schema, sample, ts, true);
     }
 }
 
-void logIndoorData() {
+// Zusätzliche Sensoren: gleiche Spalten wie der primäre Sensor des Schemas
+void logExtraSensor(const SensorDevice& dev, const RawFrame& frame) {
     if (!sdCardOK) return;
 
-    File file = SD.open(INDOOR_CSV_FILE, FILE_APPEND);
-    if (!file) {
-        Serial.println("[SD] Failed to open indoor log");
+    char stream[LOG_STREAM_NAME_LEN];
+    snprintf(stream, sizeof(stream), "sensor_%02X%02X%02X", dev.mac[3], dev.mac[4], dev.mac[5]);
+
+    logBatchSamples(dev, frame, stream);
+    logSample(stream, dev.schema, dev.last, frame.rxMs, false);
+}
+
+/**
+ * Messwert an den Strom anhängen (gepuffert, siehe LogSegments.h)
+ * @param ts Messzeitpunkt in Receiver-millis() (bei Batch-Werten vor dem Empfang)
+ */
+void logSample(const char* stream, uint8_t schema, const SensorSample& data,
+               unsigned long ts, bool batch) {
+    if (!sdCardOK) return;
+
+    // Timestamp bleibt Receiver-millis(); Date/Time vom Sensor, sonst aus dem Beacon
+    LogRecordV1 rec;
+    logRecordFromSample(rec, data, schema, ts, data.epoch ? data.epoch : wallClock(ts), batch);
+
+    if (!logWriter.append(stream, rec, clockOffsetMin, millis())) {
+        Serial.printf("[SD] Failed to log %s\n", stream);
         return;
     }
 
-    // Timestamp (Unix-Zeit wäre besser, aber wir haben nur millis())
-    unsigned long ts = millis();
-
-    // CSV Zeile: Timestamp,Date,Time,Temp,Hum,Press,Batt,Warning,RSSI,Sleep,Duration,Error,Reset
-    char line[256];
-    snprintf(line, sizeof(line), "%lu,,,%.2f,%.2f,%.2f,%u,%u,,%u,%u,%u,%u",
-             ts,
-             indoorData.temperature,
-             indoorData.humidity,
-             indoorData.pressure,
-             indoorData.battery_voltage,
-             indoorData.battery_warning,
-             indoorData.sleep_time_sec,
-             indoorData.duration,
-             indoorData.sensor_error,
-             indoorData.reset_reason);
-
-    file.println(line);
-    file.close();
+    char line[160];
+    logRecordToCsv(rec, clockOffsetMin, line, sizeof(line));
+    Serial.printf("[SD] %s buffered: %s\n", stream, line);
+}
+
+// ==================== MITSCHNITT ====================
 
-    Serial.printf("[SD] Indoor logged: %s\n", line);
+#if CAPTURE_ENABLE
+void capturePath(uint32_t number, char* out, size_t len) {
+    snprintf(out, len, CAPTURE_DIR "/cap_%05lu.ecap", (unsigned long)number);
 }
 
-void logOutdoorData() {
-    if (!sdCardOK) return;
+// Neue Mitschnitt-Datei unter der nächsten freien Nummer anlegen
+bool captureOpen() {
+    char path[LOG_PATH_LEN];
+    if (!SD.exists(CAPTURE_DIR)) SD.mkdir(CAPTURE_DIR);
+
+    do {
+        capturePath(captureFile, path, sizeof(path));
+        if (!SD.exists(path)) break;
+        captureFile++;
+    } while (true);
 
-    File file = SD.open(OUTDOOR_CSV_FILE, FILE_APPEND);
+    File file = SD.open(path, FILE_WRITE);
     if (!file) {
-        Serial.println("[SD] Failed to open outdoor log");
-        return;
+        Serial.printf("[CAPTURE] Failed to create %s\n", path);
+        return false;
     }
 
-    // Timestamp
-    unsigned long ts = millis();
-
-    // CSV Zeile: Timestamp,Date,Time,Temp,Press,Batt,Warning,RSSI,Sleep,Duration,Error,Reset
-    char line[256];
-    snprintf(line, sizeof(line), "%lu,,,%.2f,%.2f,%u,%u,,%u,%u,%u,%u",
-             ts,
-             outdoorData.temperature,
-             outdoorData.pressure,
-             outdoorData.battery_voltage,
-             outdoorData.battery_warning,
-             outdoorData.sleep_time_sec,
-             outdoorData.duration,
-             outdoorData.sensor_error,
-             outdoorData.reset_reason);
-
-    file.println(line);
+    CaptureFileHeaderV1 hdr;
+    captureHeaderBuild(hdr, millis(), wallClock(millis()));
+    file.write((const uint8_t*)&hdr, sizeof(hdr));
     file.close();
 
-    Serial.printf("[SD] Outdoor logged: %s\n", line);
+    captureBytes = sizeof(hdr);
+    Serial.printf("[CAPTURE] Recording raw frames to %s\n", path);
+    return true;
+}
+
+void captureFlush() {
+    if (captureFill == 0) return;
+
+    char path[LOG_PATH_LEN];
+    capturePath(captureFile, path, sizeof(path));
+
+    File file = SD.open(path, FILE_APPEND);
+    if (!file || file.write(captureBlock, captureFill) != captureFill) {
+        Serial.printf("[CAPTURE] Block write failed: %s\n", path);
+    }
+    if (file) file.close();
+    captureFill = 0;
+}
+
+// Roh-Frame vor jeder Dekodierung mitschneiden
+void captureFrame(const RawFrame& frame) {
+    if (!sdCardOK) return;
+    if (!captureReady) {
+        captureReady = captureOpen();
+        if (!captureReady) return;
+    }
+
+    size_t size = captureFrameSize(frame);
+    if (captureBytes + size > CAPTURE_MAX_BYTES) {
+        captureFlush();
+        captureFile++;
+        if (!(captureReady = captureOpen())) return;
+    }
+    if (captureFill + size > LOG_BLOCK_SIZE) captureFlush();
+    if (captureFill == 0) capturePendingSince = millis();
+
+    captureFill += captureFrameEncode(frame, captureBlock + captureFill, LOG_BLOCK_SIZE - captureFill);
+    captureBytes += size;
+    capturedFrames++;
 }
+#endif
 
 // ==================== DISPLAY FUNKTIONEN ====================
 
@@ -314,12 +427,15 @@ void updateDisplay() {
         display.print("SD:ERR");
     }
 
-    // Zeile 4: Timeout Status
+    // Zeile 4: Aktualität
     display.setCursor(0, 30);
+    FreshnessState freshness = worstFreshness();
     if (!indoorReceived && !outdoorReceived) {
         display.print("WAIT");
-    } else if (checkTimeout()) {
+    } else if (freshness == FRESHNESS_LOST) {
         display.print("TIMEOUT!");
+    } else if (freshness == FRESHNESS_LATE) {
+        display.print("LATE");
     } else {
         display.print("OK");
     }
@@ -337,8 +453,8 @@ void updateLED() {
         return;
     }
 
-    // ROT: Timeout
-    if (checkTimeout()) {
+    // ROT: Sensor verloren
+    if (worstFreshness() == FRESHNESS_LOST) {
         pixel.setPixelColor(0, COLOR_RED);
         pixel.show();
         return;
@@ -349,31 +465,14 @@ void updateLED() {
     pixel.show();
 }
 
-// ==================== TIMEOUT-ERKENNUNG ====================
+// ==================== AKTUALITÄT ====================
 
-bool checkTimeout() {
+// Schlechtester Zustand beider Sensoren (NONE < FRESH < LATE < LOST)
+FreshnessState worstFreshness() {
     unsigned long now = millis();
-    bool timeout = false;
-
-    // Indoor Timeout prüfen
-    if (indoorReceived) {
-        unsigned long timeSince = (now - lastIndoorTime) / 1000; // Sekunden
-        uint16_t timeoutSec = indoorData.sleep_time_sec * TIMEOUT_MULTIPLIER;
-        if (timeSince > timeoutSec) {
-            timeout = true;
-        }
-    }
-
-    // Outdoor Timeout prüfen
-    if (outdoorReceived) {
-        unsigned long timeSince = (now - lastOutdoorTime) / 1000; // Sekunden
-        uint16_t timeoutSec = outdoorData.sleep_time_sec * TIMEOUT_MULTIPLIER;
-        if (timeSince > timeoutSec) {
-            timeout = true;
-        }
-    }
-
-    return timeout;
+    FreshnessState in = indoorFreshness.state(now);
+    FreshnessState out = outdoorFreshness.state(now);
+    return in > out ? in : out;
 }
 
 // ==================== SETUP ====================
@@ -449,6 +548,9 @@ void setup() {
         while (1);
     }
 
+    // setup() läuft bereits im Loop-Task, der die Frames verarbeitet
+    workerTaskHandle = xTaskGetCurrentTaskHandle();
+
     esp_now_register_recv_cb(onDataRecv);
     Serial.println("[ESP-NOW] Initialized");
 
@@ -467,18 +569,56 @@ void setup() {
 // ==================== MAIN LOOP ====================
 
 void loop() {
-    // Periodisch Display & LED aktualisieren
-    static unsigned long lastUpdate = 0;
-
-    if (millis() - lastUpdate >= 5000) { // Alle 5 Sekunden
-        lastUpdate = millis();
+    // Empfangene Frames verarbeiten
+    drainFrameRing();
+
+    // Display & LED nur bei Zustandswechsel (Pakete zeichnen in processFrame)
+    static FreshnessState shownFreshness = FRESHNESS_NONE;
+    FreshnessState freshness = worstFreshness();
+    if (freshness != shownFreshness) {
+        shownFreshness = freshness;
         updateDisplay();
         updateLED();
+        Serial.printf("[FRESH] Indoor: %s, Outdoor: %s\n",
+                     SensorFreshness::stateName(indoorFreshness.state(millis())),
+                     SensorFreshness::stateName(outdoorFreshness.state(millis())));
+    }
+
+    static unsigned long lastStatus = 0;
+
+    if (millis() - lastStatus >= STATUS_INTERVAL) {
+        lastStatus = millis();
+
+        // Gepufferte Log-Blöcke nach LOG_FLUSH_INTERVAL_MS schreiben
+        logWriter.poll(lastStatus);
+#if CAPTURE_ENABLE
+        if (captureFill > 0 && lastStatus - capturePendingSince >= LOG_FLUSH_INTERVAL_MS) {
+            captureFlush();
+        }
+#endif
 
         // Debug-Ausgabe
-        Serial.printf("[Status] Indoor: %lu, Outdoor: %lu, SD: %s\n",
-                     indoorCount, outdoorCount, sdCardOK ? "OK" : "ERROR");
+        Serial.printf("[Status] Indoor: %lu, Outdoor: %lu, SD: %s, Ring dropped: %lu (max %lu/%lu)\n",
+                     indoorCount, outdoorCount, sdCardOK ? "OK" : "ERROR",
+                     (unsigned long)frameRing.getDropped(), (unsigned long)frameRing.getHighWater(),
+                     (unsigned long)frameRing.capacity());
+        Serial.printf("[SD] Blocks: %lu, Segments: %lu, Pending: %lu B, Errors: %lu, Dropped: %lu B\n",
+                     (unsigned long)logWriter.getBlocksWritten(),
+                     (unsigned long)logWriter.getSegmentsCreated(),
+                     (unsigned long)logWriter.getPending(),
+                     (unsigned long)logWriter.getWriteErrors(),
+                     (unsigned long)logWriter.getBytesDropped());
+#if CAPTURE_ENABLE
+        Serial.printf("[CAPTURE] Frames: %lu, File: %lu, Bytes: %lu\n",
+                     (unsigned long)capturedFrames, (unsigned long)captureFile,
+                     (unsigned long)captureBytes);
+#endif
     }
 
-    delay(100);
+    // Schlafen bis Frame, nächster Zustandswechsel oder Statuszeile
+    unsigned long now = millis();
+    unsigned long wait = STATUS_INTERVAL - min(now - lastStatus, (unsigned long)STATUS_INTERVAL);
+    wait = freshnessSooner(wait, indoorFreshness.nextChange(now));
+    wait = freshnessSooner(wait, outdoorFreshness.nextChange(now));
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait + 1));
 }
@@ -0,0 +1,110 @@
+/*
+ * FrameRing.h
+ * Lock-freier Single-Producer/Single-Consumer Ringpuffer für ESP-NOW Frames
+ *
+ * Der Receive-Callback läuft im WiFi-Task und darf nicht blockieren.
+ * Er kopiert nur den Rohframe samt MAC, RSSI und Zeitstempel in den Ring
+ * (push) und kehrt sofort zurück. Ein Worker-Task holt die Frames ab
+ * (peek/release) und übernimmt Dekodierung, Logging und Anzeige.
+ *
+ * Producer: nur der WiFi-Callback schreibt head
+ * Consumer: nur der Worker-Task schreibt tail
+ * Ist der Ring voll, wird der neue Frame verworfen und gezählt.
+ *
+ * Identische Kopie in: ESP32-C3_Bridge_Slave, ESP32_C3_Datalogger,
+ * CYD_ESP_NOW_Receiver, ESP_NOW_Receiver_ESP32
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// ==================== KONFIGURATION ====================
+
+#define FRAME_MAX_LEN 250               // ESP-NOW Maximum (ESP_NOW_MAX_DATA_LEN)
+#define FRAME_RING_SLOTS 16             // Zweierpotenz; 16 x 264 Bytes
+
+// ==================== DATENSTRUKTUREN ====================
+
+struct RawFrame {
+    uint8_t mac[6];             // Sender-MAC
+    int8_t rssi;                // dBm
+    uint8_t len;                // Nutzdaten-Länge
+    uint32_t rxMs;              // millis() beim Empfang
+    uint8_t data[FRAME_MAX_LEN];
+};
+
+// ==================== HAUPT-KLASSE ====================
+
+template <uint32_t SLOTS = FRAME_RING_SLOTS>
+class FrameRing {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "FrameRing size must be a power of two");
+
+private:
+    RawFrame slots[SLOTS];
+    std::atomic<uint32_t> head;     // Nächster Schreib-Index (Producer)
+    std::atomic<uint32_t> tail;     // Nächster Lese-Index (Consumer)
+    std::atomic<uint32_t> dropped;  // Verworfen weil voll
+    uint32_t highWater;             // Max. Füllstand (nur Producer)
+
+public:
+    FrameRing() : head(0), tail(0), dropped(0), highWater(0) {}
+
+    /**
+     * Frame einreihen (nur aus dem Receive-Callback)
+     * @return false wenn der Ring voll ist oder der Frame zu lang
+     */
+    bool push(const uint8_t* mac, const uint8_t* data, int len, int8_t rssi, uint32_t rxMs) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+
+        if (h - t >= SLOTS || len < 0 || len > FRAME_MAX_LEN) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        RawFrame& f = slots[h & (SLOTS - 1)];
+        memcpy(f.mac, mac, 6);
+        memcpy(f.data, data, len);
+        f.len = (uint8_t)len;
+        f.rssi = rssi;
+        f.rxMs = rxMs;
+
+        // Frame erst nach dem Kopieren sichtbar machen
+        head.store(h + 1, std::memory_order_release);
+
+        if (h + 1 - t > highWater) highWater = h + 1 - t;
+        return true;
+    }
+
+    /**
+     * Ältesten Frame ansehen ohne zu kopieren (nur Worker-Task)
+     * @return nullptr wenn leer; nach der Verarbeitung release() aufrufen
+     */
+    const RawFrame* peek() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return nullptr;
+        return &slots[t & (SLOTS - 1)];
+    }
+
+    /**
+     * Mit peek() geholten Frame freigeben
+     */
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint32_t getPending() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+    uint32_t getHighWater() const { return highWater; }
+    static constexpr uint32_t capacity() { return SLOTS; }
+};
+
+#endif // FRAME_RING_H
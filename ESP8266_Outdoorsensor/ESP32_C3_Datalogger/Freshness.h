@@ -0,0 +1,194 @@
+/*
+ * Freshness.h
+ * Aktualität eines Sensors aus seinen tatsächlichen Paketabständen
+ *
+ * Ersetzt die feste Regel "gültig bis 2.1 x sleep_time_sec". Pro Sensor
+ * wird gelernt, wie der tatsächliche Abstand zweier Pakete zur angekündigten
+ * Sleep-Periode steht (Verhältnis, EWMA von Mittel und mittlerer Abweichung).
+ * Das Verhältnis deckt Wachzeit, Gang des Deep-Sleep-Timers und BATCH_MODE
+ * (Funk nur jeden n-ten Wake) ab. Daraus:
+ * - erwarteter nächster Empfang
+ * - FRESHNESS_FRESH bis erwartet + Toleranz
+ * - FRESHNESS_LATE danach
+ * - FRESHNESS_LOST wenn auch das übernächste Paket ausgeblieben ist
+ * - nextChange(): ms bis zum nächsten Zustandswechsel, als Weckzeit für
+ *   Display/LED statt periodischem Polling
+ *
+ * Der erste Abstand ersetzt den Startwert 1.0 (ein BATCH_MODE Sensor meldet
+ * nur ein Viertel seines echten Abstands), danach laufender Mittelwert.
+ * Abstände über FRESHNESS_GAP_RATIO x erwartet werden nicht gelernt: sie
+ * enthalten verlorene Pakete - schon ein einzelnes verlorenes Paket endet
+ * nur in LATE und würde die Toleranz sonst Schritt für Schritt aufweiten.
+ * Folgen FRESHNESS_RELEARN_GAPS solche Abstände aufeinander, hat sich das
+ * Muster geändert (z.B. Batch-Betrieb eingeschaltet) und das Lernen beginnt
+ * neu.
+ *
+ * Alle Zeiten in Receiver-millis(), Überlauf-sicher über Differenzen.
+ *
+ * Identische Kopie in: CYD_I2C_Master, CYD_ESP_NOW_Receiver, ESP32_C3_Datalogger
+ *
+ * Version: 1.2.0
+ */
+
+#ifndef FRESHNESS_H
+#define FRESHNESS_H
+
+#include <stdint.h>
+
+// ==================== KONFIGURATION ====================
+
+#define FRESHNESS_LEARN_SHIFT 3         // Lernrate 1/8 pro Paket
+#define FRESHNESS_TOLERANCE_DEV 4.0f    // Toleranz = 4 x mittlere Abweichung x Periode
+#define FRESHNESS_MIN_SLACK_MS 5000     // Mindesttoleranz (Empfangs- und Poll-Latenz)
+#define FRESHNESS_DEFAULT_PERIOD 60     // Sekunden, falls der Sensor keine Periode meldet
+#define FRESHNESS_GAP_RATIO 1.5f        // Längere Abstände (x erwartet) nicht lernen
+#define FRESHNESS_RELEARN_GAPS 3        // Solche Abstände in Folge bis zum Neulernen
+
+#define FRESHNESS_NEVER 0xFFFFFFFFUL    // nextChange(): kein weiterer Wechsel
+
+enum FreshnessState : uint8_t {
+    FRESHNESS_NONE = 0,         // Noch kein Paket
+    FRESHNESS_FRESH,            // Im erwarteten Rahmen
+    FRESHNESS_LATE,             // Nächstes Paket überfällig, Werte noch brauchbar
+    FRESHNESS_LOST              // Mindestens zwei Pakete ausgeblieben
+};
+
+// ==================== HAUPT-KLASSE ====================
+
+class SensorFreshness {
+private:
+    bool seen;
+    unsigned long lastMs;       // Letzter Empfang
+    uint32_t periodMs;          // Angekündigte Periode des letzten Pakets
+    float ratio;                // Gelernter Abstand / angekündigte Periode
+    float deviation;            // Mittlere |Abweichung| des Verhältnisses
+    uint32_t learned;           // Gelernte Abstände
+    uint8_t gapStreak;          // Abstände in Folge über FRESHNESS_GAP_RATIO
+    uint32_t lateAfterMs;       // Ab hier LATE (relativ zu lastMs)
+    uint32_t lostAfterMs;       // Ab hier LOST
+
+    void updateDeadlines() {
+        float expected = periodMs * ratio;
+        float slack = periodMs * FRESHNESS_TOLERANCE_DEV * deviation;
+        if (slack < FRESHNESS_MIN_SLACK_MS) slack = FRESHNESS_MIN_SLACK_MS;
+
+        lateAfterMs = (uint32_t)(expected + slack);
+        lostAfterMs = (uint32_t)(2.0f * expected + slack);
+    }
+
+public:
+    SensorFreshness() {
+        reset();
+    }
+
+    void reset() {
+        seen = false;
+        lastMs = 0;
+        periodMs = FRESHNESS_DEFAULT_PERIOD * 1000UL;
+        ratio = 1.0f;
+        deviation = 0.05f;
+        learned = 0;
+        gapStreak = 0;
+        updateDeadlines();
+    }
+
+    /**
+     * Paket empfangen
+     * @param nowMs millis() beim Empfang
+     * @param periodSec vom Sensor angekündigte Sleep-Periode (sleep_time_sec)
+     */
+    void arrival(unsigned long nowMs, uint16_t periodSec) {
+        // Abstand gegen die Periode, die das vorherige Paket angekündigt hat
+        float r = seen ? (float)(uint32_t)(nowMs - lastMs) / periodMs : 0;
+
+        if (seen && learned > 0) {
+            if (r > ratio * FRESHNESS_GAP_RATIO) {
+                if (++gapStreak >= FRESHNESS_RELEARN_GAPS) {
+                    learned = 0;
+                }
+            } else {
+                gapStreak = 0;
+            }
+        }
+
+        if (seen && (learned == 0 || gapStreak == 0)) {
+            float err = r - ratio;
+
+            if (learned == 0) {
+                // Erster Abstand ersetzt den Startwert, Abweichung bleibt vorsichtig
+                ratio = r;
+                gapStreak = 0;
+            } else {
+                // Anlauf: laufender Mittelwert, danach EWMA mit fester Lernrate
+                float k = (learned < (1 << FRESHNESS_LEARN_SHIFT)) ?
+                          1.0f / (learned + 1) : 1.0f / (1 << FRESHNESS_LEARN_SHIFT);
+                ratio += err * k;
+                deviation += ((err < 0 ? -err : err) - deviation) * k;
+            }
+
+            if (ratio < 0.5f) ratio = 0.5f;
+            if (ratio > 16.0f) ratio = 16.0f;
+            if (deviation < 0.01f) deviation = 0.01f;
+            if (deviation > 1.0f) deviation = 1.0f;
+            learned++;
+        }
+
+        seen = true;
+        lastMs = nowMs;
+        periodMs = (periodSec ? periodSec : FRESHNESS_DEFAULT_PERIOD) * 1000UL;
+        updateDeadlines();
+    }
+
+    /** Zustand zum Zeitpunkt nowMs */
+    FreshnessState state(unsigned long nowMs) const {
+        if (!seen) return FRESHNESS_NONE;
+        uint32_t elapsed = (uint32_t)(nowMs - lastMs);
+        if (elapsed < lateAfterMs) return FRESHNESS_FRESH;
+        if (elapsed < lostAfterMs) return FRESHNESS_LATE;
+        return FRESHNESS_LOST;
+    }
+
+    /** Werte noch anzeigen/verwenden? (FRESH oder LATE) */
+    bool isValid(unsigned long nowMs) const {
+        FreshnessState s = state(nowMs);
+        return s == FRESHNESS_FRESH || s == FRESHNESS_LATE;
+    }
+
+    /**
+     * Millisekunden bis zum nächsten Zustandswechsel
+     * @return FRESHNESS_NEVER ohne Paket oder im Zustand LOST
+     */
+    unsigned long nextChange(unsigned long nowMs) const {
+        if (!seen) return FRESHNESS_NEVER;
+        uint32_t elapsed = (uint32_t)(nowMs - lastMs);
+        if (elapsed < lateAfterMs) return lateAfterMs - elapsed;
+        if (elapsed < lostAfterMs) return lostAfterMs - elapsed;
+        return FRESHNESS_NEVER;
+    }
+
+    /** millis() des erwarteten nächsten Pakets */
+    unsigned long expectedAt() const {
+        return lastMs + (unsigned long)(periodMs * ratio);
+    }
+
+    unsigned long lastArrival() const { return lastMs; }
+    float getRatio() const { return ratio; }
+    float getDeviation() const { return deviation; }
+    uint32_t getLearned() const { return learned; }
+
+    static const char* stateName(FreshnessState s) {
+        switch (s) {
+            case FRESHNESS_FRESH: return "fresh";
+            case FRESHNESS_LATE:  return "late";
+            case FRESHNESS_LOST:  return "lost";
+            default:              return "none";
+        }
+    }
+};
+
+/** Kleinere von zwei Wartezeiten (z.B. nextChange() mehrerer Sensoren) */
+inline unsigned long freshnessSooner(unsigned long a, unsigned long b) {
+    return a < b ? a : b;
+}
+
+#endif // FRESHNESS_H
@@ -0,0 +1,161 @@
+/*
+ * LogRecord.h
+ * Festes Datensatz-Format des Dataloggers (Binär- und CSV-Segmente)
+ *
+ * Indoor und Outdoor nutzen denselben 26-Byte Datensatz, Outdoor ohne
+ * Luftfeuchtigkeit (LOG_NO_HUMIDITY). Binär-Segmente beginnen mit einem
+ * 8-Byte Header (Magic, Version, Datensatzgröße, UTC-Offset beim Anlegen),
+ * danach folgen nur noch Datensätze - Position n liegt bei 8 + n × 26.
+ *
+ * CSV-Segmente enthalten dieselben Spalten wie bisher; die Zeile wird aus
+ * dem Datensatz erzeugt, damit beide Formate exakt dieselben Werte tragen.
+ *
+ * Kein Arduino-Code: wird auch von tools/logdump.cpp auf dem PC genutzt.
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "SensorIngest.h"
+
+// ==================== FORMAT ====================
+
+#define LOG_BIN_MAGIC 0x474F4C53UL      // "SLOG"
+#define LOG_BIN_VERSION 1
+#define LOG_NO_HUMIDITY 0xFFFF
+
+#define LOG_FLAG_BATTERY_WARNING 0x01
+#define LOG_FLAG_BATCH           0x02   // Gepufferter Wert aus einem Batch-Paket
+
+#define INDOOR_CSV_HEADER  "Timestamp,Date,Time,Temperature,Humidity,Pressure,Battery_mV,Battery_Warning,RSSI,Sleep_Sec,Duration_ms,Error,Reset_Reason"
+#define OUTDOOR_CSV_HEADER "Timestamp,Date,Time,Temperature,Pressure,Battery_mV,Battery_Warning,RSSI,Sleep_Sec,Duration_ms,Error,Reset_Reason"
+
+struct __attribute__((packed)) LogFileHeaderV1 {
+    uint32_t magic;             // LOG_BIN_MAGIC
+    uint8_t version;            // LOG_BIN_VERSION
+    uint8_t record_size;        // sizeof(LogRecordV1)
+    int16_t utc_offset_min;     // Lokalzeit = UTC + Offset (beim Anlegen)
+};
+
+struct __attribute__((packed)) LogRecordV1 {
+    uint32_t ts_ms;             // Receiver-millis() der Messung
+    uint32_t epoch;             // UTC Sekunden, 0 = unbekannt
+    int16_t temp_c100;          // °C × 100
+    uint16_t hum_c100;          // % × 100, LOG_NO_HUMIDITY beim Outdoor-Sensor
+    uint32_t press_pa;          // mbar × 100
+    uint16_t battery_mv;
+    uint16_t sleep_sec;
+    uint16_t duration_ms;
+    uint8_t schema;             // SCHEMA_INDOOR / SCHEMA_OUTDOOR
+    uint8_t flags;              // LOG_FLAG_*
+    uint8_t error;
+    uint8_t reset_reason;
+};
+
+static_assert(sizeof(LogFileHeaderV1) == 8, "LogFileHeaderV1 size");
+static_assert(sizeof(LogRecordV1) == 26, "LogRecordV1 size");
+
+// ==================== KODIERUNG ====================
+
+/** Gerundeter Festkomma-Wert (× scale) */
+inline int32_t logFixed(float value, int32_t scale) {
+    float v = value * scale;
+    return (int32_t)(v < 0 ? v - 0.5f : v + 0.5f);
+}
+
+/**
+ * Datensatz aus einem dekodierten Messwert
+ * @param ts Messzeitpunkt in Receiver-millis()
+ * @param epoch UTC der Messung (vom Sensor oder aus dem Beacon), 0 = unbekannt
+ */
+inline void logRecordFromSample(LogRecordV1& rec, const SensorSample& data, uint8_t schema,
+                                uint32_t ts, uint32_t epoch, bool batch) {
+    int32_t temp = logFixed(data.temperature, 100);
+    if (temp < -32768) temp = -32768;
+    if (temp > 32767) temp = 32767;
+
+    rec.ts_ms = ts;
+    rec.epoch = epoch;
+    rec.temp_c100 = (int16_t)temp;
+    rec.hum_c100 = LOG_NO_HUMIDITY;
+    if (schema == SCHEMA_INDOOR && data.humidity >= 0 && data.humidity < 655) {
+        rec.hum_c100 = (uint16_t)logFixed(data.humidity, 100);
+    }
+    rec.press_pa = data.pressure > 0 ? (uint32_t)logFixed(data.pressure, 100) : 0;
+    rec.battery_mv = data.battery_voltage;
+    rec.sleep_sec = data.sleep_time_sec;
+    rec.duration_ms = data.duration;
+    rec.schema = schema;
+    rec.flags = (data.battery_warning ? LOG_FLAG_BATTERY_WARNING : 0) |
+                (batch ? LOG_FLAG_BATCH : 0);
+    rec.error = data.sensor_error;
+    rec.reset_reason = data.reset_reason;
+}
+
+/** Date,Time Spalten in Lokalzeit; leer bei unbekannter Uhrzeit */
+inline void logFormatDateTime(uint32_t epoch, int16_t offsetMin, char* out, size_t len) {
+    if (epoch == 0) {
+        snprintf(out, len, ",");
+        return;
+    }
+    time_t local = (time_t)epoch + offsetMin * 60;
+    struct tm tm;
+    gmtime_r(&local, &tm);
+    // Felder begrenzen (uint32-Epoch reicht nur bis 2106): so sieht auch der
+    // Compiler, dass die Zeile in 24 Zeichen passt
+    unsigned year = (unsigned)(tm.tm_year + 1900) % 10000u;
+    uint8_t mon = tm.tm_mon + 1, day = tm.tm_mday;
+    uint8_t hour = tm.tm_hour, min = tm.tm_min, sec = tm.tm_sec;
+    snprintf(out, len, "%04u-%02u-%02u,%02u:%02u:%02u",
+             year, (unsigned)mon, (unsigned)day,
+             (unsigned)hour, (unsigned)min, (unsigned)sec);
+}
+
+/** Lokaler Tag seit 1970 (für die Tages-Rotation), 0 = Uhrzeit unbekannt */
+inline uint32_t logLocalDay(uint32_t epoch, int16_t offsetMin) {
+    if (epoch == 0) return 0;
+    return (uint32_t)(((int64_t)epoch + offsetMin * 60) / 86400);
+}
+
+/**
+ * CSV-Zeile (ohne Zeilenende) mit den Spalten von INDOOR_/OUTDOOR_CSV_HEADER
+ * @return Länge der Zeile
+ */
+inline int logRecordToCsv(const LogRecordV1& rec, int16_t offsetMin, char* out, size_t len) {
+    char dateTime[32];
+    logFormatDateTime(rec.epoch, offsetMin, dateTime, sizeof(dateTime));
+
+    char hum[12] = "";
+    if (rec.schema == SCHEMA_INDOOR) {
+        if (rec.hum_c100 != LOG_NO_HUMIDITY) {
+            snprintf(hum, sizeof(hum), "%u.%02u,", rec.hum_c100 / 100, rec.hum_c100 % 100);
+        } else {
+            snprintf(hum, sizeof(hum), ",");
+        }
+    }
+
+    int32_t t = rec.temp_c100;
+    uint32_t ta = t < 0 ? -t : t;
+
+    // Timestamp,Date,Time,Temp,[Hum,]Press,Batt,Warning,RSSI,Sleep,Duration,Error,Reset
+    return snprintf(out, len, "%lu,%s,%s%lu.%02lu,%s%lu.%02lu,%u,%u,,%u,%u,%u,%u",
+                    (unsigned long)rec.ts_ms,
+                    dateTime,
+                    t < 0 ? "-" : "", (unsigned long)(ta / 100), (unsigned long)(ta % 100),
+                    hum,
+                    (unsigned long)(rec.press_pa / 100), (unsigned long)(rec.press_pa % 100),
+                    rec.battery_mv,
+                    (rec.flags & LOG_FLAG_BATTERY_WARNING) ? 1 : 0,
+                    rec.sleep_sec,
+                    rec.duration_ms,
+                    rec.error,
+                    rec.reset_reason);
+}
+
+#endif // LOG_RECORD_H
@@ -0,0 +1,386 @@
+/*
+ * LogSegments.h
+ * Rotierende Log-Segmente mit Block-Puffer und Segment-Index
+ *
+ * Statt endlos an eine CSV anzuhängen (und sie pro Paket zu öffnen) schreibt
+ * jeder Datenstrom ("indoor", "outdoor", "sensor_A1B2C3") in nummerierte
+ * Segmente unter LOG_DIR:
+ *   /logs/indoor_00012.csv   (oder .bin im Binär-Modus, siehe LogRecord.h)
+ *
+ * - Rotation bei LOG_SEGMENT_MAX_BYTES und (LOG_ROTATE_DAILY) bei lokalem
+ *   Tageswechsel, sobald die Uhrzeit bekannt ist
+ * - Datensätze sammeln sich in einem 512-Byte Puffer (ein SD-Sektor) pro
+ *   Strom; geschrieben wird blockweise oder spätestens nach
+ *   LOG_FLUSH_INTERVAL_MS. Beim Stromausfall gehen höchstens die Werte
+ *   dieses Intervalls verloren.
+ * - Jedes neue Segment bekommt eine Zeile in LOG_INDEX_FILE:
+ *   Stream,Segment,File,Start_Epoch,Start_Day,Format
+ *   Nach einem Neustart wird daraus das aktuelle Segment je Strom ermittelt
+ *   und weitergeschrieben.
+ *
+ * Segmente bleiben klein, damit kostet das Öffnen zum Anhängen auf FAT
+ * (Cluster-Kette bis zum Dateiende) unabhängig von der Laufzeit gleich viel.
+ *
+ * Schlägt ein Block-Schreiben fehl (Karte gezogen, FAT voll), wird der Block
+ * verworfen und gezählt; der Strom ermittelt sein Segment beim nächsten
+ * Datensatz neu (ein abgebrochener Binär-Block beginnt ein neues Segment).
+ *
+ * Version: 1.0.1
+ */
+
+#ifndef LOG_SEGMENTS_H
+#define LOG_SEGMENTS_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "LogRecord.h"
+
+// ==================== KONFIGURATION ====================
+
+#define LOG_DIR "/logs"
+#define LOG_INDEX_FILE "/logs/index.csv"
+#define LOG_INDEX_HEADER "Stream,Segment,File,Start_Epoch,Start_Day,Format"
+
+#define LOG_SEGMENT_MAX_BYTES (1024UL * 1024UL)  // 1 MB pro Segment
+#define LOG_ROTATE_DAILY 1                       // Zusätzlich neues Segment pro Tag
+#define LOG_BLOCK_SIZE 512                       // Schreib-Block (ein SD-Sektor)
+#define LOG_FLUSH_INTERVAL_MS 300000UL           // Spätestens alle 5 Minuten schreiben
+#define LOG_STREAM_MAX 6                         // Gleichzeitig gepufferte Ströme
+#define LOG_STREAM_NAME_LEN 16
+#define LOG_PATH_LEN 40
+
+// ==================== DATENSTRUKTUREN ====================
+
+struct LogStream {
+    char name[LOG_STREAM_NAME_LEN];  // Leer = Slot frei
+    uint8_t schema;
+    bool ready;                      // Aktuelles Segment ermittelt/angelegt
+    uint32_t segment;                // Laufende Nummer
+    uint32_t bytes;                  // Segmentgröße inkl. Puffer
+    uint32_t day;                    // Lokaler Tag beim Anlegen, 0 = unbekannt
+    uint16_t fill;                   // Belegte Bytes im Puffer
+    unsigned long pendingSince;      // millis() des ältesten ungeschriebenen Datensatzes
+    uint32_t lastUse;                // Für die Verdrängung (LRU)
+    uint8_t block[LOG_BLOCK_SIZE];
+};
+
+// ==================== HAUPT-KLASSE ====================
+
+class LogSegmentWriter {
+private:
+    fs::FS* fs;
+    bool binary;
+    LogStream streams[LOG_STREAM_MAX];
+    uint32_t useCounter;
+    uint32_t blocksWritten;
+    uint32_t segmentsCreated;
+    uint32_t writeErrors;
+    uint32_t bytesDropped;           // Wegen Schreibfehlern verworfene Puffer-Bytes
+
+    const char* extension() const {
+        return binary ? "bin" : "csv";
+    }
+
+    void segmentPath(const LogStream& s, uint32_t segment, char* out, size_t len) const {
+        snprintf(out, len, LOG_DIR "/%s_%05lu.%s", s.name, (unsigned long)segment, extension());
+    }
+
+    LogStream* find(const char* name) {
+        for (uint8_t i = 0; i < LOG_STREAM_MAX; i++) {
+            if (strcmp(streams[i].name, name) == 0) return &streams[i];
+        }
+        return nullptr;
+    }
+
+    /**
+     * Slot für einen Strom holen, notfalls den am längsten ungenutzten
+     * verdrängen (vorher schreiben)
+     */
+    LogStream* acquire(const char* name, uint8_t schema) {
+        LogStream* s = find(name);
+        if (s) return s;
+
+        LogStream* victim = &streams[0];
+        for (uint8_t i = 0; i < LOG_STREAM_MAX; i++) {
+            if (streams[i].name[0] == '\0') {
+                victim = &streams[i];
+                break;
+            }
+            if (streams[i].lastUse < victim->lastUse) victim = &streams[i];
+        }
+
+        if (victim->name[0] != '\0' && victim->fill > 0) {
+            uint16_t pending = victim->fill;
+            if (!flush(*victim)) {
+                Serial.printf("[SD] Stream %s evicted, %u bytes lost\n", victim->name, pending);
+            }
+        }
+
+        memset(victim, 0, sizeof(LogStream));
+        strncpy(victim->name, name, LOG_STREAM_NAME_LEN - 1);
+        victim->schema = schema;
+        return victim;
+    }
+
+    /**
+     * Letztes Segment des Stroms aus dem Index lesen
+     * @param sameFormat true wenn es im aktuellen Format (csv/bin) angelegt wurde
+     * @return false wenn der Strom noch kein Segment hat
+     */
+    bool recover(LogStream& s, bool& sameFormat) {
+        File idx = fs->open(LOG_INDEX_FILE, FILE_READ);
+        if (!idx) return false;
+
+        bool found = false;
+        size_t nameLen = strlen(s.name);
+        char line[96];
+        while (idx.available()) {
+            size_t n = idx.readBytesUntil('\n', line, sizeof(line) - 1);
+            line[n] = '\0';
+            if (strncmp(line, s.name, nameLen) != 0 || line[nameLen] != ',') continue;
+
+            // Stream,Segment,File,Start_Epoch,Start_Day,Format
+            unsigned long segment, epoch, day;
+            char path[LOG_PATH_LEN], format[8];
+            if (sscanf(line + nameLen + 1, "%lu,%39[^,],%lu,%lu,%7s",
+                       &segment, path, &epoch, &day, format) != 5) continue;
+
+            if (!found || segment >= s.segment) {
+                s.segment = segment;
+                s.day = day;
+                sameFormat = strcmp(format, extension()) == 0;
+                found = true;
+            }
+        }
+        idx.close();
+        return found;
+    }
+
+    /** Neues Segment anlegen und im Index eintragen */
+    bool create(LogStream& s, uint32_t epoch, uint32_t day, int16_t offsetMin) {
+        char path[LOG_PATH_LEN];
+        segmentPath(s, s.segment, path, sizeof(path));
+
+        File file = fs->open(path, FILE_WRITE);
+        if (!file) {
+            writeErrors++;
+            Serial.printf("[SD] Failed to create segment %s\n", path);
+            return false;
+        }
+
+        bool ok;
+        if (binary) {
+            LogFileHeaderV1 hdr = { LOG_BIN_MAGIC, LOG_BIN_VERSION, sizeof(LogRecordV1), offsetMin };
+            ok = file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+        } else {
+            const char* header = s.schema == SCHEMA_INDOOR ? INDOOR_CSV_HEADER : OUTDOOR_CSV_HEADER;
+            ok = file.println(header) == strlen(header) + 2;
+        }
+        s.bytes = file.size();
+        file.close();
+
+        // Ohne vollständigen Header nicht in den Index: der nächste Versuch
+        // legt dieselbe Segmentnummer neu an
+        if (!ok) {
+            writeErrors++;
+            Serial.printf("[SD] Failed to write header of %s\n", path);
+            return false;
+        }
+
+        File idx = fs->open(LOG_INDEX_FILE, FILE_APPEND);
+        if (idx) {
+            idx.printf("%s,%lu,%s,%lu,%lu,%s\n", s.name, (unsigned long)s.segment, path,
+                       (unsigned long)epoch, (unsigned long)day, extension());
+            idx.close();
+        }
+
+        s.day = day;
+        s.ready = true;
+        segmentsCreated++;
+        Serial.printf("[SD] New segment: %s\n", path);
+        return true;
+    }
+
+    /** Beim ersten Datensatz nach dem Start: Segment fortsetzen oder anlegen */
+    bool prepare(LogStream& s, uint32_t epoch, uint32_t day, int16_t offsetMin) {
+        bool sameFormat = false;
+        if (!recover(s, sameFormat)) {
+            s.segment = 0;
+            return create(s, epoch, day, offsetMin);
+        }
+        if (!sameFormat) {
+            // LOG_FORMAT_BINARY geändert: neues Segment im neuen Format
+            s.segment++;
+            return create(s, epoch, day, offsetMin);
+        }
+
+        char path[LOG_PATH_LEN];
+        segmentPath(s, s.segment, path, sizeof(path));
+        File file = fs->open(path, FILE_READ);
+        if (!file) {
+            // Im Index, aber gelöscht: unter derselben Nummer neu anlegen
+            return create(s, epoch, day, offsetMin);
+        }
+        s.bytes = file.size();
+        file.close();
+
+        // Abgebrochener Binär-Datensatz (Stromausfall beim Schreiben): nicht
+        // dahinter weiterschreiben, sonst verschiebt sich das Raster
+        if (binary && (s.bytes < sizeof(LogFileHeaderV1) ||
+                       (s.bytes - sizeof(LogFileHeaderV1)) % sizeof(LogRecordV1) != 0)) {
+            s.segment++;
+            return create(s, epoch, day, offsetMin);
+        }
+
+        s.ready = true;
+        Serial.printf("[SD] Continuing segment: %s (%lu bytes)\n", path, (unsigned long)s.bytes);
+        return true;
+    }
+
+    bool needsRotation(const LogStream& s, uint32_t day, size_t len) const {
+        if (s.bytes + len > LOG_SEGMENT_MAX_BYTES) return true;
+#if LOG_ROTATE_DAILY
+        if (s.day != 0 && day != 0 && day != s.day) return true;
+#endif
+        return false;
+    }
+
+public:
+    LogSegmentWriter()
+        : fs(nullptr), binary(false), useCounter(0),
+          blocksWritten(0), segmentsCreated(0), writeErrors(0), bytesDropped(0) {
+        memset(streams, 0, sizeof(streams));
+    }
+
+    /**
+     * Verzeichnis und Index anlegen
+     * @param binaryFormat true = LogRecordV1 Segmente (.bin), false = CSV
+     */
+    bool begin(fs::FS& filesystem, bool binaryFormat) {
+        fs = &filesystem;
+        binary = binaryFormat;
+
+        if (!fs->exists(LOG_DIR) && !fs->mkdir(LOG_DIR)) {
+            Serial.println("[SD] Failed to create " LOG_DIR);
+            return false;
+        }
+
+        if (!fs->exists(LOG_INDEX_FILE)) {
+            File idx = fs->open(LOG_INDEX_FILE, FILE_WRITE);
+            if (!idx) return false;
+            idx.println(LOG_INDEX_HEADER);
+            idx.close();
+        }
+        return true;
+    }
+
+    /**
+     * Datensatz anhängen (gepuffert)
+     * @param name Strom = Dateipräfix, z.B. "indoor" oder "sensor_A1B2C3"
+     * @param nowMs millis() für den Zeit-Flush
+     */
+    bool append(const char* name, const LogRecordV1& rec, int16_t offsetMin, unsigned long nowMs) {
+        if (!fs) return false;
+
+        LogStream* s = acquire(name, rec.schema);
+        s->lastUse = ++useCounter;
+
+        uint8_t buf[160];
+        size_t len;
+        if (binary) {
+            memcpy(buf, &rec, sizeof(rec));
+            len = sizeof(rec);
+        } else {
+            int n = logRecordToCsv(rec, offsetMin, (char*)buf, sizeof(buf) - 2);
+            if (n < 0 || n > (int)sizeof(buf) - 3) return false;
+            buf[n++] = '\r';
+            buf[n++] = '\n';
+            len = n;
+        }
+
+        uint32_t day = logLocalDay(rec.epoch, offsetMin);
+
+        if (!s->ready && !prepare(*s, rec.epoch, day, offsetMin)) return false;
+
+        if (needsRotation(*s, day, len)) {
+            if (!flush(*s)) return false;
+            s->segment++;
+            if (!create(*s, rec.epoch, day, offsetMin)) {
+                s->ready = false;
+                return false;
+            }
+        } else if (s->day == 0 && day != 0) {
+            // Uhrzeit erst während des Segments bekannt geworden
+            s->day = day;
+        }
+
+        // Voller Puffer und Schreibfehler: Datensatz verwerfen, nie über den Block hinaus
+        if (s->fill + len > LOG_BLOCK_SIZE && !flush(*s)) return false;
+        if (s->fill + len > LOG_BLOCK_SIZE) return false;
+        if (s->fill == 0) s->pendingSince = nowMs;
+
+        memcpy(s->block + s->fill, buf, len);
+        s->fill += len;
+        s->bytes += len;
+
+        if (s->fill == LOG_BLOCK_SIZE) return flush(*s);
+        return true;
+    }
+
+    /** Puffer eines Stroms in sein aktuelles Segment schreiben */
+    bool flush(LogStream& s) {
+        if (s.fill == 0 || !s.ready) return true;
+
+        char path[LOG_PATH_LEN];
+        segmentPath(s, s.segment, path, sizeof(path));
+
+        File file = fs->open(path, FILE_APPEND);
+        bool ok = file && file.write(s.block, s.fill) == s.fill;
+        if (file) file.close();
+
+        if (!ok) {
+            // Block verwerfen; Segment beim nächsten Datensatz neu ermitteln, weil
+            // ein Teil des Blocks geschrieben sein kann
+            writeErrors++;
+            bytesDropped += s.fill;
+            Serial.printf("[SD] Block write failed: %s (%u bytes dropped)\n", path, s.fill);
+            s.fill = 0;
+            s.ready = false;
+            return false;
+        }
+
+        blocksWritten++;
+        s.fill = 0;
+        return true;
+    }
+
+    /** Alle Puffer schreiben */
+    void flushAll() {
+        for (uint8_t i = 0; i < LOG_STREAM_MAX; i++) {
+            if (streams[i].name[0] != '\0') flush(streams[i]);
+        }
+    }
+
+    /** Zeit-Flush: Puffer älter als LOG_FLUSH_INTERVAL_MS schreiben */
+    void poll(unsigned long nowMs) {
+        for (uint8_t i = 0; i < LOG_STREAM_MAX; i++) {
+            LogStream& s = streams[i];
+            if (s.fill > 0 && nowMs - s.pendingSince >= LOG_FLUSH_INTERVAL_MS) flush(s);
+        }
+    }
+
+    /** Ungeschriebene Bytes aller Ströme */
+    uint32_t getPending() const {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < LOG_STREAM_MAX; i++) total += streams[i].fill;
+        return total;
+    }
+
+    bool isBinary() const { return binary; }
+    uint32_t getBlocksWritten() const { return blocksWritten; }
+    uint32_t getSegmentsCreated() const { return segmentsCreated; }
+    uint32_t getWriteErrors() const { return writeErrors; }
+    uint32_t getBytesDropped() const { return bytesDropped; }
+};
+
+#endif // LOG_SEGMENTS_H
@@ -0,0 +1,160 @@
+/*
+ * SensorCodec.h
+ * Kompakte Kodierung von Messreihen: Festkomma, Delta, Varint
+ *
+ * Ein Datensatz besteht aus bis zu CODEC_MAX_FIELDS ganzzahligen Feldern
+ * (bereits quantisiert, z.B. 0.01 °C, 0.1 hPa). Jedes Feld wird als
+ * Differenz zum gleichen Feld des vorherigen Datensatzes geschrieben
+ * (der erste gegen 0), ZigZag-gewandelt und als LEB128-Varint gepackt:
+ * langsam veränderliche Werte kosten so meist 1 Byte pro Feld.
+ *
+ * Reiner Byte-Code ohne Arduino-Abhängigkeiten und ohne Heap;
+ * Round-Trip Test auf dem PC: tools/codec_roundtrip.cpp
+ *
+ * Identische Kopie in: ESP8266_Outdoorsensor (Sender), ESP32-C3_Bridge_Slave,
+ * ESP32_C3_Datalogger, CYD_ESP_NOW_Receiver, ESP_NOW_Receiver_ESP32,
+ * ESP_NOW_Receiver
+ *
+ * Version: 1.0.0
+ */
+
+#ifndef SENSOR_CODEC_H
+#define SENSOR_CODEC_H
+
+#include <stdint.h>
+
+// ==================== KONFIGURATION ====================
+
+#define CODEC_MAX_FIELDS 8
+#define CODEC_MAX_VARINT 5              // 32 Bit brauchen max. 5 Bytes
+
+// ==================== HILFSFUNKTIONEN ====================
+
+/** Gerundete Festkomma-Darstellung, z.B. codecQuantize(21.537, 100) = 2154 */
+inline int32_t codecQuantize(float value, float scale) {
+    float v = value * scale;
+    return (int32_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+}
+
+inline uint32_t codecZigZag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t codecUnZigZag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/**
+ * Varint schreiben
+ * @return Anzahl Bytes, 0 wenn der Puffer nicht reicht
+ */
+inline int codecPutVarint(uint8_t* out, int cap, uint32_t v) {
+    int n = 0;
+    do {
+        if (n >= cap) return 0;
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        out[n++] = v ? (b | 0x80) : b;
+    } while (v);
+    return n;
+}
+
+/**
+ * Varint lesen
+ * @return Anzahl Bytes, 0 bei abgeschnittenem oder zu langem Wert
+ */
+inline int codecGetVarint(const uint8_t* in, int len, uint32_t& v) {
+    v = 0;
+    for (int n = 0; n < len && n < CODEC_MAX_VARINT; n++) {
+        v |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) return n + 1;
+    }
+    return 0;
+}
+
+// ==================== ENCODER ====================
+
+class DeltaEncoder {
+private:
+    uint8_t* out;
+    int cap;
+    int pos;
+    uint8_t fields;
+    int32_t prev[CODEC_MAX_FIELDS];
+    bool overflow;
+
+public:
+    /**
+     * @param buf Zielpuffer
+     * @param capacity Grösse des Puffers
+     * @param fieldCount Felder pro Datensatz (<= CODEC_MAX_FIELDS)
+     */
+    DeltaEncoder(uint8_t* buf, int capacity, uint8_t fieldCount)
+        : out(buf), cap(capacity), pos(0),
+          fields(fieldCount > CODEC_MAX_FIELDS ? CODEC_MAX_FIELDS : fieldCount), overflow(false) {
+        for (uint8_t i = 0; i < CODEC_MAX_FIELDS; i++) prev[i] = 0;
+    }
+
+    /**
+     * Datensatz anhängen
+     * @return false wenn der Puffer voll ist (Datensatz wird dann nicht geschrieben)
+     */
+    bool put(const int32_t* values) {
+        if (overflow) return false;
+
+        int start = pos;
+        for (uint8_t i = 0; i < fields; i++) {
+            // Differenz modulo 2^32: auch extreme Sprünge bleiben verlustfrei
+            int32_t delta = (int32_t)((uint32_t)values[i] - (uint32_t)prev[i]);
+            int n = codecPutVarint(out + pos, cap - pos, codecZigZag(delta));
+            if (n == 0) {
+                pos = start;
+                overflow = true;
+                return false;
+            }
+            pos += n;
+        }
+        for (uint8_t i = 0; i < fields; i++) prev[i] = values[i];
+        return true;
+    }
+
+    int length() const { return pos; }
+};
+
+// ==================== DECODER ====================
+
+class DeltaDecoder {
+private:
+    const uint8_t* in;
+    int len;
+    int pos;
+    uint8_t fields;
+    int32_t prev[CODEC_MAX_FIELDS];
+
+public:
+    DeltaDecoder(const uint8_t* data, int length, uint8_t fieldCount)
+        : in(data), len(length), pos(0),
+          fields(fieldCount > CODEC_MAX_FIELDS ? CODEC_MAX_FIELDS : fieldCount) {
+        for (uint8_t i = 0; i < CODEC_MAX_FIELDS; i++) prev[i] = 0;
+    }
+
+    /**
+     * Nächsten Datensatz lesen
+     * @return false am Ende oder bei beschädigten Daten
+     */
+    bool get(int32_t* values) {
+        for (uint8_t i = 0; i < fields; i++) {
+            uint32_t raw;
+            int n = codecGetVarint(in + pos, len - pos, raw);
+            if (n == 0) return false;
+            pos += n;
+            values[i] = (int32_t)((uint32_t)prev[i] + (uint32_t)codecUnZigZag(raw));
+        }
+        for (uint8_t i = 0; i < fields; i++) prev[i] = values[i];
+        return true;
+    }
+
+    int position() const { return pos; }
+};
+
+#endif // SENSOR_CODEC_H
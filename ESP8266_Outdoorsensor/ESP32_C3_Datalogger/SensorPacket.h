@@ -0,0 +1,378 @@
+/*
+ * SensorPacket.h
+ * Versioniertes ESP-NOW Paketformat der Sensoren
+ *
+ * Jedes Paket beginnt mit einem 8-Byte Header:
+ *   magic (2)  version (1)  sensor_type (1)  flags (1)  payload_len (1)  sequence (2)
+ * gefolgt von payload_len Bytes Nutzdaten des jeweiligen Sensortyps.
+ *
+ * Kompatibilitätsregeln:
+ * - Neue Felder werden nur hinten an eine Payload angehängt. Empfänger
+ *   dekodieren den bekannten Anfang und ignorieren den Rest.
+ * - Neue Sensortypen bekommen eine neue sensor_type Nummer; ältere
+ *   Empfänger verwerfen (und zählen) unbekannte Typen.
+ * - version wird nur bei inkompatiblen Header-Änderungen erhöht.
+ *
+ * Batch-Pakete (SENSOR_FLAG_BATCH): Sensoren im Store-and-Forward Modus
+ * puffern Messwerte im RTC Memory und senden sie gesammelt. Die Payload
+ * enthält wie immer den aktuellen Messwert; dahinter folgt, nicht in
+ * payload_len enthalten und daher für ältere Empfänger unsichtbar:
+ *   count (1)  count x SensorBatchSample (ältester zuerst)
+ * Mit SENSOR_FLAG_COMPACT folgt statt der festen 10-Byte Datensätze ein
+ * SensorCodec-Strom (Delta + Varint) mit denselben Feldern, typisch
+ * 5-6 Bytes pro Messwert.
+ *
+ * Wachzeit-Phasen: Sensoren ab Firmware 1.4 hängen SensorTimingV1 an ihre
+ * Payload an (in payload_len enthalten). Sie beschreibt wie duration den
+ * vorherigen Wach-Zyklus, weil Senden und Schlafvorbereitung des aktuellen
+ * Zyklus beim Bau des Pakets noch nicht abgeschlossen sind. Dahinter folgt
+ * epoch, die UTC-Zeit der Messung (0 = Sensor kennt die Uhrzeit nicht).
+ *
+ * Zeit-Beacons: Steuerpakete (sensor_type ab SENSOR_TYPE_CONTROL_FIRST)
+ * tragen keine Messwerte. Die Bridge sendet mit SENSOR_TYPE_TIME_BEACON
+ * ihre NTP-Zeit als Broadcast, periodisch und sofort als Antwort auf ein
+ * Paket mit SENSOR_FLAG_TIME_REQUEST; der Sensor hört danach kurz mit.
+ *
+ * Alle Structs sind packed und werden per memcpy gelesen (ESP8266 verträgt
+ * keine unausgerichteten Zugriffe).
+ *
+ * Identische Kopie in: ESP8266_Outdoorsensor (Sender), ESP32-C3_Bridge_Slave,
+ * ESP32_C3_Datalogger, CYD_ESP_NOW_Receiver, ESP_NOW_Receiver_ESP32,
+ * ESP_NOW_Receiver
+ *
+ * Version: 1.5.0
+ */
+
+#ifndef SENSOR_PACKET_H
+#define SENSOR_PACKET_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include "SensorCodec.h"
+
+// ==================== KONSTANTEN ====================
+
+#define SENSOR_PACKET_MAGIC 0x5053      // "SP" (Little Endian)
+#define SENSOR_PACKET_VERSION 1
+
+// Sensortypen (Werte wie das alte sensor_type Feld)
+#define SENSOR_TYPE_OUTDOOR 0           // BMP180
+#define SENSOR_TYPE_INDOOR 1            // BMP180 + AM2321
+#define SENSOR_TYPE_CONTROL_FIRST 0xF0  // Ab hier Steuerpakete (keine Messwerte)
+#define SENSOR_TYPE_TIME_BEACON 0xF0    // Uhrzeit der Bridge
+
+// Header-Flags
+#define SENSOR_FLAG_BATTERY_LOW 0x01    // Spiegel von battery_warning
+#define SENSOR_FLAG_SEQ_RESET 0x02      // Sequenz neu gestartet (RTC Memory war ungültig)
+#define SENSOR_FLAG_BATCH 0x04          // Batch-Block hinter der Payload
+#define SENSOR_FLAG_COMPACT 0x08        // Batch-Block mit SensorCodec kodiert
+#define SENSOR_FLAG_RETRY_MASK 0x30     // Bits 4-5: Sendeversuch (0 = erster, 3 = dritte Wiederholung oder Kanalsuche)
+#define SENSOR_FLAG_RETRY_SHIFT 4
+#define SENSOR_RETRY_MAX 3
+#define SENSOR_FLAG_TIME_REQUEST 0x40   // Sensor wartet nach dem Senden kurz auf ein Zeit-Beacon
+
+// ==================== HEADER ====================
+
+struct SensorPacketHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t sensor_type;
+    uint8_t flags;
+    uint8_t payload_len;
+    uint16_t sequence;          // Pro Sensor fortlaufend, überlebt Deep Sleep (RTC)
+} __attribute__((packed));
+
+static_assert(sizeof(SensorPacketHeader) == 8, "Header layout changed");
+
+// ==================== PAYLOADS (VERSION 1) ====================
+
+// Gemeinsamer Anfang aller BMP180-Sensoren
+struct SensorPayloadOutdoorV1 {
+    uint32_t timestamp;         // millis() beim Senden
+    float temperature;          // °C
+    float pressure;             // mbar
+    uint16_t battery_voltage;   // mV
+    uint16_t duration;          // ms (letzter Zyklus)
+    uint8_t battery_warning;
+    uint8_t sensor_error;
+    uint8_t reset_reason;
+    uint16_t sleep_time_sec;
+} __attribute__((packed));
+
+// Indoor = Outdoor-Felder + AM2321
+struct SensorPayloadIndoorV1 {
+    SensorPayloadOutdoorV1 base;
+    float humidity;             // %
+    uint8_t am2321_readings;
+} __attribute__((packed));
+
+static_assert(sizeof(SensorPayloadOutdoorV1) == 21, "Outdoor payload layout changed");
+static_assert(sizeof(SensorPayloadIndoorV1) == 26, "Indoor payload layout changed");
+
+// Wachzeit des vorherigen Zyklus nach Phasen (ms), hinten an die Payload angehängt
+struct SensorTimingV1 {
+    uint16_t boot_ms;           // Reset bis setup()
+    uint16_t sensor_ms;         // Sensoren auslesen
+    uint16_t radio_init_ms;     // Funk wecken, ESP-NOW Init, Peer (0 = Wake ohne Funk)
+    uint16_t send_ms;           // Senden bis zur Bestätigung, inkl. Wiederholungen
+    uint16_t sleep_setup_ms;    // Puffer, Modell, RTC bis zum Deep Sleep
+} __attribute__((packed));
+
+// Payloads der Sender mit Phasen-Messung und Uhrzeit
+struct SensorPayloadOutdoorTimed {
+    SensorPayloadOutdoorV1 data;
+    SensorTimingV1 timing;
+    uint32_t epoch;             // UTC Sekunden der Messung, 0 = unbekannt
+} __attribute__((packed));
+
+struct SensorPayloadIndoorTimed {
+    SensorPayloadIndoorV1 data;
+    SensorTimingV1 timing;
+    uint32_t epoch;
+} __attribute__((packed));
+
+static_assert(sizeof(SensorTimingV1) == 10, "Timing layout changed");
+
+// ==================== ZEIT-BEACON ====================
+
+// Payload von SENSOR_TYPE_TIME_BEACON
+struct TimeBeaconV1 {
+    uint32_t epoch;             // UTC Sekunden
+    uint16_t epoch_ms;          // Millisekunden-Anteil
+    int16_t utc_offset_min;     // Lokalzeit = UTC + Offset (inkl. Sommerzeit)
+    uint16_t source_age_sec;    // Sekunden seit der letzten NTP-Zeit der Quelle (65535 = älter)
+} __attribute__((packed));
+
+static_assert(sizeof(TimeBeaconV1) == 10, "Time beacon layout changed");
+
+// ==================== BATCH ====================
+
+#define SENSOR_BATCH_MAX 16             // 8 + 40 + 1 + 16 x 10 = 209 Bytes < 250
+#define SENSOR_BATCH_NO_HUMIDITY 0xFFFF
+
+// Kompakter gepufferter Messwert (Festkomma)
+struct SensorBatchSample {
+    uint16_t age_sec;           // Sekunden vor dem aktuellen Messwert (Payload)
+    int16_t temperature;        // 0.01 °C
+    uint16_t pressure;          // 0.1 mbar
+    uint16_t humidity;          // 0.01 %, SENSOR_BATCH_NO_HUMIDITY = nicht gemessen
+    uint16_t battery_voltage;   // mV
+} __attribute__((packed));
+
+static_assert(sizeof(SensorBatchSample) == 10, "Batch sample layout changed");
+
+// Felder im SensorCodec-Strom (Reihenfolge = Kodierung)
+#define SENSOR_BATCH_FIELDS 5
+
+inline void sensorBatchToFields(const SensorBatchSample& s, int32_t* v) {
+    v[0] = s.age_sec;
+    v[1] = s.temperature;
+    v[2] = s.pressure;
+    v[3] = s.humidity;
+    v[4] = s.battery_voltage;
+}
+
+inline void sensorBatchFromFields(const int32_t* v, SensorBatchSample& s) {
+    s.age_sec = (uint16_t)v[0];
+    s.temperature = (int16_t)v[1];
+    s.pressure = (uint16_t)v[2];
+    s.humidity = (uint16_t)v[3];
+    s.battery_voltage = (uint16_t)v[4];
+}
+
+// ==================== HILFSFUNKTIONEN ====================
+
+/**
+ * Header schreiben
+ * @return Gesamtlänge (Header + Payload)
+ */
+inline int sensorPacketBuild(uint8_t* buf, uint8_t sensorType, uint8_t flags, uint16_t sequence,
+                             const void* payload, uint8_t payloadLen) {
+    SensorPacketHeader hdr;
+    hdr.magic = SENSOR_PACKET_MAGIC;
+    hdr.version = SENSOR_PACKET_VERSION;
+    hdr.sensor_type = sensorType;
+    hdr.flags = flags;
+    hdr.payload_len = payloadLen;
+    hdr.sequence = sequence;
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    memcpy(buf + sizeof(hdr), payload, payloadLen);
+    return sizeof(hdr) + payloadLen;
+}
+
+/**
+ * Sendeversuch im Header eines fertigen Pakets eintragen (Sequenz bleibt gleich,
+ * der Empfänger verwirft doppelt angekommene Wiederholungen)
+ */
+inline void sensorPacketSetRetry(uint8_t* buf, uint8_t attempt) {
+    if (attempt > SENSOR_RETRY_MAX) attempt = SENSOR_RETRY_MAX;
+    uint8_t& flags = buf[offsetof(SensorPacketHeader, flags)];
+    flags = (flags & ~SENSOR_FLAG_RETRY_MASK) | (attempt << SENSOR_FLAG_RETRY_SHIFT);
+}
+
+inline uint8_t sensorPacketRetry(uint8_t flags) {
+    return (flags & SENSOR_FLAG_RETRY_MASK) >> SENSOR_FLAG_RETRY_SHIFT;
+}
+
+/**
+ * Header prüfen und lesen
+ * @return true wenn Magic, Version und Länge stimmen; payload zeigt dann auf die Nutzdaten
+ */
+inline bool sensorPacketParse(const uint8_t* data, int len, SensorPacketHeader& hdr, const uint8_t*& payload) {
+    if (len < (int)sizeof(SensorPacketHeader)) return false;
+    memcpy(&hdr, data, sizeof(hdr));
+
+    if (hdr.magic != SENSOR_PACKET_MAGIC) return false;
+    if (hdr.version != SENSOR_PACKET_VERSION) return false;
+    if ((int)sizeof(hdr) + hdr.payload_len > len) return false;
+
+    payload = data + sizeof(hdr);
+    return true;
+}
+
+/** Steuerpaket (z.B. Zeit-Beacon) statt Messwert? */
+inline bool sensorPacketIsControl(const uint8_t* data, int len) {
+    SensorPacketHeader hdr;
+    const uint8_t* payload;
+    return sensorPacketParse(data, len, hdr, payload) && hdr.sensor_type >= SENSOR_TYPE_CONTROL_FIRST;
+}
+
+/**
+ * Zeit-Beacon bauen
+ * @return Gesamtlänge
+ */
+inline int sensorTimeBeaconBuild(uint8_t* buf, uint16_t sequence, const TimeBeaconV1& beacon) {
+    return sensorPacketBuild(buf, SENSOR_TYPE_TIME_BEACON, 0, sequence, &beacon, sizeof(beacon));
+}
+
+/** @return false wenn das Paket kein (vollständiges) Zeit-Beacon ist */
+inline bool sensorTimeBeaconParse(const uint8_t* data, int len, TimeBeaconV1& beacon) {
+    SensorPacketHeader hdr;
+    const uint8_t* payload;
+    if (!sensorPacketParse(data, len, hdr, payload)) return false;
+    if (hdr.sensor_type != SENSOR_TYPE_TIME_BEACON || hdr.payload_len < sizeof(beacon)) return false;
+    memcpy(&beacon, payload, sizeof(beacon));
+    return true;
+}
+
+/**
+ * Angehängte Phasen-Messung lesen
+ * @param baseLen Länge der Payload ohne Timing (z.B. sizeof(SensorPayloadOutdoorV1))
+ * @return false wenn der Sender keine Phasen meldet (ältere Firmware)
+ */
+inline bool sensorTimingRead(const uint8_t* payload, int payloadLen, int baseLen, SensorTimingV1& timing) {
+    if (payloadLen < baseLen + (int)sizeof(SensorTimingV1)) return false;
+    memcpy(&timing, payload + baseLen, sizeof(timing));
+    return true;
+}
+
+/**
+ * Messzeitpunkt (UTC) hinter der Phasen-Messung lesen
+ * @return false wenn der Sender keinen sendet; epoch = 0 wenn er die Uhrzeit nicht kennt
+ */
+inline bool sensorEpochRead(const uint8_t* payload, int payloadLen, int baseLen, uint32_t& epoch) {
+    int offset = baseLen + (int)sizeof(SensorTimingV1);
+    if (payloadLen < offset + (int)sizeof(epoch)) return false;
+    memcpy(&epoch, payload + offset, sizeof(epoch));
+    return true;
+}
+
+/**
+ * Batch-Block an ein mit sensorPacketBuild() erzeugtes Paket anhängen
+ * (SENSOR_FLAG_BATCH muss im Header gesetzt sein)
+ * @param len bisherige Paketlänge
+ * @return neue Gesamtlänge
+ */
+inline int sensorPacketAppendBatch(uint8_t* buf, int len, const SensorBatchSample* samples, uint8_t count) {
+    if (count > SENSOR_BATCH_MAX) count = SENSOR_BATCH_MAX;
+    buf[len] = count;
+    memcpy(buf + len + 1, samples, count * sizeof(SensorBatchSample));
+    return len + 1 + count * sizeof(SensorBatchSample);
+}
+
+/**
+ * Batch-Block kompakt anhängen (SensorCodec); passt er nicht in den Puffer,
+ * wird das feste Format geschrieben (SENSOR_FLAG_BATCH muss gesetzt sein)
+ * @param cap Grösse von buf
+ * @return neue Gesamtlänge
+ */
+inline int sensorPacketAppendBatchCompact(uint8_t* buf, int len, int cap,
+                                          const SensorBatchSample* samples, uint8_t count) {
+    if (count > SENSOR_BATCH_MAX) count = SENSOR_BATCH_MAX;
+    uint8_t& flags = buf[offsetof(SensorPacketHeader, flags)];
+
+    DeltaEncoder enc(buf + len + 1, cap - len - 1, SENSOR_BATCH_FIELDS);
+    bool ok = cap > len;
+    for (uint8_t i = 0; ok && i < count; i++) {
+        int32_t v[SENSOR_BATCH_FIELDS];
+        sensorBatchToFields(samples[i], v);
+        ok = enc.put(v);
+    }
+
+    if (!ok) {
+        flags &= ~SENSOR_FLAG_COMPACT;
+        return sensorPacketAppendBatch(buf, len, samples, count);
+    }
+
+    flags |= SENSOR_FLAG_COMPACT;
+    buf[len] = count;
+    return len + 1 + enc.length();
+}
+
+/**
+ * Gepufferten Messwert i (0 = ältester) lesen, festes oder kompaktes Format
+ */
+inline bool sensorBatchRead(const uint8_t* data, int len, const SensorPacketHeader& hdr,
+                            uint8_t i, SensorBatchSample& out) {
+    if (!(hdr.flags & SENSOR_FLAG_BATCH)) return false;
+
+    int offset = sizeof(hdr) + hdr.payload_len;
+    if (offset >= len) return false;
+
+    uint8_t count = data[offset];
+    if (count > SENSOR_BATCH_MAX || i >= count) return false;
+    offset++;
+
+    if (hdr.flags & SENSOR_FLAG_COMPACT) {
+        // Deltas: alle Datensätze bis i dekodieren
+        DeltaDecoder dec(data + offset, len - offset, SENSOR_BATCH_FIELDS);
+        int32_t v[SENSOR_BATCH_FIELDS];
+        for (uint8_t k = 0; k <= i; k++) {
+            if (!dec.get(v)) return false;
+        }
+        sensorBatchFromFields(v, out);
+        return true;
+    }
+
+    if (offset + count * (int)sizeof(SensorBatchSample) > len) return false;
+    memcpy(&out, data + offset + i * sizeof(SensorBatchSample), sizeof(out));
+    return true;
+}
+
+/**
+ * Anzahl gepufferter Messwerte eines geparsten Pakets
+ * @return 0 ohne SENSOR_FLAG_BATCH oder bei abgeschnittenem/beschädigtem Block
+ */
+inline uint8_t sensorBatchCount(const uint8_t* data, int len, const SensorPacketHeader& hdr) {
+    if (!(hdr.flags & SENSOR_FLAG_BATCH)) return 0;
+
+    int offset = sizeof(hdr) + hdr.payload_len;
+    if (offset >= len) return 0;
+
+    uint8_t count = data[offset];
+    SensorBatchSample last;
+    if (count == 0 || !sensorBatchRead(data, len, hdr, count - 1, last)) return 0;
+    return count;
+}
+
+/**
+ * Gepufferten Messwert i (0 = ältester) lesen
+ */
+inline bool sensorBatchGet(const uint8_t* data, int len, const SensorPacketHeader& hdr,
+                           uint8_t i, SensorBatchSample& out) {
+    return sensorBatchRead(data, len, hdr, i, out);
+}
+
+#endif // SENSOR_PACKET_H
@@ -22,7 +22,9 @@
 #include <ESP8266WiFi.h>
 #include <espnow.h>
 #include <Wire.h>
-#include <SFE_BMP180.h>
+#include "BMP180Fast.h"
+#include "AdaptiveModel.h"
+#include "SensorPacket.h"
 
 #ifdef INDOOR
   #include <AM2321.h>
@@ -38,6 +40,16 @@
 // Für spezifischen Empfänger: {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF}
 uint8_t receiverMAC[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};  // Broadcast
 
+// Senden: auf den Send-Callback warten und bei Fehler mit Jitter wiederholen.
+// Eine Bestätigung (MAC-ACK) gibt es nur bei Unicast; Broadcast meldet immer Erfolg,
+// dann greifen weder Wiederholung noch Kanalsuche.
+#define SEND_ACK_TIMEOUT_MS 30        // Max. Wartezeit auf den Send-Callback
+#define SEND_RETRIES 2                // Wiederholungen nach dem ersten Versuch
+#define SEND_RETRY_JITTER_MS 20       // Zufällige Pause vor einer Wiederholung (1..n ms)
+
+// Kanäle für die Suche, wenn alle Versuche scheitern (Empfänger-AP hat den Kanal gewechselt)
+const uint8_t fallbackChannels[] = {1, 6, 11};
+
 // Sleep Zeit
 #ifdef INDOOR
   #define SLEEP_TIME_SECONDS 60       // Indoor: alle 60 Sekunden
@@ -54,21 +66,56 @@ uint8_t receiverMAC[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};  // Broadcast
 #endif
 #define BATTERY_WARNING_OFFSET 50 // mV Offset für Battery Warning Flag
 
+// BMP180 Oversampling (0..3): höher = genauer, aber längere Wandlung
+#define BMP180_OSS 3                // Normalbetrieb
+#define BMP180_OSS_LOW_BATTERY 0    // Bei Battery Warning: kürzeste Wachzeit
+
 // WiFi Kanal für ESP-NOW (1-13, muss mit Empfänger übereinstimmen!)
 #define ESPNOW_CHANNEL 1
 
+// RF-Kalibrierung: volle Kalibrierung (WAKE_RFCAL) nur alle N Funk-Wakes,
+// dazwischen WAKE_NO_RFCAL (spart die Kalibrierzeit beim Boot)
+#define RFCAL_EVERY 24
+
+// Store-and-Forward (optional): Messwerte im RTC Memory puffern und nur
+// jeden BATCH_SEND_EVERY-ten Wake gesammelt in einem Paket senden.
+// Auf den übrigen Wakes bleibt das Funkmodul aus (WAKE_RF_DISABLED).
+//#define BATCH_MODE
+#define BATCH_SEND_EVERY 4            // Wakes pro Funk-Paket (max. SENSOR_BATCH_MAX + 1)
+#define BATCH_FLUSH_TEMP 1.0          // °C Änderung seit letztem Senden -> sofort senden
+
+// Zeit-Synchronisation: Uhrzeit per Zeit-Beacon der Bridge, dazwischen über clock_sec
+// fortgeschrieben und um die gemessene Gangabweichung des Deep-Sleep-Timers korrigiert
+#define TIME_SYNC_INTERVAL 21600      // Sekunden bis zur nächsten Zeit-Anfrage (6 h)
+#define TIME_BEACON_WAIT_MS 30        // Max. Wartezeit auf das Beacon nach einer Zeit-Anfrage
+#define TIME_DRIFT_MIN_SEC 1800       // Mindestabstand zweier Beacons für die Gang-Korrektur
+
 // Adaptive Sleep Konfiguration
 #define MIN_SLEEP_PERIOD 20           // Minimum 20 Sekunden
 #define TEMP_CHANGE_FAST 1.0          // >= 1°C: Periode verkürzen
 #define TEMP_CHANGE_STABLE 0.5        // < 0.5°C: Periode verlängern
 #define PERIOD_DIVIDER 3              // Faktor zum Verkürzen/Verlängern
 
+// Modellbasierte Periode (AdaptiveModel.h): einkommentieren statt obiger Schwellwert-Regel.
+// Vorher mit echten Logs prüfen (tools/adaptive_sim.cpp, tools/energy_model.cpp): auf der
+// synthetischen Woche weniger Pakete und seltener über der Schranke, aber höherer Maximalfehler
+// beim Einsetzen einer Front als die feste Periode - daher nicht Standard.
+//#define ADAPTIVE_MODEL
+#define MODEL_TEMP_BOUND 0.3          // °C max. Abweichung des gesendeten Werts bis zur nächsten Messung
+#define MODEL_PRESS_BOUND 0.5         // mbar
+#define MODEL_TEMP_NOISE 0.05         // °C Messrauschen BMP180/AM2321
+#define MODEL_PRESS_NOISE 0.05        // mbar
+#define MODEL_TEMP_DRIFT 0.25         // °C/h Änderung der Temperatur-Rate pro Stunde
+#define MODEL_PRESS_DRIFT 0.5         // mbar/h Änderung der Druck-Rate pro Stunde
+#define MODEL_CONFIDENCE 1.5          // Sigma-Faktor
+
 // Standard-Perioden in Sekunden
 #ifdef INDOOR
   #define DEFAULT_PERIOD 60           // Indoor: 60 Sekunden
 #else
   #define DEFAULT_PERIOD 900          // Outdoor: 900 Sekunden (15 Min)
 #endif
+#define MODEL_MAX_PERIOD (2 * DEFAULT_PERIOD) // Längste Periode des Modells bei ruhigem Wetter
 
 // I2C Pins für Sensoren
 #define I2C_SDA 0  // GPIO0
@@ -76,32 +123,59 @@ uint8_t receiverMAC[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};  // Broadcast
 
 // ==================== DATENSTRUKTUR ====================
 
-// Struktur für Sensordaten (max 250 Bytes für ESP-NOW)
-typedef struct sensor_data {
-  uint32_t timestamp;        // Millisekunden seit Start
-  float temperature;         // Temperatur in °C (BMP180 oder AM2321)
-  float pressure;            // Luftdruck in mbar (BMP180)
-  #ifdef INDOOR
-    float humidity;          // Luftfeuchtigkeit in % (nur Indoor: AM2321)
-    uint8_t am2321_readings; // Anzahl Leseversuche AM2321 (nur Indoor)
-  #endif
-  uint16_t battery_voltage;  // Batteriespannung in mV
-  uint16_t duration;         // Messzeit in ms (aus RTC Memory)
-  uint8_t battery_warning;   // 1 = Batterie niedrig, 0 = OK
-  uint8_t sensor_error;      // 0 = OK, >0 = Fehlercode
-  uint8_t reset_reason;      // Grund für letzten Reset
-  uint8_t sensor_type;       // 0 = Outdoor, 1 = Indoor
-  uint16_t sleep_time_sec;   // Aktuelle Sleep-Periode in Sekunden
-} sensor_data;
+// Paket = SensorPacketHeader + Payload des Sensortyps (siehe SensorPacket.h)
+#ifdef INDOOR
+  #define SENSOR_TYPE SENSOR_TYPE_INDOOR
+  typedef SensorPayloadIndoorTimed sensor_payload;
+#else
+  #define SENSOR_TYPE SENSOR_TYPE_OUTDOOR
+  typedef SensorPayloadOutdoorTimed sensor_payload;
+#endif
 
 // RTC Memory Struktur (überlebt Deep Sleep)
 typedef struct {
   uint16_t duration;           // Messzeit in ms
   float last_temperature;      // Letzte Temperatur für Vergleich
   uint16_t current_period;     // Aktuelle Sleep-Periode in Sekunden
-  uint8_t is_valid;            // 0xAA = Daten gültig
+  uint16_t sequence;           // Nächste Paket-Sequenznummer
+  uint8_t seq_reset;           // 1 = Empfänger muss Sequenz neu synchronisieren
+  uint32_t clock_sec;          // Summe der Wach- und Schlafzeiten (Alter gepufferter Messwerte)
+  float sent_temperature;      // Temperatur beim letzten erfolgreichen Senden (Batch)
+  uint8_t rf_off;              // 1 = aktueller Wake ohne Funkmodul gestartet (Batch)
+  uint8_t flush_pending;       // 1 = Neustart mit Funk, um den Puffer zu senden (Batch)
+  uint8_t channel;             // ESP-NOW Kanal (Cache, spart Scan/Konfiguration)
+  uint8_t rfcal_countdown;     // Funk-Wakes bis zur nächsten vollen RF-Kalibrierung
+  uint32_t model_clock;        // clock_sec der letzten Modell-Aktualisierung
+  AdaptiveState model;         // Kalman/Trend-Zustand (ADAPTIVE_MODEL)
+  SensorTimingV1 timing;       // Wachzeit-Phasen des letzten Zyklus (fürs nächste Paket)
+  uint32_t sync_epoch;         // UTC beim letzten Zeit-Beacon (0 = Uhrzeit unbekannt)
+  uint32_t sync_clock;         // clock_sec beim letzten Zeit-Beacon
+  float clock_scale;           // Echte Sekunden pro clock_sec Sekunde (Gang des Timers)
+  uint8_t is_valid;            // RTC_DATA_VALID = Daten gültig
 } rtc_data_t;
 
+#define RTC_DATA_VALID 0xB0    // Bei Layout-Änderungen von rtc_data_t ändern
+
+// Gepufferter Messwert (Batch-Modus)
+typedef struct {
+  uint32_t clock_sec;          // rtcData.clock_sec bei der Messung
+  SensorBatchSample sample;    // age_sec wird erst beim Senden gesetzt
+} rtc_sample_t;
+
+// Ring der gepufferten Messwerte, im RTC Memory direkt hinter rtc_data_t
+typedef struct {
+  uint8_t head;                // Index des ältesten Eintrags
+  uint8_t count;
+  uint8_t reserved[2];
+  rtc_sample_t samples[SENSOR_BATCH_MAX];
+} rtc_batch_t;
+
+#define RTC_BATCH_BLOCK (64 + (sizeof(rtc_data_t) + 3) / 4)
+
+// BMP180 Kalibrierung (eigene Prüfsumme, siehe BMP180Fast.h) hinter dem Batch-Ring
+#define RTC_CALIB_BLOCK (RTC_BATCH_BLOCK + (sizeof(rtc_batch_t) + 3) / 4)
+static_assert((RTC_CALIB_BLOCK - 64) * 4 + sizeof(BMP180Calibration) <= 512, "RTC user memory is 512 bytes");
+
 // ==================== GLOBALE VARIABLEN ====================
 
 extern "C" {
@@ -109,14 +183,34 @@ extern "C" {
 }
 ADC_MODE(ADC_VCC);  // VCC Reading aktivieren
 
-SFE_BMP180 bmp180;
+BMP180Fast bmp180;
+BMP180Calibration bmpCalibration;  // Cache im RTC Memory
 #ifdef INDOOR
   AM2321 am2321;
 #endif
 
-sensor_data sensorData;
+sensor_payload payload;
+#ifdef INDOOR
+  SensorPayloadOutdoorV1& sensorData = payload.data.base;  // Gemeinsame BMP180-Felder
+#else
+  SensorPayloadOutdoorV1& sensorData = payload.data;
+#endif
+uint8_t packetBuffer[sizeof(SensorPacketHeader) + sizeof(sensor_payload) +
+                     1 + SENSOR_BATCH_MAX * sizeof(SensorBatchSample)];
 rtc_data_t rtcData;
+#ifdef BATCH_MODE
+  rtc_batch_t rtcBatch;
+  SensorBatchSample batchOut[SENSOR_BATCH_MAX];
+#endif
+volatile bool sendDone = false;       // Send-Callback ist gelaufen
+volatile bool sendConfirmed = false;  // Send-Callback meldet Erfolg
+volatile bool beaconReceived = false; // Zeit-Beacon empfangen (Receive-Callback)
+TimeBeaconV1 receivedBeacon;
+unsigned long beaconRxMs = 0;         // millis() beim Empfang des Beacons
 unsigned long startTime;
+unsigned long radioStartTime = 0;    // millis() beim Einschalten des Funkmoduls
+SensorTimingV1 phaseTiming;          // Wachzeit-Phasen des aktuellen Zyklus
+unsigned long phaseStart = 0;        // millis() zu Beginn der laufenden Phase
 int batteryProtector = 1;
 uint16_t sleepPeriod = DEFAULT_PERIOD;  // Aktuelle Sleep-Periode in Sekunden
 
@@ -155,41 +249,26 @@ int readAM2321(float &temp, float &hum) {
 #endif
 
 // BMP180 Sensor auslesen
-int readBMP180(double &temp, double &pressure) {
-  char status;
+// Kalibrierung aus dem RTC Memory; nur bei ungültiger Prüfsumme (Power-On) über I2C
+int readBMP180(double &temp, double &pressure, uint8_t oss) {
+  bool calibrationLoaded = false;
 
-  if (!bmp180.begin()) {
+  system_rtc_mem_read(RTC_CALIB_BLOCK, (uint32_t*)&bmpCalibration, sizeof(bmpCalibration));
+  if (!bmp180.begin(bmpCalibration, calibrationLoaded)) {
     if (DEBUG) Serial.println("BMP180 init failed!");
     return 1;
   }
 
-  // Temperatur lesen
-  status = bmp180.startTemperature();
-  if (status == 0) {
-    if (DEBUG) Serial.println("Temperature read error");
-    return 2;
-  }
-  delay(status);
-  status = bmp180.getTemperature(temp);
-  if (status == 0) {
-    if (DEBUG) Serial.println("Temperature retrieve error");
-    return 3;
+  if (calibrationLoaded) {
+    system_rtc_mem_write(RTC_CALIB_BLOCK, (uint32_t*)&bmpCalibration, sizeof(bmpCalibration));
+    if (DEBUG) Serial.println("BMP180 calibration read from sensor and cached");
   }
 
-  // Druck lesen (3 = höchste Auflösung)
-  status = bmp180.startPressure(3);
-  if (status == 0) {
-    if (DEBUG) Serial.println("Pressure read error");
-    return 4;
-  }
-  delay(status);
-  status = bmp180.getPressure(pressure, temp);
-  if (status == 0) {
-    if (DEBUG) Serial.println("Pressure retrieve error");
-    return 5;
+  int error = bmp180.read(oss, temp, pressure);
+  if (error != 0 && DEBUG) {
+    Serial.println(error == 2 ? "Temperature read error" : "Pressure read error");
   }
-
-  return 0;  // Erfolg
+  return error;
 }
 
 // RTC Memory laden
@@ -198,12 +277,31 @@ void loadRTCData() {
   system_rtc_mem_read(64, (uint32_t*)&rtcData, sizeof(rtcData));
 
   // Validierung
-  if (rtcData.is_valid != 0xAA) {
+  if (rtcData.is_valid != RTC_DATA_VALID) {
     // Erste Initialisierung oder ungültige Daten
     rtcData.duration = 0;
     rtcData.last_temperature = 20.0;  // Annahme: 20°C als Start
     rtcData.current_period = DEFAULT_PERIOD;
-    rtcData.is_valid = 0xAA;
+    rtcData.sequence = 0;
+    rtcData.seq_reset = 1;
+    rtcData.clock_sec = 0;
+    rtcData.sent_temperature = rtcData.last_temperature;
+    rtcData.rf_off = 0;
+    rtcData.flush_pending = 0;
+    rtcData.channel = ESPNOW_CHANNEL;
+    rtcData.rfcal_countdown = RFCAL_EVERY;  // Power-On hat gerade voll kalibriert
+    rtcData.model_clock = 0;
+    AdaptiveModel::reset(rtcData.model);
+    memset(&rtcData.timing, 0, sizeof(rtcData.timing));
+    rtcData.sync_epoch = 0;
+    rtcData.sync_clock = 0;
+    rtcData.clock_scale = 1.0f;
+    rtcData.is_valid = RTC_DATA_VALID;
+
+    #ifdef BATCH_MODE
+      rtcBatch.head = 0;
+      rtcBatch.count = 0;
+    #endif
 
     if (DEBUG) Serial.println("RTC Data initialized");
   } else {
@@ -214,15 +312,92 @@ void loadRTCData() {
       Serial.print(rtcData.current_period);
       Serial.println("s");
     }
+
+    if (rtcData.channel < 1 || rtcData.channel > 13) rtcData.channel = ESPNOW_CHANNEL;
+    if (!(rtcData.clock_scale > 0.8f && rtcData.clock_scale < 1.25f)) rtcData.clock_scale = 1.0f;
+
+    #ifdef BATCH_MODE
+      system_rtc_mem_read(RTC_BATCH_BLOCK, (uint32_t*)&rtcBatch, sizeof(rtcBatch));
+      if (rtcBatch.count > SENSOR_BATCH_MAX || rtcBatch.head >= SENSOR_BATCH_MAX) {
+        rtcBatch.head = 0;
+        rtcBatch.count = 0;
+      }
+      if (DEBUG) {
+        Serial.print("Batch: ");
+        Serial.print(rtcBatch.count);
+        Serial.println(" samples buffered");
+      }
+    #endif
+  }
+}
+
+// Wake-Option für den nächsten Boot: Funk aus, ohne oder mit RF-Kalibrierung
+uint8_t nextWakeOption(bool radioNeeded) {
+  if (!radioNeeded) return WAKE_RF_DISABLED;
+
+  if (rtcData.rfcal_countdown == 0) {
+    rtcData.rfcal_countdown = RFCAL_EVERY;
+    return WAKE_RFCAL;
   }
+  rtcData.rfcal_countdown--;
+  return WAKE_NO_RFCAL;
 }
 
 // RTC Memory speichern
 void saveRTCData() {
-  rtcData.is_valid = 0xAA;
+  rtcData.is_valid = RTC_DATA_VALID;
   system_rtc_mem_write(64, (uint32_t*)&rtcData, sizeof(rtcData));
+  #ifdef BATCH_MODE
+    system_rtc_mem_write(RTC_BATCH_BLOCK, (uint32_t*)&rtcBatch, sizeof(rtcBatch));
+  #endif
+}
+
+#ifdef BATCH_MODE
+// Messwert in den Ring legen; bei vollem Ring wird der älteste überschrieben
+void batchPush(float temp, float press, float hum, uint16_t battery) {
+  uint8_t idx;
+  if (rtcBatch.count < SENSOR_BATCH_MAX) {
+    idx = (rtcBatch.head + rtcBatch.count) % SENSOR_BATCH_MAX;
+    rtcBatch.count++;
+  } else {
+    idx = rtcBatch.head;
+    rtcBatch.head = (rtcBatch.head + 1) % SENSOR_BATCH_MAX;
+  }
+
+  rtc_sample_t& s = rtcBatch.samples[idx];
+  s.clock_sec = rtcData.clock_sec;
+  s.sample.age_sec = 0;
+  s.sample.temperature = (int16_t)lroundf(temp * 100.0f);
+  s.sample.pressure = (uint16_t)lroundf(press * 10.0f);
+  s.sample.humidity = (hum >= 0) ? (uint16_t)lroundf(hum * 100.0f) : SENSOR_BATCH_NO_HUMIDITY;
+  s.sample.battery_voltage = battery;
+}
+
+// Ring ins Sendeformat kopieren (ältester zuerst), Alter relativ zu jetzt
+uint8_t batchCollect(SensorBatchSample* out) {
+  for (uint8_t i = 0; i < rtcBatch.count; i++) {
+    const rtc_sample_t& s = rtcBatch.samples[(rtcBatch.head + i) % SENSOR_BATCH_MAX];
+    // Alter in echten Sekunden (Gang-Korrektur aus der Zeit-Synchronisation)
+    uint32_t age = lroundf((rtcData.clock_sec - s.clock_sec) * rtcData.clock_scale);
+    out[i] = s.sample;
+    out[i].age_sec = (age > 0xFFFF) ? 0xFFFF : age;
+  }
+  return rtcBatch.count;
+}
+
+// Muss dieser Wake senden? (Puffer voll, starke Änderung oder dringender Zustand)
+bool batchShouldSend(float temp, bool urgent) {
+  if (urgent || rtcData.flush_pending) return true;
+  if (rtcBatch.count + 1 >= BATCH_SEND_EVERY) return true;
+  return fabs(temp - rtcData.sent_temperature) >= BATCH_FLUSH_TEMP;
 }
 
+// Braucht der nächste Wake planmässig das Funkmodul?
+bool batchNextWakeSends() {
+  return rtcData.flush_pending || rtcData.seq_reset || rtcBatch.count + 1 >= BATCH_SEND_EVERY;
+}
+#endif
+
 // Adaptive Sleep-Periode berechnen
 uint16_t calculateAdaptivePeriod(float current_temp, float last_temp, uint16_t current_period) {
   // DEBUG Mode: immer 20 Sekunden
@@ -288,22 +463,198 @@ uint16_t calculateAdaptivePeriod(float current_temp, float last_temp, uint16_t c
   return new_period;
 }
 
+#ifdef ADAPTIVE_MODEL
+// Modellbasierte Sleep-Periode (Kalman-Filter auf Temperatur und Druck)
+uint16_t calculateModelPeriod(float temp, float press, bool useSample) {
+  static const AdaptiveConfig config = {
+    MODEL_TEMP_BOUND, MODEL_PRESS_BOUND, MODEL_TEMP_NOISE, MODEL_PRESS_NOISE,
+    MODEL_TEMP_DRIFT, MODEL_PRESS_DRIFT, MODEL_CONFIDENCE, MIN_SLEEP_PERIOD, MODEL_MAX_PERIOD
+  };
+  AdaptiveModel model(config);
+
+  // Fehlmessungen und Messungen vor einem Funk-Neustart nicht ins Modell übernehmen
+  if (useSample) {
+    model.update(rtcData.model, temp, press, rtcData.clock_sec - rtcData.model_clock);
+    rtcData.model_clock = rtcData.clock_sec;
+  }
+
+  if (DEBUG) {
+    if (DEBUG) Serial.println("DEBUG Mode: Fixed 20s period");
+    return 20;
+  }
+  if (batteryProtector > 1) {
+    if (DEBUG) Serial.println("Battery Protection: No adaptation");
+    return DEFAULT_PERIOD;
+  }
+
+  // Schranke gilt für den gesendeten Rohwert, den der Empfänger hält;
+  // ohne gültige Messung gegen den Schätzwert des Modells
+  uint16_t period = useSample ? model.nextPeriod(rtcData.model, temp, press)
+                              : model.nextPeriod(rtcData.model, rtcData.model.temp.value,
+                                                 rtcData.model.press.value);
+  if (DEBUG) {
+    Serial.print("Model: ");
+    Serial.print(rtcData.model.temp.rate * 3600.0f, 2);
+    Serial.print("°C/h, ");
+    Serial.print(rtcData.model.press.rate * 3600.0f, 2);
+    Serial.print(" mbar/h -> ");
+    Serial.print(period);
+    Serial.println("s");
+  }
+  return period;
+}
+#endif
+
+// ==================== UHRZEIT ====================
+
+// Lokale Uhr in Sekunden (Deep-Sleep-Zeiten + aktueller Wake)
+uint32_t localClock(unsigned long ms) {
+  return rtcData.clock_sec + ms / 1000;
+}
+
+// Aktuelle UTC-Zeit, 0 solange kein Zeit-Beacon empfangen wurde
+uint32_t timeNow() {
+  if (rtcData.sync_epoch == 0) return 0;
+  uint32_t elapsed = localClock(millis()) - rtcData.sync_clock;
+  return rtcData.sync_epoch + (uint32_t)lroundf(elapsed * rtcData.clock_scale);
+}
+
+// Zeit-Anfrage fällig? (noch nie synchronisiert oder letzter Abgleich zu alt)
+bool timeSyncDue() {
+  return rtcData.sync_epoch == 0 ||
+         localClock(millis()) - rtcData.sync_clock >= TIME_SYNC_INTERVAL;
+}
+
+// Empfangenes Beacon übernehmen; bei genügend Abstand zum letzten den Gang nachführen
+void applyTimeBeacon() {
+  if (receivedBeacon.source_age_sec == 0xFFFF) return;  // Bridge-Zeit zu alt
+
+  uint32_t epoch = receivedBeacon.epoch + (receivedBeacon.epoch_ms + 500) / 1000;
+  uint32_t local = localClock(beaconRxMs);
+
+  if (rtcData.sync_epoch != 0) {
+    uint32_t dLocal = local - rtcData.sync_clock;
+    // Zu kurzer Abstand: Anker behalten, sonst wird die Gang-Messung nie lang genug
+    if (dLocal < TIME_DRIFT_MIN_SEC) return;
+
+    float ratio = (float)(int32_t)(epoch - rtcData.sync_epoch) / dLocal;
+    if (ratio > 0.8f && ratio < 1.25f) {
+      rtcData.clock_scale += 0.5f * (ratio - rtcData.clock_scale);
+    }
+    if (DEBUG) {
+      Serial.print("Time: clock ratio ");
+      Serial.print(ratio, 4);
+      Serial.print(", scale ");
+      Serial.println(rtcData.clock_scale, 4);
+    }
+  }
+
+  rtcData.sync_epoch = epoch;
+  rtcData.sync_clock = local;
+  if (DEBUG) {
+    Serial.print("Time: synced to ");
+    Serial.print(epoch);
+    Serial.println(" UTC");
+  }
+}
+
+// ESP-NOW Receive Callback (nur Zeit-Beacons, alles andere wird ignoriert)
+void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t len) {
+  TimeBeaconV1 beacon;
+  if (beaconReceived || !sensorTimeBeaconParse(data, len, beacon)) return;
+  receivedBeacon = beacon;
+  beaconRxMs = millis();
+  beaconReceived = true;
+}
+
 // ESP-NOW Send Callback
 void onDataSent(uint8_t *mac_addr, uint8_t sendStatus) {
   if (DEBUG) {
     Serial.print("Send Status: ");
     Serial.println(sendStatus == 0 ? "Success" : "Failed");
   }
+  // Erstes Paket nach RTC-Verlust ist raus: Empfänger hat die neue Sequenz
+  if (sendStatus == 0) {
+    rtcData.seq_reset = 0;
+    sendConfirmed = true;
+  }
+  sendDone = true;
+}
+
+// Paket einmal senden und auf den Send-Callback warten
+bool sendOnce(int len) {
+  sendDone = false;
+  sendConfirmed = false;
+  if (esp_now_send(receiverMAC, packetBuffer, len) != 0) return false;
+
+  unsigned long start = millis();
+  while (!sendDone && millis() - start < SEND_ACK_TIMEOUT_MS) {
+    delay(1);
+  }
+  return sendConfirmed;
+}
+
+// Senden mit begrenzten Wiederholungen; der Versuch steht in den Header-Flags
+bool sendWithRetry(int len) {
+  for (uint8_t attempt = 0; attempt <= SEND_RETRIES; attempt++) {
+    if (attempt > 0) delay(1 + ESP.random() % SEND_RETRY_JITTER_MS);
+    sensorPacketSetRetry(packetBuffer, attempt);
+    if (sendOnce(len)) return true;
+
+    if (DEBUG) {
+      Serial.print("Send attempt ");
+      Serial.print(attempt + 1);
+      Serial.println(" failed");
+    }
+  }
+  return false;
+}
+
+// Alle Versuche gescheitert: Fallback-Kanäle durchprobieren, Treffer im RTC merken
+bool sendOnFallbackChannels(int len) {
+  sensorPacketSetRetry(packetBuffer, SENSOR_RETRY_MAX);
+
+  for (uint8_t i = 0; i < sizeof(fallbackChannels); i++) {
+    uint8_t ch = fallbackChannels[i];
+    if (ch == rtcData.channel) continue;
+
+    wifi_set_channel(ch);
+    esp_now_del_peer(receiverMAC);
+    esp_now_add_peer(receiverMAC, ESP_NOW_ROLE_SLAVE, ch, NULL, 0);
+
+    if (sendOnce(len)) {
+      if (DEBUG) {
+        Serial.print("Receiver found on channel ");
+        Serial.println(ch);
+      }
+      rtcData.channel = ch;
+      return true;
+    }
+  }
+  return false;
 }
 
 // ==================== SETUP ====================
 
+// Läuft vor setup(): WiFi nicht automatisch starten, das Funkmodul bleibt
+// während der Sensor-Messung aus und wird erst zum Senden geweckt
+void preinit() {
+  ESP8266WiFiClass::preinitWiFiOff();
+}
+
 void setup() {
   startTime = millis();
 
   // Variablen deklarieren (vor goto Label)
   int addPeerResult = 0;
-  uint8_t sendResult = 0;
+  bool sent = false;
+  uint8_t packetFlags = 0;
+  int packetLen = 0;
+  uint8_t batchCount = 0;
+  bool bufferSample = false;    // Batch: aktuellen Messwert beim Schlafengehen puffern
+  bool rebootForRadio = false;  // Batch: sofort mit Funkmodul neu starten
+  bool batchSend = false;       // Batch: dieser Wake muss senden
+  bool timeRequest = false;     // Paket fragt nach einem Zeit-Beacon
 
   // Serielle Kommunikation starten (nur wenn DEBUG)
   if (DEBUG) {
@@ -328,6 +679,15 @@ void setup() {
   if (batteryVoltage < BATTERY_LIMIT) {
     if (DEBUG) Serial.println("Battery critical! Going to extended sleep...");
     batteryProtector = BATTERY_EXTRA_CYCLES;
+    // Uhr weiterführen (Alter gepufferter Messwerte, Zeitschritt des Modells)
+    loadRTCData();
+    #ifdef INDOOR
+      rtcData.clock_sec += SLEEP_TIME_SECONDS * batteryProtector;
+    #else
+      rtcData.clock_sec += SLEEP_TIME_MINUTES * 60UL * batteryProtector;
+    #endif
+    rtcData.rf_off = 0;
+    saveRTCData();
     system_deep_sleep_set_option(WAKE_RFCAL);
     #ifdef INDOOR
       system_deep_sleep(SLEEP_TIME_SECONDS * batteryProtector * 1000000UL);
@@ -359,7 +719,16 @@ void setup() {
 
   // Sensoren auslesen
   double temp = 0, press = 0;
-  int sensorError = readBMP180(temp, press);
+  // Bei Battery Warning mit niedrigem Oversampling: kürzere Wandlung
+  unsigned long sensorStart = millis();
+  phaseStart = sensorStart;
+  int sensorError = readBMP180(temp, press,
+                               batteryVoltage < (BATTERY_LIMIT + BATTERY_WARNING_OFFSET) ? BMP180_OSS_LOW_BATTERY : BMP180_OSS);
+  if (DEBUG) {
+    Serial.print("BMP180 read: ");
+    Serial.print(millis() - sensorStart);
+    Serial.println(" ms");
+  }
 
   #ifdef INDOOR
     // Indoor: auch AM2321 auslesen
@@ -390,7 +759,9 @@ void setup() {
     if (tempAM2321 > -990.0) {
       temp = tempAM2321;
     }
+    phaseTiming.sensor_ms = millis() - phaseStart;
   #else
+    phaseTiming.sensor_ms = millis() - phaseStart;
     // Outdoor: nur BMP180
     if (DEBUG) {
       Serial.println("\n--- Sensor Data (Outdoor) ---");
@@ -405,8 +776,20 @@ void setup() {
     }
   #endif
 
+  #ifdef BATCH_MODE
+    // Vor der Modell-Aktualisierung entscheiden: bei einem Neustart für das Funkmodul
+    // wird danach frisch gemessen, ein zweites Update mit dt≈0 würde die Varianz drücken
+    batchSend = batchShouldSend((float)temp, batteryVoltage < (BATTERY_LIMIT + BATTERY_WARNING_OFFSET) ||
+                                             sensorError != 0 || rtcData.seq_reset);
+    rebootForRadio = batchSend && rtcData.rf_off;
+  #endif
+
   // Adaptive Sleep-Periode berechnen
-  sleepPeriod = calculateAdaptivePeriod((float)temp, rtcData.last_temperature, rtcData.current_period);
+  #ifdef ADAPTIVE_MODEL
+    sleepPeriod = calculateModelPeriod((float)temp, (float)press, sensorError == 0 && !rebootForRadio);
+  #else
+    sleepPeriod = calculateAdaptivePeriod((float)temp, rtcData.last_temperature, rtcData.current_period);
+  #endif
 
   if (DEBUG) {
     Serial.println("\n--- Adaptive Sleep ---");
@@ -429,11 +812,8 @@ void setup() {
   sensorData.temperature = (float)temp;
   sensorData.pressure = (float)press;
   #ifdef INDOOR
-    sensorData.humidity = humidity;
-    sensorData.am2321_readings = am2321Readings;
-    sensorData.sensor_type = 1;  // Indoor
-  #else
-    sensorData.sensor_type = 0;  // Outdoor
+    payload.data.humidity = humidity;
+    payload.data.am2321_readings = am2321Readings;
   #endif
   sensorData.battery_voltage = batteryVoltage;
   sensorData.duration = rtcData.duration;
@@ -441,13 +821,37 @@ void setup() {
   sensorData.sensor_error = sensorError;
   sensorData.reset_reason = resetReason;
   sensorData.sleep_time_sec = sleepPeriod;  // Aktuelle Sleep-Periode für dynamische Timeouts
+  payload.timing = rtcData.timing;          // Phasen des vorherigen Zyklus (wie duration)
+  payload.epoch = timeNow();                // Messzeitpunkt (0 = noch nicht synchronisiert)
+
+  #ifdef BATCH_MODE
+    // Bis zum erfolgreichen Senden gilt der Messwert als gepuffert
+    bufferSample = true;
+
+    if (!batchSend) {
+      if (DEBUG) Serial.println("Batch: sample buffered, radio stays off");
+      goto sleep_now;
+    }
 
-  // WiFi im Station Mode starten (erforderlich für ESP-NOW)
+    if (rebootForRadio) {
+      // Wake lief ohne Funkmodul: mit Funk neu starten, dort wird frisch gemessen und gesendet
+      if (DEBUG) Serial.println("Batch: flush needed, restarting with radio");
+      rtcData.flush_pending = 1;
+      bufferSample = false;
+      goto sleep_now;
+    }
+  #endif
+
+  // Funkmodul erst jetzt aufwecken; Station Mode ist für ESP-NOW erforderlich.
+  // persistent(false): keine Flash-Schreibzugriffe für die WiFi-Konfiguration bei jedem Wake
+  radioStartTime = millis();
+  WiFi.persistent(false);
+  WiFi.forceSleepWake();
+  delay(1);
   WiFi.mode(WIFI_STA);
-  WiFi.disconnect();
 
-  // WiFi Kanal setzen
-  wifi_set_channel(ESPNOW_CHANNEL);
+  // WiFi Kanal aus dem RTC Cache setzen
+  wifi_set_channel(rtcData.channel);
 
   if (DEBUG) {
     Serial.print("WiFi Channel: ");
@@ -462,14 +866,17 @@ void setup() {
     goto sleep_now;
   }
 
-  // ESP-NOW Rolle setzen
-  esp_now_set_self_role(ESP_NOW_ROLE_CONTROLLER);
+  // ESP-NOW Rolle setzen; mit Zeit-Anfrage auch empfangen (Beacon der Bridge)
+  timeRequest = timeSyncDue();
+  esp_now_set_self_role(timeRequest ? ESP_NOW_ROLE_COMBO : ESP_NOW_ROLE_CONTROLLER);
 
-  // Callback registrieren
+  // Callbacks registrieren
   esp_now_register_send_cb(onDataSent);
+  esp_now_register_recv_cb(onDataRecv);
 
   // Empfänger hinzufügen
-  addPeerResult = esp_now_add_peer(receiverMAC, ESP_NOW_ROLE_SLAVE, ESPNOW_CHANNEL, NULL, 0);
+  // Peer-Liste liegt im RAM und muss nach jedem Deep Sleep neu angelegt werden (kein Funkverkehr)
+  addPeerResult = esp_now_add_peer(receiverMAC, ESP_NOW_ROLE_SLAVE, rtcData.channel, NULL, 0);
   if (addPeerResult != 0) {
     if (DEBUG) {
       Serial.print("Failed to add peer, error: ");
@@ -487,24 +894,72 @@ void setup() {
     }
     Serial.println();
     Serial.print("Data size: ");
-    Serial.print(sizeof(sensorData));
+    Serial.print(sizeof(SensorPacketHeader) + sizeof(payload));
     Serial.println(" bytes");
   }
 
-  sendResult = esp_now_send(receiverMAC, (uint8_t *)&sensorData, sizeof(sensorData));
+  // Header + Payload; Sequenz läuft auch bei Sendefehlern weiter (Empfänger zählt die Lücke)
+  if (sensorData.battery_warning) packetFlags |= SENSOR_FLAG_BATTERY_LOW;
+  if (rtcData.seq_reset) packetFlags |= SENSOR_FLAG_SEQ_RESET;
+  if (timeRequest) packetFlags |= SENSOR_FLAG_TIME_REQUEST;
+  #ifdef BATCH_MODE
+    batchCount = batchCollect(batchOut);
+    if (batchCount > 0) packetFlags |= SENSOR_FLAG_BATCH;
+  #endif
+  packetLen = sensorPacketBuild(packetBuffer, SENSOR_TYPE, packetFlags, rtcData.sequence++,
+                                &payload, sizeof(payload));
+  if (batchCount > 0) {
+    // Gepufferte Messwerte hinter der Payload, Delta/Varint kodiert (siehe SensorPacket.h)
+    packetLen = sensorPacketAppendBatchCompact(packetBuffer, packetLen, sizeof(packetBuffer),
+                                               batchOut, batchCount);
+    if (DEBUG) {
+      Serial.print("Batch: ");
+      Serial.print(batchCount);
+      Serial.print(" buffered samples, packet ");
+      Serial.print(packetLen);
+      Serial.println(" bytes");
+    }
+  }
+
+  // Statt fester Wartezeit: fertig sobald der Send-Callback Erfolg meldet
+  phaseTiming.radio_init_ms = millis() - radioStartTime;
+  phaseStart = millis();
+  sent = sendWithRetry(packetLen) || sendOnFallbackChannels(packetLen);
+
+  // Zeit-Anfrage: Bridge antwortet sofort, kurz auf das Beacon warten
+  if (sent && timeRequest) {
+    unsigned long waitStart = millis();
+    while (!beaconReceived && millis() - waitStart < TIME_BEACON_WAIT_MS) {
+      delay(1);
+    }
+  }
+  if (beaconReceived) applyTimeBeacon();
+  phaseTiming.send_ms = millis() - phaseStart;
 
   if (DEBUG) {
     Serial.print("Send result: ");
-    Serial.println(sendResult == 0 ? "Queued" : "Failed");
+    Serial.println(sent ? "Confirmed" : "Failed");
+    if (timeRequest) {
+      Serial.print("Time request: ");
+      Serial.println(beaconReceived ? "beacon received" : "no beacon");
+    }
   }
 
-  // Kurz warten damit Daten gesendet werden
-  delay(100);
+  #ifdef BATCH_MODE
+    if (sent) {
+      // Puffer ist beim Empfänger; sonst bleibt alles für den nächsten Versuch im Ring
+      rtcBatch.head = 0;
+      rtcBatch.count = 0;
+      rtcData.sent_temperature = sensorData.temperature;
+      rtcData.flush_pending = 0;
+      bufferSample = false;
+    }
+  #endif
 
 sleep_now:
   // Duration speichern in RTC Memory
-  rtcData.duration = millis() - startTime;
-  saveRTCData();
+  phaseStart = millis();
+  rtcData.duration = phaseStart - startTime;
 
   // Tatsächliche Sleep-Zeit berechnen
   uint32_t actualSleepTime;
@@ -523,10 +978,43 @@ sleep_now:
     actualSleepTime = sleepPeriod;
   }
 
+  #ifdef BATCH_MODE
+    if (bufferSample) {
+      #ifdef INDOOR
+        batchPush(sensorData.temperature, sensorData.pressure, payload.data.humidity, sensorData.battery_voltage);
+      #else
+        batchPush(sensorData.temperature, sensorData.pressure, -1, sensorData.battery_voltage);
+      #endif
+    }
+
+    // Funkmodul nur für planmässige Sende-Wakes einschalten
+    rtcData.rf_off = batchNextWakeSends() ? 0 : 1;
+  #endif
+
+  // Uhr weiterführen; beim Neustart für das Funkmodul vergeht keine Schlafzeit
+  if (rebootForRadio) actualSleepTime = 0;
+  rtcData.clock_sec += actualSleepTime + (rtcData.duration + 500) / 1000;
+
+  uint8_t wakeOption = nextWakeOption(!rtcData.rf_off);
+
+  // Phasen fürs nächste Paket (Funk-Phasen bleiben 0, wenn das Modul aus blieb)
+  phaseTiming.boot_ms = startTime;
+  phaseTiming.sleep_setup_ms = millis() - phaseStart;
+  rtcData.timing = phaseTiming;
+  saveRTCData();
+
   if (DEBUG) {
     Serial.print("\nTotal duration: ");
     Serial.print(rtcData.duration);
-    Serial.println(" ms");
+    Serial.print(" ms (radio on: ");
+    Serial.print(radioStartTime ? millis() - radioStartTime : 0);
+    Serial.println(" ms)");
+    Serial.printf("Phases: boot %u, sensor %u, radio init %u, send %u, sleep setup %u ms\n",
+                  phaseTiming.boot_ms, phaseTiming.sensor_ms, phaseTiming.radio_init_ms,
+                  phaseTiming.send_ms, phaseTiming.sleep_setup_ms);
+    Serial.print("Next wake: ");
+    Serial.println(wakeOption == WAKE_RF_DISABLED ? "radio off" :
+                   wakeOption == WAKE_RFCAL ? "RF calibration" : "no RF calibration");
     Serial.print("Going to sleep for ");
     Serial.print(actualSleepTime);
     Serial.print(" seconds");
@@ -542,7 +1030,11 @@ sleep_now:
   }
 
   // Deep Sleep mit adaptiver Periode
-  system_deep_sleep_set_option(WAKE_RFCAL);
+  system_deep_sleep_set_option(wakeOption);
+  if (rebootForRadio) {
+    system_deep_sleep(1);  // 0 hiesse "für immer"
+    delay(1000);
+  }
   system_deep_sleep(actualSleepTime * 1000000UL);
 
   delay(1000);  // Sollte nie erreicht werden
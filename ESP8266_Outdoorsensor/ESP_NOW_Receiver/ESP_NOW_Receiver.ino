@@ -9,6 +9,7 @@
 
 #include <ESP8266WiFi.h>
 #include <espnow.h>
+#include "SensorIngest.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -16,45 +17,46 @@
 #define ESPNOW_CHANNEL 1
 
 // ==================== DATENSTRUKTUR ====================
-// Universal-Struktur für Indoor und Outdoor
-
-typedef struct sensor_data_indoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  float humidity;           // Nur bei Indoor
-  uint8_t am2321_readings;  // Nur bei Indoor
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;      // 0=Outdoor, 1=Indoor
-  uint16_t sleep_time_sec;  // Sleep-Periode in Sekunden
-} sensor_data_indoor;
-
-typedef struct sensor_data_outdoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;      // 0=Outdoor, 1=Indoor
-  uint16_t sleep_time_sec;  // Sleep-Periode in Sekunden
-} sensor_data_outdoor;
-
-sensor_data_indoor dataIndoor;
-sensor_data_outdoor dataOutdoor;
+// Pakete (mit Header und Legacy), Schemas und Geräte-Tabelle: siehe SensorIngest.h
+
+SensorIngest ingest;
+
+SensorSample dataIndoor;
+SensorSample dataOutdoor;
 unsigned long lastReceiveTime = 0;
 int packetsReceived = 0;
 
 // ==================== FUNKTIONEN ====================
 
+// Batch-Paket: gepufferte Messwerte mit ihrem Alter ausgeben
+void printBatch(const SensorDevice& dev, const uint8_t* data, int len) {
+  uint8_t count = SensorIngest::getBatchCount(dev, data, len);
+  if (count == 0) return;
+
+  Serial.printf("Batch: %u buffered samples\n", count);
+  SensorSample sample;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!SensorIngest::getBatchSample(dev, data, len, i, sample)) break;
+    Serial.printf("  %5us ago: %.2f°C, %.1f mbar", sample.age_sec, sample.temperature, sample.pressure);
+    if (sample.hasHumidity) Serial.printf(", %.1f%%", sample.humidity);
+    Serial.printf(", %u mV\n", sample.battery_voltage);
+  }
+}
+
+// Wachzeit-Phasen des vorherigen Sensor-Zyklus (nur neuere Sensor-Firmware)
+void printTiming(const SensorSample& sample) {
+  if (!sample.hasTiming) return;
+  Serial.printf("Phases: boot %u, sensor %u, radio init %u, send %u, sleep setup %u ms\n",
+                sample.timing.boot_ms, sample.timing.sensor_ms, sample.timing.radio_init_ms,
+                sample.timing.send_ms, sample.timing.sleep_setup_ms);
+  if (sample.epoch) Serial.printf("Measured at: %lu UTC\n", (unsigned long)sample.epoch);
+}
+
 // ESP-NOW Receive Callback
 void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t data_len) {
+  // Zeit-Beacons der Bridge sind keine Messwerte
+  if (sensorPacketIsControl(data, data_len)) return;
+
   packetsReceived++;
 
   Serial.println("\n========================================");
@@ -69,14 +71,25 @@ void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t data_len) {
   }
   Serial.println();
 
-  // Sensor-Typ erkennen (letztes Byte der Daten = sensor_type)
-  // Outdoor: 20 bytes, Indoor: 25 bytes
-  bool isIndoor = (data_len >= sizeof(sensor_data_indoor));
+  // Sensor-Typ aus Paket-Header bzw. Geräte-Tabelle (ESP8266 liefert kein RSSI)
+  SensorDevice* dev = ingest.ingest(mac_addr, data, data_len, 0, millis());
+  if (!dev) {
+    Serial.println("Unknown packet format, duplicate or device table full - dropped");
+    Serial.println("========================================\n");
+    return;
+  }
+  dev->hasNewData = false;
+  bool isIndoor = (dev->schema == SCHEMA_INDOOR);
+
+  if (dev->versioned) {
+    Serial.printf("Sequence: %u (lost so far: %u)\n", dev->lastSequence, dev->link.lost);
+  }
+  printBatch(*dev, data, data_len);
 
   Serial.print("Sensor Type: ");
   if (isIndoor) {
     Serial.println("INDOOR (BMP180 + AM2321)");
-    memcpy(&dataIndoor, data, min((int)sizeof(dataIndoor), data_len));
+    dataIndoor = dev->last;
 
     // Daten anzeigen
     Serial.println("\n--- Sensor Data (Indoor) ---");
@@ -112,6 +125,7 @@ void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t data_len) {
     Serial.print("Duration: ");
     Serial.print(dataIndoor.duration);
     Serial.println(" ms");
+    printTiming(dataIndoor);
 
     Serial.print("Sensor Error: ");
     Serial.println(dataIndoor.sensor_error);
@@ -125,7 +139,7 @@ void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t data_len) {
 
   } else {
     Serial.println("OUTDOOR (BMP180 only)");
-    memcpy(&dataOutdoor, data, min((int)sizeof(dataOutdoor), data_len));
+    dataOutdoor = dev->last;
 
     // Daten anzeigen
     Serial.println("\n--- Sensor Data (Outdoor) ---");
@@ -154,6 +168,7 @@ void onDataRecv(uint8_t *mac_addr, uint8_t *data, uint8_t data_len) {
     Serial.print("Duration: ");
     Serial.print(dataOutdoor.duration);
     Serial.println(" ms");
+    printTiming(dataOutdoor);
 
     Serial.print("Sensor Error: ");
     Serial.println(dataOutdoor.sensor_error);
@@ -7,6 +7,7 @@
  * Unterstützt:
  * - Outdoor-Sensor (nur BMP180)
  * - Indoor-Sensor (BMP180 + AM2321 mit Luftfeuchtigkeit)
+ * - Beliebig viele Sensoren je Typ (Geräte-Tabelle nach MAC, SensorIngest.h)
  *
  * HINWEIS: ESP32 verwendet eine andere ESP-NOW API als ESP8266!
  */
@@ -14,6 +15,8 @@
 #include <WiFi.h>
 #include <esp_now.h>
 #include <esp_wifi.h>
+#include "SensorIngest.h"
+#include "FrameRing.h"
 
 // ==================== KONFIGURATION ====================
 
@@ -21,71 +24,101 @@
 #define ESPNOW_CHANNEL 1
 
 // ==================== DATENSTRUKTUR ====================
-// Universal-Struktur für Indoor und Outdoor
-
-typedef struct sensor_data_indoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  float humidity;           // Nur bei Indoor
-  uint8_t am2321_readings;  // Nur bei Indoor
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;      // 0=Outdoor, 1=Indoor
-  uint16_t sleep_time_sec;  // Sleep-Periode in Sekunden
-} sensor_data_indoor;
-
-typedef struct sensor_data_outdoor {
-  uint32_t timestamp;
-  float temperature;
-  float pressure;
-  uint16_t battery_voltage;
-  uint16_t duration;
-  uint8_t battery_warning;
-  uint8_t sensor_error;
-  uint8_t reset_reason;
-  uint8_t sensor_type;      // 0=Outdoor, 1=Indoor
-  uint16_t sleep_time_sec;  // Sleep-Periode in Sekunden
-} sensor_data_outdoor;
-
-sensor_data_indoor dataIndoor;
-sensor_data_outdoor dataOutdoor;
+// Pakete, Schemas und Geräte-Tabelle: siehe SensorIngest.h
+
+SensorIngest ingest;
+
+// Empfangs-Ring: Callback -> loop() (Arduino Loop-Task als Worker)
+FrameRing<> frameRing;
+TaskHandle_t workerTaskHandle = nullptr;
+
+SensorSample dataIndoor;
+SensorSample dataOutdoor;
 unsigned long lastReceiveTime = 0;
 int receivedPackets = 0;
 
 // ==================== FUNKTIONEN ====================
 
 // ESP-NOW Receive Callback (ESP32 Version - neue API)
+// Läuft im WiFi-Task: nur kopieren und loop() wecken
 void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int data_len) {
+  frameRing.push(recv_info->src_addr, data, data_len, recv_info->rx_ctrl->rssi, millis());
+  if (workerTaskHandle) xTaskNotifyGive(workerTaskHandle);
+}
+
+// Batch-Paket: gepufferte Messwerte mit ihrem Alter ausgeben
+void printBatch(const SensorDevice& dev, const uint8_t* data, int len) {
+  uint8_t count = SensorIngest::getBatchCount(dev, data, len);
+  if (count == 0) return;
+
+  Serial.printf("Batch: %u buffered samples\n", count);
+  SensorSample sample;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!SensorIngest::getBatchSample(dev, data, len, i, sample)) break;
+    Serial.printf("  %5us ago: %.2f°C, %.1f mbar", sample.age_sec, sample.temperature, sample.pressure);
+    if (sample.hasHumidity) Serial.printf(", %.1f%%", sample.humidity);
+    Serial.printf(", %u mV\n", sample.battery_voltage);
+  }
+}
+
+// Wachzeit-Phasen des vorherigen Sensor-Zyklus (nur neuere Sensor-Firmware)
+void printTiming(const SensorSample& sample) {
+  if (!sample.hasTiming) return;
+  Serial.printf("Phases: boot %u, sensor %u, radio init %u, send %u, sleep setup %u ms\n",
+                sample.timing.boot_ms, sample.timing.sensor_ms, sample.timing.radio_init_ms,
+                sample.timing.send_ms, sample.timing.sleep_setup_ms);
+  if (sample.epoch) Serial.printf("Measured at: %lu UTC\n", (unsigned long)sample.epoch);
+}
+
+// Dekodierung und Ausgabe im Loop-Task
+void processFrame(const RawFrame& frame) {
+  // Zeit-Beacons der Bridge sind keine Messwerte
+  if (sensorPacketIsControl(frame.data, frame.len)) return;
+
   receivedPackets++;
 
   Serial.println("\n========================================");
   Serial.printf("Data Received! (Packet #%d)\n", receivedPackets);
   Serial.println("========================================");
 
-  // Sender MAC anzeigen (aus recv_info)
+  // Sender MAC anzeigen (aus dem Frame)
   Serial.print("From MAC: ");
   for (int i = 0; i < 6; i++) {
-    Serial.printf("%02X", recv_info->src_addr[i]);
+    Serial.printf("%02X", frame.mac[i]);
     if (i < 5) Serial.print(":");
   }
   Serial.println();
 
-  // Sensor-Typ erkennen anhand Datengröße
-  // Outdoor: 20 bytes, Indoor: 25 bytes
-  bool isIndoor = (data_len >= sizeof(sensor_data_indoor));
-
   Serial.print("Data Size: ");
-  Serial.print(data_len);
+  Serial.print(frame.len);
   Serial.println(" bytes");
 
+  // Sensor-Typ aus der Geräte-Tabelle (Schema beim ersten Paket festgelegt)
+  SensorDevice* dev = ingest.ingest(frame.mac, frame.data, frame.len,
+                                    frame.rssi, frame.rxMs);
+  if (!dev) {
+    Serial.println("Unknown packet format or device table full - dropped");
+    Serial.println("========================================\n");
+    return;
+  }
+  dev->hasNewData = false;
+  bool isIndoor = (dev->schema == SCHEMA_INDOOR);
+
+  Serial.printf("Device: #%d of %d known (%s #%d, %lu packets)\n",
+                dev->index + 1, ingest.getCount(), SensorIngest::getSchemaName(dev->schema),
+                dev->ordinal + 1, (unsigned long)dev->link.packets);
+  if (dev->versioned) {
+    Serial.printf("Sequence: %u (lost: %lu, duplicates: %lu)\n", dev->lastSequence,
+                  (unsigned long)dev->link.lost, (unsigned long)dev->link.duplicates);
+  } else {
+    Serial.println("Format: legacy (no packet header)");
+  }
+  printBatch(*dev, frame.data, frame.len);
+
   Serial.print("Sensor Type: ");
   if (isIndoor) {
     Serial.println("INDOOR (BMP180 + AM2321)");
-    memcpy(&dataIndoor, data, min((int)sizeof(dataIndoor), data_len));
+    dataIndoor = dev->last;
 
     // Daten anzeigen
     Serial.println("\n--- Sensor Data (Indoor) ---");
@@ -127,6 +160,7 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
     Serial.print("Duration: ");
     Serial.print(dataIndoor.duration);
     Serial.println(" ms");
+    printTiming(dataIndoor);
 
     Serial.print("Sensor Status: ");
     if (dataIndoor.sensor_error == 0) {
@@ -152,7 +186,7 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
 
   } else {
     Serial.println("OUTDOOR (BMP180 only)");
-    memcpy(&dataOutdoor, data, min((int)sizeof(dataOutdoor), data_len));
+    dataOutdoor = dev->last;
 
     // Daten anzeigen
     Serial.println("\n--- Sensor Data (Outdoor) ---");
@@ -187,6 +221,7 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
     Serial.print("Duration: ");
     Serial.print(dataOutdoor.duration);
     Serial.println(" ms");
+    printTiming(dataOutdoor);
 
     Serial.print("Sensor Status: ");
     if (dataOutdoor.sensor_error == 0) {
@@ -211,14 +246,14 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
     Serial.println(" sec");
   }
 
-  // RSSI anzeigen (Signalstärke - aus recv_info)
+  // RSSI anzeigen (Signalstärke - aus dem Frame)
   Serial.print("Signal Strength (RSSI): ");
-  Serial.print(recv_info->rx_ctrl->rssi);
+  Serial.print(frame.rssi);
   Serial.println(" dBm");
 
   Serial.println("========================================\n");
 
-  lastReceiveTime = millis();
+  lastReceiveTime = frame.rxMs;
 
   // ==================== DATENWEITERVERARBEITUNG ====================
   // Hier können Sie die Daten weiterverarbeiten:
@@ -246,6 +281,14 @@ void onDataRecv(const esp_now_recv_info* recv_info, const uint8_t *data, int dat
   }
 }
 
+void drainFrameRing() {
+  const RawFrame* frame;
+  while ((frame = frameRing.peek()) != nullptr) {
+    processFrame(*frame);
+    frameRing.release();
+  }
+}
+
 // ==================== SETUP ====================
 
 void setup() {
@@ -281,6 +324,9 @@ void setup() {
   }
   Serial.println("✓ ESP-NOW initialized");
 
+  // setup() läuft bereits im Loop-Task, der die Frames verarbeitet
+  workerTaskHandle = xTaskGetCurrentTaskHandle();
+
   // Receive Callback registrieren
   esp_now_register_recv_cb(onDataRecv);
   Serial.println("✓ Receive callback registered");
@@ -300,6 +346,9 @@ void setup() {
 // ==================== LOOP ====================
 
 void loop() {
+  // Empfangene Frames verarbeiten
+  drainFrameRing();
+
   // Heartbeat - zeigt dass Empfänger läuft
   static unsigned long lastPrint = 0;
   static int dotCount = 0;
@@ -322,12 +371,28 @@ void loop() {
       Serial.println("\n--- Status ---");
       Serial.printf("Uptime: %lu seconds\n", millis() / 1000);
       Serial.printf("Packets received: %d\n", receivedPackets);
+      Serial.printf("Frames dropped (ring full): %lu\n", (unsigned long)frameRing.getDropped());
       Serial.printf("Free heap: %d bytes\n", ESP.getFreeHeap());
+
+      for (uint8_t i = 0; i < ingest.getCount(); i++) {
+        SensorDevice* dev = ingest.getDevice(i);
+        char mac[18];
+        SensorIngest::formatMac(dev->mac, mac);
+        Serial.printf("Sensor %s: %s, %lu packets, RSSI %d/%d/%d dBm (min/avg/max), malformed %lu\n",
+                      mac, SensorIngest::getSchemaName(dev->schema), (unsigned long)dev->link.packets,
+                      dev->link.rssiMin, dev->link.rssiAvg(), dev->link.rssiMax,
+                      (unsigned long)dev->link.malformed);
+        Serial.printf("  loss %.1f%% total, %.1f%% recent, %lu retries, RSSI p10/p50/p90 %d/%d/%d dBm, jitter %lu ms\n",
+                      dev->link.lossTotalPct(), dev->link.lossRecentPct(), (unsigned long)dev->link.retries,
+                      dev->link.rssiPercentile(10), dev->link.rssiPercentile(50), dev->link.rssiPercentile(90),
+                      (unsigned long)dev->link.jitterMs);
+      }
       Serial.println();
     }
 
     lastPrint = millis();
   }
 
-  delay(100);
+  // Warten bis der Callback einen Frame meldet
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
 }
@@ -0,0 +1,614 @@
+/*
+ * SensorIngest.h
+ * Gemeinsame ESP-NOW Empfangslogik für alle Sensor-Receiver
+ *
+ * Statt Indoor/Outdoor anhand der Paketgrösse global zu unterscheiden,
+ * führt jeder Receiver eine kleine Geräte-Tabelle (Open Addressing,
+ * lineares Sondieren) mit der Sender-MAC als Schlüssel. Pro Gerät:
+ * - Schema (aus dem Paket-Header, siehe SensorPacket.h; alte Sensoren
+ *   ohne Header: beim ersten Paket anhand der Länge festgelegt)
+ * - zuletzt dekodierter Messwert
+ * - Sequenz-Verfolgung (verlorene/doppelte Pakete)
+ * - Link-Statistik (Pakete, RSSI, letzter Empfang)
+ *
+ * Link-Qualität pro Gerät, jeweils O(1) pro Paket:
+ * - Verlustrate gesamt und gleitend (EWMA über die erwarteten Pakete)
+ * - RSSI-Mittel (EWMA) und Perzentile aus einem abklingenden Histogramm
+ * - Jitter: Abweichung des Paketabstands von der angekündigten Sleep-Periode
+ * - Wiederholungen laut Header-Flags
+ *
+ * Wachzeit-Phasen (SensorTimingV1) und der Messzeitpunkt (epoch) werden
+ * mit dekodiert, wenn der Sender sie an die Payload anhängt. Steuerpakete
+ * (Zeit-Beacons) verwirft ingest() ohne sie als Fehler zu zählen.
+ *
+ * Batch-Pakete (Store-and-Forward, SENSOR_FLAG_BATCH): ingest() liefert wie
+ * gewohnt den aktuellen Messwert in last; die gepufferten älteren Werte
+ * holt der Receiver mit getBatchCount()/getBatchSample() aus demselben
+ * Frame, jeweils mit age_sec relativ zum Empfang.
+ *
+ * Lookup und Einfügen sind O(1) und ohne Heap, damit ingest() direkt im
+ * ESP-NOW Receive-Callback laufen kann. Geräte werden nie entfernt
+ * (feste Sensor-Installation), daher keine Tombstones nötig.
+ *
+ * Identische Kopie in: ESP32-C3_Bridge_Slave, ESP32_C3_Datalogger,
+ * CYD_ESP_NOW_Receiver, ESP_NOW_Receiver_ESP32, ESP_NOW_Receiver
+ *
+ * Version: 1.6.0
+ */
+
+#ifndef SENSOR_INGEST_H
+#define SENSOR_INGEST_H
+
+#include <stdint.h>
+#include <string.h>
+#include "SensorPacket.h"
+
+// ==================== KONFIGURATION ====================
+
+#define INGEST_TABLE_SIZE 64            // Slots, Zweierpotenz
+#define INGEST_MAX_DEVICES 32           // Max. Sensoren (Füllgrad <= 50% hält Sondierketten kurz)
+#define INGEST_RSSI_EWMA_SHIFT 3        // RSSI-Mittel: neuer Wert mit Gewicht 1/8
+#define INGEST_RSSI_FLOOR -100          // RSSI-Histogramm: unterste Klasse (dBm)
+#define INGEST_RSSI_BIN_DB 3            // Klassenbreite (dB)
+#define INGEST_RSSI_BINS 24             // -100 .. -29 dBm, Ausreisser in Rand-Klassen
+#define INGEST_LOSS_EWMA_SHIFT 4        // Gleitende Verlustrate: Gewicht 1/16 pro erwartetem Paket
+#define INGEST_JITTER_SHIFT 4           // Jitter-Mittel: Gewicht 1/16 (wie RFC 3550)
+
+static_assert((INGEST_TABLE_SIZE & (INGEST_TABLE_SIZE - 1)) == 0, "INGEST_TABLE_SIZE must be a power of two");
+static_assert(INGEST_MAX_DEVICES * 2 <= INGEST_TABLE_SIZE, "Table load factor must stay <= 0.5");
+
+// ==================== LEGACY PAKETE ====================
+
+// Indoor Sensor (BMP180 + AM2321), Firmware vor SensorPacket.h
+typedef struct legacy_packet_indoor {
+    uint32_t timestamp;
+    float temperature;
+    float pressure;
+    float humidity;
+    uint8_t am2321_readings;
+    uint16_t battery_voltage;
+    uint16_t duration;
+    uint8_t battery_warning;
+    uint8_t sensor_error;
+    uint8_t reset_reason;
+    uint8_t sensor_type;
+    uint16_t sleep_time_sec;
+} legacy_packet_indoor;
+
+// Outdoor Sensor (nur BMP180)
+typedef struct legacy_packet_outdoor {
+    uint32_t timestamp;
+    float temperature;
+    float pressure;
+    uint16_t battery_voltage;
+    uint16_t duration;
+    uint8_t battery_warning;
+    uint8_t sensor_error;
+    uint8_t reset_reason;
+    uint8_t sensor_type;
+    uint16_t sleep_time_sec;
+} legacy_packet_outdoor;
+
+static_assert(sizeof(legacy_packet_indoor) == 28, "Indoor packet layout changed");
+static_assert(sizeof(legacy_packet_outdoor) == 24, "Outdoor packet layout changed");
+
+// ==================== DATENSTRUKTUREN ====================
+
+enum SensorSchema : uint8_t {
+    SCHEMA_UNKNOWN = 0,
+    SCHEMA_OUTDOOR,             // BMP180 (Legacy: 24 Bytes)
+    SCHEMA_INDOOR,              // BMP180 + AM2321 (Legacy: 28 Bytes)
+    SCHEMA_COUNT
+};
+
+// Dekodierter Messwert (Feldnamen wie in den Legacy-Structs)
+struct SensorSample {
+    uint32_t timestamp;         // Sender-millis()
+    float temperature;          // °C
+    float pressure;             // mbar
+    float humidity;             // % (nur wenn hasHumidity)
+    uint8_t am2321_readings;
+    uint16_t battery_voltage;   // mV
+    uint16_t duration;          // ms
+    uint8_t battery_warning;
+    uint8_t sensor_error;
+    uint8_t reset_reason;
+    uint8_t sensor_type;        // 0 = Outdoor, 1 = Indoor
+    uint16_t sleep_time_sec;
+    uint16_t age_sec;           // Gemessen vor Empfang (Batch), sonst 0
+    bool hasHumidity;
+    bool hasTiming;             // Sender meldet Wachzeit-Phasen
+    SensorTimingV1 timing;      // Phasen des vorherigen Zyklus (nur wenn hasTiming)
+    uint32_t epoch;             // UTC Sekunden der Messung laut Sensor, 0 = unbekannt
+};
+
+struct LinkStats {
+    uint32_t packets;           // Gültige Pakete
+    uint32_t lost;              // Per Sequenznummer erkannte Lücken
+    uint32_t duplicates;        // Doppelt oder veraltet empfangen
+    uint32_t malformed;         // Länge/Header passt nicht, unbekannter Sensortyp
+    uint32_t retries;           // Vom Sender gemeldete Wiederholungen (Header-Flags)
+    int8_t rssi;                // Letzter Wert (dBm)
+    int8_t rssiMin;
+    int8_t rssiMax;
+    int16_t rssiAvg16;          // EWMA, x16 skaliert
+    uint8_t rssiHist[INGEST_RSSI_BINS]; // Abklingend: bei 255 werden alle Klassen halbiert
+    uint16_t lossEwma;          // Gleitende Verlustrate, 65535 = 100%
+    uint32_t jitterMs;          // Mittlere |Abweichung| des Paketabstands (EWMA)
+    int32_t lastDeviationMs;    // Letzte Abweichung, + = später als angekündigt
+    uint32_t intervals;         // Für den Jitter ausgewertete Paketabstände
+    unsigned long firstSeen;    // ms (Receiver)
+    unsigned long lastSeen;     // ms (Receiver)
+
+    int8_t rssiAvg() const { return (int8_t)(rssiAvg16 / 16); }
+
+    /** Verlustrate seit Start in % */
+    float lossTotalPct() const {
+        uint32_t expected = packets + lost;
+        return expected ? lost * 100.0f / expected : 0;
+    }
+
+    /** Gleitende Verlustrate (~ letzte 16 erwartete Pakete) in % */
+    float lossRecentPct() const { return lossEwma * 100.0f / 65535.0f; }
+
+    /**
+     * RSSI-Perzentil aus dem Histogramm (Klassenmitte)
+     * @param pct 0..100, z.B. 10 = schwächste 10% der Pakete
+     */
+    int8_t rssiPercentile(uint8_t pct) const {
+        uint16_t total = 0;
+        for (uint8_t i = 0; i < INGEST_RSSI_BINS; i++) total += rssiHist[i];
+        if (total == 0) return rssi;
+
+        uint16_t target = (total * pct + 99) / 100;
+        if (target == 0) target = 1;
+        uint16_t sum = 0;
+        uint8_t i = 0;
+        for (; i < INGEST_RSSI_BINS - 1; i++) {
+            sum += rssiHist[i];
+            if (sum >= target) break;
+        }
+        return INGEST_RSSI_FLOOR + i * INGEST_RSSI_BIN_DB + INGEST_RSSI_BIN_DB / 2;
+    }
+};
+
+struct SensorDevice {
+    uint8_t mac[6];
+    bool inUse;
+    SensorSchema schema;
+    uint8_t ordinal;            // Wievieltes Gerät dieses Schemas (0 = primärer Sensor)
+    uint8_t index;              // Reihenfolge der Registrierung (0..count-1)
+    bool versioned;             // Sendet mit SensorPacket-Header
+    uint8_t lastFlags;          // Header-Flags des letzten Pakets
+    bool hasSequence;
+    uint16_t lastSequence;
+    bool hasNewData;            // Vom Receiver nach Verarbeitung zurücksetzen
+    SensorSample last;
+    LinkStats link;
+};
+
+// Schema-Tabelle: Sensortyp, Decoder für Header-Payload und Legacy-Paket
+typedef bool (*SensorDecodeFn)(const uint8_t* data, int len, SensorSample& out);
+
+struct SensorSchemaInfo {
+    SensorSchema id;
+    const char* name;
+    uint8_t sensorType;         // sensor_type im Header
+    SensorDecodeFn decode;      // Payload (Version 1), akzeptiert angehängte Felder
+    uint8_t legacyLength;       // Paketlänge ohne Header
+    SensorDecodeFn decodeLegacy;
+};
+
+// ==================== DECODER ====================
+
+inline void decodeOutdoorFields(const SensorPayloadOutdoorV1& raw, SensorSample& out) {
+    out.timestamp = raw.timestamp;
+    out.temperature = raw.temperature;
+    out.pressure = raw.pressure;
+    out.battery_voltage = raw.battery_voltage;
+    out.duration = raw.duration;
+    out.battery_warning = raw.battery_warning;
+    out.sensor_error = raw.sensor_error;
+    out.reset_reason = raw.reset_reason;
+    out.sleep_time_sec = raw.sleep_time_sec;
+}
+
+inline bool decodeOutdoorV1(const uint8_t* data, int len, SensorSample& out) {
+    if (len < (int)sizeof(SensorPayloadOutdoorV1)) return false;
+    SensorPayloadOutdoorV1 raw;
+    memcpy(&raw, data, sizeof(raw));
+
+    decodeOutdoorFields(raw, out);
+    out.humidity = 0;
+    out.am2321_readings = 0;
+    out.sensor_type = SENSOR_TYPE_OUTDOOR;
+    out.hasHumidity = false;
+    out.hasTiming = sensorTimingRead(data, len, sizeof(SensorPayloadOutdoorV1), out.timing);
+    if (!sensorEpochRead(data, len, sizeof(SensorPayloadOutdoorV1), out.epoch)) out.epoch = 0;
+    return true;
+}
+
+inline bool decodeIndoorV1(const uint8_t* data, int len, SensorSample& out) {
+    if (len < (int)sizeof(SensorPayloadIndoorV1)) return false;
+    SensorPayloadIndoorV1 raw;
+    memcpy(&raw, data, sizeof(raw));
+
+    decodeOutdoorFields(raw.base, out);
+    out.humidity = raw.humidity;
+    out.am2321_readings = raw.am2321_readings;
+    out.sensor_type = SENSOR_TYPE_INDOOR;
+    out.hasHumidity = true;
+    out.hasTiming = sensorTimingRead(data, len, sizeof(SensorPayloadIndoorV1), out.timing);
+    if (!sensorEpochRead(data, len, sizeof(SensorPayloadIndoorV1), out.epoch)) out.epoch = 0;
+    return true;
+}
+
+inline bool decodeLegacyIndoor(const uint8_t* data, int len, SensorSample& out) {
+    if (len < (int)sizeof(legacy_packet_indoor)) return false;
+    legacy_packet_indoor raw;
+    memcpy(&raw, data, sizeof(raw));
+
+    out.timestamp = raw.timestamp;
+    out.temperature = raw.temperature;
+    out.pressure = raw.pressure;
+    out.humidity = raw.humidity;
+    out.am2321_readings = raw.am2321_readings;
+    out.battery_voltage = raw.battery_voltage;
+    out.duration = raw.duration;
+    out.battery_warning = raw.battery_warning;
+    out.sensor_error = raw.sensor_error;
+    out.reset_reason = raw.reset_reason;
+    out.sensor_type = raw.sensor_type;
+    out.sleep_time_sec = raw.sleep_time_sec;
+    out.hasHumidity = true;
+    out.hasTiming = false;
+    out.epoch = 0;
+    return true;
+}
+
+inline bool decodeLegacyOutdoor(const uint8_t* data, int len, SensorSample& out) {
+    if (len < (int)sizeof(legacy_packet_outdoor)) return false;
+    legacy_packet_outdoor raw;
+    memcpy(&raw, data, sizeof(raw));
+
+    out.timestamp = raw.timestamp;
+    out.temperature = raw.temperature;
+    out.pressure = raw.pressure;
+    out.humidity = 0;
+    out.am2321_readings = 0;
+    out.battery_voltage = raw.battery_voltage;
+    out.duration = raw.duration;
+    out.battery_warning = raw.battery_warning;
+    out.sensor_error = raw.sensor_error;
+    out.reset_reason = raw.reset_reason;
+    out.sensor_type = raw.sensor_type;
+    out.sleep_time_sec = raw.sleep_time_sec;
+    out.hasHumidity = false;
+    out.hasTiming = false;
+    out.epoch = 0;
+    return true;
+}
+
+// Neue Sensortypen hier eintragen. Legacy-Länge: längste zuerst, bei der
+// Klassifizierung alter Pakete gewinnt das erste passende Schema
+static const SensorSchemaInfo SENSOR_SCHEMAS[] = {
+    { SCHEMA_INDOOR,  "Indoor",  SENSOR_TYPE_INDOOR,  decodeIndoorV1,  sizeof(legacy_packet_indoor),  decodeLegacyIndoor },
+    { SCHEMA_OUTDOOR, "Outdoor", SENSOR_TYPE_OUTDOOR, decodeOutdoorV1, sizeof(legacy_packet_outdoor), decodeLegacyOutdoor },
+};
+
+#define SENSOR_SCHEMA_ENTRIES (sizeof(SENSOR_SCHEMAS) / sizeof(SENSOR_SCHEMAS[0]))
+
+// ==================== HAUPT-KLASSE ====================
+
+class SensorIngest {
+private:
+    SensorDevice table[INGEST_TABLE_SIZE];
+    uint8_t order[INGEST_MAX_DEVICES];      // Slot-Indizes in Registrierungs-Reihenfolge
+    uint8_t deviceCount;
+    uint8_t schemaCount[SCHEMA_COUNT];      // Für SensorDevice::ordinal
+
+    uint32_t tableFullDrops;                // Neues Gerät, aber Tabelle voll
+    uint32_t unknownDrops;                  // Neues Gerät, Paket passt zu keinem Schema
+
+    // FNV-1a über die MAC; die letzten Bytes unterscheiden sich bei
+    // Geräten eines Herstellers am stärksten, alle 6 Bytes einbeziehen
+    static uint32_t hashMac(const uint8_t* mac) {
+        uint32_t h = 2166136261u;
+        for (int i = 0; i < 6; i++) {
+            h ^= mac[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Slot mit dieser MAC oder erster freier Slot der Sondierkette
+    uint8_t probe(const uint8_t* mac) const {
+        uint8_t slot = hashMac(mac) & (INGEST_TABLE_SIZE - 1);
+        while (table[slot].inUse && memcmp(table[slot].mac, mac, 6) != 0) {
+            slot = (slot + 1) & (INGEST_TABLE_SIZE - 1);
+        }
+        return slot;
+    }
+
+    static const SensorSchemaInfo* bySensorType(uint8_t sensorType) {
+        for (size_t i = 0; i < SENSOR_SCHEMA_ENTRIES; i++) {
+            if (SENSOR_SCHEMAS[i].sensorType == sensorType) return &SENSOR_SCHEMAS[i];
+        }
+        return nullptr;
+    }
+
+    // Legacy-Pakete: neues Gerät wie früher per Mindestlänge, bekanntes nur bei exakter Länge
+    static const SensorSchemaInfo* classifyLegacy(int len, bool exact) {
+        for (size_t i = 0; i < SENSOR_SCHEMA_ENTRIES; i++) {
+            int expected = SENSOR_SCHEMAS[i].legacyLength;
+            if (exact ? (len == expected) : (len >= expected)) return &SENSOR_SCHEMAS[i];
+        }
+        return nullptr;
+    }
+
+    static void noteRssi(LinkStats& link, int8_t rssi) {
+        int bin = (rssi - INGEST_RSSI_FLOOR) / INGEST_RSSI_BIN_DB;
+        if (bin < 0) bin = 0;
+        if (bin >= INGEST_RSSI_BINS) bin = INGEST_RSSI_BINS - 1;
+
+        // Alte Pakete verlieren Gewicht; im Mittel O(1), halbiert wird höchstens alle 128 Pakete
+        if (link.rssiHist[bin] == 255) {
+            for (uint8_t i = 0; i < INGEST_RSSI_BINS; i++) link.rssiHist[i] >>= 1;
+        }
+        link.rssiHist[bin]++;
+    }
+
+    // Gleitende Verlustrate: jedes verlorene Paket zieht Richtung 100%, jedes empfangene Richtung 0%
+    static void noteLoss(LinkStats& link, uint16_t lostPackets) {
+        if (lostPackets >= 64) {
+            link.lossEwma = 65535;      // (15/16)^64 < 2%: Verlauf ist ohnehin vergessen
+        } else {
+            for (uint16_t i = 0; i < lostPackets; i++) {
+                link.lossEwma += (65535 - link.lossEwma) >> INGEST_LOSS_EWMA_SHIFT;
+            }
+        }
+        link.lossEwma -= link.lossEwma >> INGEST_LOSS_EWMA_SHIFT;
+    }
+
+    /**
+     * Paketabstand gegen die angekündigte Periode des vorherigen Pakets
+     * Erwartet: Sleep-Periode + Wachzeit (duration des neuen Pakets, ungefähr)
+     */
+    static void noteInterval(LinkStats& link, unsigned long intervalMs,
+                             uint16_t sleepSec, uint16_t durationMs) {
+        int32_t deviation = (int32_t)intervalMs - (int32_t)(sleepSec * 1000UL + durationMs);
+        uint32_t magnitude = deviation < 0 ? -deviation : deviation;
+
+        if (link.intervals == 0) {
+            link.jitterMs = magnitude;
+        } else {
+            link.jitterMs += ((int32_t)magnitude - (int32_t)link.jitterMs) >> INGEST_JITTER_SHIFT;
+        }
+        link.lastDeviationMs = deviation;
+        link.intervals++;
+    }
+
+    void updateLink(LinkStats& link, int8_t rssi, unsigned long nowMs) {
+        noteRssi(link, rssi);
+        if (link.packets == 0) {
+            link.firstSeen = nowMs;
+            link.rssiMin = link.rssiMax = rssi;
+            link.rssiAvg16 = rssi * 16;
+        } else {
+            if (rssi < link.rssiMin) link.rssiMin = rssi;
+            if (rssi > link.rssiMax) link.rssiMax = rssi;
+            link.rssiAvg16 += (rssi * 16 - link.rssiAvg16) >> INGEST_RSSI_EWMA_SHIFT;
+        }
+        link.rssi = rssi;
+        link.lastSeen = nowMs;
+        link.packets++;
+    }
+
+public:
+    SensorIngest() {
+        clear();
+    }
+
+    void clear() {
+        memset(table, 0, sizeof(table));
+        memset(schemaCount, 0, sizeof(schemaCount));
+        deviceCount = 0;
+        tableFullDrops = 0;
+        unknownDrops = 0;
+    }
+
+    /**
+     * Paket eines Senders verarbeiten (aus dem ESP-NOW Callback)
+     * @param mac Sender-MAC (6 Bytes)
+     * @param data Nutzdaten
+     * @param len Länge der Nutzdaten
+     * @param rssi Empfangsstärke in dBm
+     * @param nowMs millis() des Receivers
+     * @return Gerät mit neuem Messwert in last, nullptr wenn verworfen
+     */
+    SensorDevice* ingest(const uint8_t* mac, const uint8_t* data, int len, int8_t rssi, unsigned long nowMs) {
+        uint8_t slot = probe(mac);
+        SensorDevice& dev = table[slot];
+
+        SensorPacketHeader hdr;
+        const uint8_t* payload = nullptr;
+        bool versioned = sensorPacketParse(data, len, hdr, payload);
+
+        // Legacy-Gerät, dessen Timestamp zufällig mit dem Magic beginnt
+        if (versioned && dev.inUse && !dev.versioned && classifyLegacy(len, true)) {
+            versioned = false;
+        }
+
+        // Zeit-Beacons u.ä. sind keine Messwerte (kein Gerät, kein Fehler)
+        if (versioned && hdr.sensor_type >= SENSOR_TYPE_CONTROL_FIRST) return nullptr;
+
+        // Schema bestimmen: Header -> Tabelle, sonst Legacy-Heuristik
+        const SensorSchemaInfo* info;
+        if (versioned) {
+            info = bySensorType(hdr.sensor_type);
+        } else {
+            info = dev.inUse ? getSchemaInfo(dev.schema) : nullptr;
+            if (!info || len != info->legacyLength) info = classifyLegacy(len, dev.inUse);
+        }
+
+        SensorSample sample;
+        bool ok = info && (versioned ? info->decode(payload, hdr.payload_len, sample)
+                                     : info->decodeLegacy(data, len, sample));
+        sample.age_sec = 0;
+        if (!ok) {
+            if (dev.inUse) dev.link.malformed++;
+            else unknownDrops++;
+            return nullptr;
+        }
+
+        if (!dev.inUse) {
+            if (deviceCount >= INGEST_MAX_DEVICES) {
+                tableFullDrops++;
+                return nullptr;
+            }
+
+            memcpy(dev.mac, mac, 6);
+            dev.inUse = true;
+            dev.schema = info->id;
+            dev.ordinal = schemaCount[info->id]++;
+            dev.index = deviceCount;
+            order[deviceCount++] = slot;
+        } else if (dev.schema != info->id) {
+            // Sensor neu geflasht (z.B. Outdoor -> Indoor)
+            dev.schema = info->id;
+            dev.ordinal = schemaCount[info->id]++;
+        }
+
+        if (versioned) {
+            // Sender hat seinen Zähler neu gestartet (RTC verloren): ohne Verlust neu synchronisieren
+            if (hdr.flags & SENSOR_FLAG_SEQ_RESET) dev.hasSequence = false;
+            bool consecutive = dev.hasSequence && (uint16_t)(hdr.sequence - dev.lastSequence) == 1;
+            if (!noteSequence(dev, hdr.sequence)) return nullptr;
+            dev.lastFlags = hdr.flags;
+            dev.link.retries += sensorPacketRetry(hdr.flags);
+
+            // Jitter nur über direkt aufeinanderfolgende Wakes; Batch-Pakete
+            // folgen auf Wakes ohne Funk, ihr Abstand umfasst mehrere Perioden
+            if (consecutive && !(hdr.flags & SENSOR_FLAG_BATCH) && dev.last.sleep_time_sec > 0) {
+                noteInterval(dev.link, nowMs - dev.link.lastSeen, dev.last.sleep_time_sec, sample.duration);
+            }
+        }
+        dev.versioned = versioned;
+
+        dev.last = sample;
+        updateLink(dev.link, rssi, nowMs);
+        dev.hasNewData = true;
+        return &dev;
+    }
+
+    /**
+     * Sequenznummer eines Pakets verbuchen
+     * @return false bei Duplikat oder veraltetem Paket (nicht weiterverarbeiten)
+     */
+    bool noteSequence(SensorDevice& dev, uint16_t seq) {
+        if (!dev.hasSequence) {
+            dev.hasSequence = true;
+            dev.lastSequence = seq;
+            noteLoss(dev.link, 0);
+            return true;
+        }
+
+        uint16_t delta = (uint16_t)(seq - dev.lastSequence);
+        if (delta == 0 || delta >= 0x8000) {
+            dev.link.duplicates++;
+            return false;
+        }
+
+        dev.link.lost += delta - 1;
+        noteLoss(dev.link, delta - 1);
+        dev.lastSequence = seq;
+        return true;
+    }
+
+    /**
+     * Anzahl gepufferter Messwerte im zuletzt per ingest() verarbeiteten Frame
+     * @param data, len derselbe Frame wie bei ingest()
+     */
+    static uint8_t getBatchCount(const SensorDevice& dev, const uint8_t* data, int len) {
+        SensorPacketHeader hdr;
+        const uint8_t* payload;
+        if (!dev.versioned || !sensorPacketParse(data, len, hdr, payload)) return 0;
+        return sensorBatchCount(data, len, hdr);
+    }
+
+    /**
+     * Gepufferten Messwert auspacken
+     * Status-Felder (Sleep, Fehler, Reset) stammen aus dem aktuellen Messwert dev.last
+     * @param i 0 = ältester
+     * @param out Messwert mit age_sec = Sekunden vor Empfang, epoch = Messzeitpunkt (falls bekannt)
+     */
+    static bool getBatchSample(const SensorDevice& dev, const uint8_t* data, int len,
+                               uint8_t i, SensorSample& out) {
+        SensorPacketHeader hdr;
+        const uint8_t* payload;
+        SensorBatchSample raw;
+        if (!dev.versioned || !sensorPacketParse(data, len, hdr, payload)) return false;
+        if (!sensorBatchGet(data, len, hdr, i, raw)) return false;
+
+        out = dev.last;
+        out.temperature = raw.temperature / 100.0f;
+        out.pressure = raw.pressure / 10.0f;
+        out.hasHumidity = dev.last.hasHumidity && raw.humidity != SENSOR_BATCH_NO_HUMIDITY;
+        out.humidity = out.hasHumidity ? raw.humidity / 100.0f : 0;
+        out.battery_voltage = raw.battery_voltage;
+        out.age_sec = raw.age_sec;
+        out.epoch = dev.last.epoch ? dev.last.epoch - raw.age_sec : 0;
+        return true;
+    }
+
+    /**
+     * Gerät per MAC suchen
+     * @return nullptr wenn unbekannt
+     */
+    SensorDevice* find(const uint8_t* mac) {
+        uint8_t slot = probe(mac);
+        return table[slot].inUse ? &table[slot] : nullptr;
+    }
+
+    /**
+     * Gerät eines Schemas suchen (ordinal 0 = zuerst gesehenes)
+     */
+    SensorDevice* findBySchema(SensorSchema schema, uint8_t ordinal = 0) {
+        for (uint8_t i = 0; i < deviceCount; i++) {
+            SensorDevice& dev = table[order[i]];
+            if (dev.schema == schema && dev.ordinal == ordinal) return &dev;
+        }
+        return nullptr;
+    }
+
+    /** Geräte in Registrierungs-Reihenfolge (0..getCount()-1) */
+    SensorDevice* getDevice(uint8_t i) { return (i < deviceCount) ? &table[order[i]] : nullptr; }
+    uint8_t getCount() const { return deviceCount; }
+
+    uint32_t getTableFullDrops() const { return tableFullDrops; }
+    uint32_t getUnknownDrops() const { return unknownDrops; }
+
+    static const SensorSchemaInfo* getSchemaInfo(SensorSchema schema) {
+        for (size_t i = 0; i < SENSOR_SCHEMA_ENTRIES; i++) {
+            if (SENSOR_SCHEMAS[i].id == schema) return &SENSOR_SCHEMAS[i];
+        }
+        return nullptr;
+    }
+
+    static const char* getSchemaName(SensorSchema schema) {
+        const SensorSchemaInfo* info = getSchemaInfo(schema);
+        return info ? info->name : "Unknown";
+    }
+
+    /** MAC als "AA:BB:CC:DD:EE:FF" (buf >= 18 Bytes) */
+    static void formatMac(const uint8_t* mac, char* buf) {
+        static const char hex[] = "0123456789ABCDEF";
+        for (int i = 0; i < 6; i++) {
+            buf[i * 3] = hex[mac[i] >> 4];
+            buf[i * 3 + 1] = hex[mac[i] & 0x0F];
+            buf[i * 3 + 2] = (i < 5) ? ':' : '\0';
+        }
+    }
+};
+
+#endif // SENSOR_INGEST_H
@@ -0,0 +1,203 @@
+/*
+ * SensorSim.h
+ * Gemeinsame Teile der Host-Simulationen (adaptive_sim, energy_model)
+ *
+ * - Log-Import: Monatsdatei des CYD Masters oder Datalogger-CSV
+ * - Synthetische Woche, wenn kein Log vorliegt
+ * - Lineare Interpolation zwischen den Log-Zeilen ("Wahrheit")
+ * - Sensorrauschen mit festem Seed
+ * - Kopie der Schwellwert-Regel aus dem Sketch
+ *
+ * Braucht CsvReader.h aus dem CYD Master (-I../CYD_I2C_Receiver/CYD_I2C_Master).
+ */
+
+#ifndef SENSOR_SIM_H
+#define SENSOR_SIM_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "CsvReader.h"
+
+// ==================== KONFIGURATION (wie im Sketch, Outdoor) ====================
+
+static const uint16_t MIN_SLEEP_PERIOD = 20;
+static const uint16_t DEFAULT_PERIOD = 900;
+static const float TEMP_CHANGE_FAST = 1.0f;
+static const float TEMP_CHANGE_STABLE = 0.5f;
+static const uint16_t PERIOD_DIVIDER = 3;
+
+// AdaptiveModel (MODEL_* im Sketch)
+static const uint16_t MODEL_MAX_PERIOD = 2 * DEFAULT_PERIOD;
+static const float MODEL_TEMP_DRIFT = 0.25f;    // °C/h pro Stunde
+static const float MODEL_PRESS_DRIFT = 0.5f;    // mbar/h pro Stunde
+static const float MODEL_CONFIDENCE = 1.5f;
+
+static const float SENSOR_TEMP_NOISE = 0.05f;   // °C
+static const float SENSOR_PRESS_NOISE = 0.05f;  // mbar
+
+// ==================== DATEN ====================
+
+struct Point {
+    double t;           // s
+    float temp;
+    float press;
+    float duration;     // ms Wachzeit laut Log (Datalogger), < 0 = unbekannt
+};
+
+class FileSource {
+private:
+    FILE* fp;
+
+public:
+    explicit FileSource(FILE* f) : fp(f) {}
+
+    int read(uint8_t* buf, size_t len) {
+        return (int)fread(buf, 1, len, fp);
+    }
+};
+
+// Tage seit 1970-01-01 (proleptischer Gregorianischer Kalender)
+static long daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    long era = (y >= 0 ? y : y - 399) / 400;
+    long yoe = y - era * 400;
+    long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * Log einlesen
+ * Monatsdatei: DateTime,Temperature_C,Pressure_mbar,...
+ * Datalogger:  Timestamp (ms),Date,Time,Temperature,[Humidity,]Pressure,...,Duration_ms,...
+ * @return false bei weniger als 2 verwertbaren Zeilen
+ */
+static bool loadCsv(const char* path, std::vector<Point>& out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    FileSource src(fp);
+    CsvReader<FileSource> csv(src);
+    bool monthly = false;
+    bool first = true;
+
+    while (csv.next()) {
+        CsvField f0 = csv.field(0);
+        char buf[32];
+        size_t n = f0.len < sizeof(buf) - 1 ? f0.len : sizeof(buf) - 1;
+        memcpy(buf, f0.ptr, n);
+        buf[n] = '\0';
+
+        if (first) {
+            first = false;
+            monthly = strcmp(buf, "DateTime") == 0;
+            if (monthly || strcmp(buf, "Timestamp") == 0) continue;  // Header
+        }
+
+        Point p;
+        float temp, press;
+        p.duration = -1;
+        if (monthly) {
+            int y, mo, d, h, mi, s;
+            if (sscanf(buf, "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &s) != 6) continue;
+            if (!csvParseFloat(csv.field(1), temp) || !csvParseFloat(csv.field(2), press)) continue;
+            p.t = daysFromCivil(y, mo, d) * 86400.0 + h * 3600 + mi * 60 + s;
+        } else {
+            // Datalogger: Indoor hat Humidity vor Pressure
+            if (csv.count() < 6 || !csvParseFloat(csv.field(3), temp)) continue;
+            bool indoor = csv.count() >= 13;
+            if (!csvParseFloat(csv.field(indoor ? 5 : 4), press)) continue;
+            float duration;
+            if (csvParseFloat(csv.field(indoor ? 10 : 9), duration)) p.duration = duration;
+            p.t = strtoul(buf, nullptr, 10) / 1000.0;
+        }
+        p.temp = temp;
+        p.press = press;
+        if (!out.empty() && p.t <= out.back().t) continue;  // Neustart/Lücke
+        out.push_back(p);
+    }
+
+    fclose(fp);
+    return out.size() >= 2;
+}
+
+static uint32_t rngState = 12345;
+
+static float gauss() {
+    // Box-Muller mit festem Seed, damit alle Regeln dieselbe Reihe sehen
+    auto uni = []() {
+        rngState = rngState * 1664525u + 1013904223u;
+        return ((rngState >> 8) + 1.0f) / 16777218.0f;
+    };
+    float u1 = uni(), u2 = uni();
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static void synthesize(std::vector<Point>& out) {
+    // 7 Tage im Minutentakt: Tagesgang 8 °C, Front an Tag 3 (-6 °C, -12 mbar über 3 h)
+    for (int i = 0; i <= 7 * 1440; i++) {
+        double t = i * 60.0;
+        double day = t / 86400.0;
+        float temp = 8.0f + 4.0f * sinf((float)(2 * M_PI * (day - 0.375)));
+        float press = 1015.0f + 2.0f * sinf((float)(2 * M_PI * day / 3.5));
+        double front = (day - 3.4) * 8.0;   // 3 h Rampe
+        if (front > 0) {
+            float k = front > 1 ? 1.0f : (float)front;
+            temp -= 6.0f * k;
+            press -= 12.0f * k;
+        }
+        out.push_back({ t, temp + 0.02f * gauss(), press, -1 });
+    }
+}
+
+/** Log laden oder ("-"/kein Pfad) synthetische Woche erzeugen */
+static bool loadOrSynthesize(const char* path, std::vector<Point>& out) {
+    if (path && strcmp(path, "-") != 0) {
+        if (!loadCsv(path, out)) {
+            fprintf(stderr, "Cannot read %s (need >= 2 records)\n", path);
+            return false;
+        }
+    } else {
+        synthesize(out);
+    }
+    return true;
+}
+
+// ==================== SIMULATION ====================
+
+struct Truth {
+    const std::vector<Point>& pts;
+    size_t idx = 0;
+
+    explicit Truth(const std::vector<Point>& p) : pts(p) {}
+
+    // Linear interpolieren; t läuft nur vorwärts
+    Point at(double t) {
+        while (idx + 2 < pts.size() && pts[idx + 1].t <= t) idx++;
+        const Point& a = pts[idx];
+        const Point& b = pts[idx + 1];
+        double k = (t - a.t) / (b.t - a.t);
+        if (k < 0) k = 0;
+        if (k > 1) k = 1;
+        return { t, (float)(a.temp + (b.temp - a.temp) * k), (float)(a.press + (b.press - a.press) * k), a.duration };
+    }
+};
+
+// Kopie von calculateAdaptivePeriod() (ohne DEBUG/Battery Protection)
+static uint16_t legacyPeriod(float current, float last, uint16_t period) {
+    float change = fabsf(current - last);
+    if (change >= TEMP_CHANGE_FAST) {
+        period /= PERIOD_DIVIDER;
+        if (period < MIN_SLEEP_PERIOD) period = MIN_SLEEP_PERIOD;
+    } else if (change < TEMP_CHANGE_STABLE) {
+        period *= PERIOD_DIVIDER;
+        if (period > DEFAULT_PERIOD) period = DEFAULT_PERIOD;
+    }
+    return period;
+}
+
+#endif // SENSOR_SIM_H
@@ -0,0 +1,132 @@
+/*
+ * adaptive_sim.cpp
+ * Host-Simulation der Sleep-Perioden-Wahl (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Spielt eine aufgezeichnete Temperatur-/Druckreihe ab und vergleicht:
+ * - die bisherige Schwellwert-Regel (calculateAdaptivePeriod() im Sketch)
+ * - das Kalman/Trend-Modell (AdaptiveModel.h)
+ * Zwischen den Log-Zeilen wird linear interpoliert ("Wahrheit"), jede
+ * simulierte Messung bekommt BMP180-typisches Rauschen. Der Empfänger hält
+ * den zuletzt empfangenen Wert; gemessen wird dessen Abweichung von der
+ * Wahrheit (alle 10 s), der Zeitanteil über der Schranke (Temperatur bzw.
+ * 0.5 mbar) und die Anzahl Pakete pro Tag.
+ *
+ * Eingabe: Monatsdatei des CYD Masters (DateTime,Temperature_C,Pressure_mbar,...)
+ * oder Datalogger-CSV (Timestamp in ms,,,Temperature,...). Ohne Datei wird
+ * eine synthetische Woche erzeugt (Tagesgang, Wetterfront, Rauschen).
+ * Log-Import und Regel-Kopie: SensorSim.h
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I.. -I../CYD_I2C_Receiver/CYD_I2C_Master adaptive_sim.cpp -o adaptive_sim
+ *   ./adaptive_sim [log.csv] [Temperatur-Schranke °C]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AdaptiveModel.h"
+#include "SensorSim.h"
+
+static const uint32_t EVAL_STEP = 10;           // s
+
+struct Stats {
+    unsigned long packets = 0;
+    double tempSq = 0, pressSq = 0;
+    float tempMax = 0, pressMax = 0;
+    unsigned long tempOver = 0, pressOver = 0;
+    unsigned long evals = 0;
+};
+
+static float tempBound = 0.3f;
+static const float PRESS_BOUND = 0.5f;
+
+template <typename Policy>
+static Stats simulate(const std::vector<Point>& pts, Policy policy) {
+    Stats st;
+    Truth truth(pts);
+    rngState = 12345;
+
+    double t = pts.front().t;
+    double end = pts.back().t;
+    double lastEval = t;
+    float heldTemp = 0, heldPress = 0;
+
+    while (t < end) {
+        Point p = truth.at(t);
+        float mTemp = p.temp + SENSOR_TEMP_NOISE * gauss();
+        float mPress = p.press + SENSOR_PRESS_NOISE * gauss();
+        heldTemp = mTemp;
+        heldPress = mPress;
+        st.packets++;
+
+        uint16_t period = policy(mTemp, mPress);
+        double next = t + period;
+
+        // Empfänger hält den Wert bis zum nächsten Paket
+        for (double e = lastEval; e < next && e < end; e += EVAL_STEP) {
+            Point q = truth.at(e);
+            float dT = fabsf(q.temp - heldTemp);
+            float dP = fabsf(q.press - heldPress);
+            st.tempSq += dT * dT;
+            st.pressSq += dP * dP;
+            if (dT > st.tempMax) st.tempMax = dT;
+            if (dP > st.pressMax) st.pressMax = dP;
+            if (dT > tempBound) st.tempOver++;
+            if (dP > PRESS_BOUND) st.pressOver++;
+            st.evals++;
+            lastEval = e + EVAL_STEP;
+        }
+        t = next;
+    }
+    return st;
+}
+
+static void report(const char* name, const Stats& st, double days) {
+    printf("%-22s %7.1f packets/day   temp RMS %.3f °C (max %.2f, %.2f%% over)   press RMS %.3f mbar (max %.2f, %.2f%% over)\n",
+           name, st.packets / days,
+           sqrt(st.tempSq / st.evals), st.tempMax, 100.0 * st.tempOver / st.evals,
+           sqrt(st.pressSq / st.evals), st.pressMax, 100.0 * st.pressOver / st.evals);
+}
+
+int main(int argc, char** argv) {
+    std::vector<Point> pts;
+    if (!loadOrSynthesize(argc > 1 ? argv[1] : nullptr, pts)) return 1;
+
+    if (argc > 2) tempBound = (float)atof(argv[2]);
+    double days = (pts.back().t - pts.front().t) / 86400.0;
+    printf("%zu records, %.1f days, temperature bound %.2f °C\n\n", pts.size(), days, tempBound);
+
+    // Bisherige Regel
+    float lastTemp = 20.0f;
+    uint16_t period = DEFAULT_PERIOD;
+    Stats legacy = simulate(pts, [&](float temp, float) {
+        period = legacyPeriod(temp, lastTemp, period);
+        lastTemp = temp;
+        return period;
+    });
+
+    // Kalman/Trend-Modell
+    AdaptiveConfig cfg = { tempBound, PRESS_BOUND, SENSOR_TEMP_NOISE, SENSOR_PRESS_NOISE,
+                           MODEL_TEMP_DRIFT, MODEL_PRESS_DRIFT, MODEL_CONFIDENCE,
+                           MIN_SLEEP_PERIOD, MODEL_MAX_PERIOD };
+    AdaptiveModel model(cfg);
+    AdaptiveState state;
+    AdaptiveModel::reset(state);
+    uint16_t lastPeriod = 0;
+    Stats kalman = simulate(pts, [&](float temp, float press) {
+        model.update(state, temp, press, lastPeriod);
+        lastPeriod = model.nextPeriod(state, temp, press);
+        return lastPeriod;
+    });
+
+    // Referenz: fest alle 15 Minuten
+    Stats fixed = simulate(pts, [&](float, float) { return DEFAULT_PERIOD; });
+
+    report("Fixed 900 s", fixed, days);
+    report("Threshold rule", legacy, days);
+    report("Kalman/trend model", kalman, days);
+    return 0;
+}
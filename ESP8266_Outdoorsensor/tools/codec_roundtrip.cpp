@@ -0,0 +1,180 @@
+/*
+ * codec_roundtrip.cpp
+ * Host-Test für SensorCodec.h und die kompakten Batch-Blöcke aus SensorPacket.h
+ * (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * - ZigZag/Varint Grenzwerte
+ * - Zufällige Messreihen (Random Walk wie reale Sensoren) kodieren und
+ *   wieder auspacken, Ergebnis muss bitgenau gleich sein
+ * - Extremwerte: Fallback auf das feste Format, wenn der Puffer nicht reicht
+ * - Abgeschnittene Pakete: Empfänger verwirft den Batch-Block
+ * Meldet zusätzlich die mittlere Grösse pro Messwert im Vergleich zum
+ * festen Format und zu einem Einzelpaket pro Messung.
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I.. codec_roundtrip.cpp -o codec_roundtrip
+ *   ./codec_roundtrip [Durchläufe]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "SensorPacket.h"
+
+static uint32_t rngState = 2024;
+
+static uint32_t rnd() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+static int32_t rndRange(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                     \
+    do {                                     \
+        if (!(cond)) {                       \
+            printf("FAIL: " __VA_ARGS__);    \
+            printf("\n");                    \
+            failures++;                      \
+        }                                    \
+    } while (0)
+
+// ==================== VARINT ====================
+
+static void testVarint() {
+    const int32_t values[] = { 0, 1, -1, 63, -64, 64, -65, 8191, -8192, 1000000,
+                               -1000000, 0x7FFFFFFF, (int32_t)0x80000000 };
+    for (int32_t v : values) {
+        uint8_t buf[CODEC_MAX_VARINT];
+        int n = codecPutVarint(buf, sizeof(buf), codecZigZag(v));
+        uint32_t raw;
+        int m = codecGetVarint(buf, n, raw);
+        CHECK(n > 0 && m == n && codecUnZigZag(raw) == v, "varint %d (n=%d m=%d)", v, n, m);
+    }
+
+    // Zu kleiner Puffer, abgeschnittener Wert
+    uint8_t buf[2];
+    CHECK(codecPutVarint(buf, sizeof(buf), 1u << 20) == 0, "varint overflow not detected");
+    uint8_t cut[] = { 0x80, 0x80 };
+    uint32_t raw;
+    CHECK(codecGetVarint(cut, sizeof(cut), raw) == 0, "truncated varint accepted");
+
+    CHECK(codecQuantize(21.537f, 100) == 2154, "quantize positive");
+    CHECK(codecQuantize(-3.456f, 100) == -346, "quantize negative");
+}
+
+// ==================== BATCH ====================
+
+static uint8_t makeSeries(SensorBatchSample* s, bool indoor) {
+    uint8_t count = 1 + rnd() % SENSOR_BATCH_MAX;
+    int32_t age = count * rndRange(20, 900);
+    int32_t temp = rndRange(-2000, 3500);
+    int32_t press = rndRange(9500, 10400);
+    int32_t hum = rndRange(2000, 8000);
+    int32_t batt = rndRange(2600, 3300);
+
+    for (uint8_t i = 0; i < count; i++) {
+        s[i].age_sec = (uint16_t)age;
+        s[i].temperature = (int16_t)temp;
+        s[i].pressure = (uint16_t)press;
+        s[i].humidity = indoor ? (uint16_t)hum : SENSOR_BATCH_NO_HUMIDITY;
+        s[i].battery_voltage = (uint16_t)batt;
+
+        age -= rndRange(20, 900);
+        if (age < 0) age = 0;
+        temp += rndRange(-40, 40);
+        press += rndRange(-3, 3);
+        hum += rndRange(-50, 50);
+        batt += rndRange(-2, 1);
+    }
+    return count;
+}
+
+static int buildPacket(uint8_t* buf, int cap, const SensorBatchSample* s, uint8_t count, bool indoor) {
+    SensorPayloadIndoorV1 payload;
+    memset(&payload, 0, sizeof(payload));
+    uint8_t type = indoor ? SENSOR_TYPE_INDOOR : SENSOR_TYPE_OUTDOOR;
+    uint8_t plen = indoor ? sizeof(SensorPayloadIndoorV1) : sizeof(SensorPayloadOutdoorV1);
+
+    int len = sensorPacketBuild(buf, type, SENSOR_FLAG_BATCH, 1, &payload, plen);
+    return sensorPacketAppendBatchCompact(buf, len, cap, s, count);
+}
+
+static bool sameSeries(const uint8_t* buf, int len, const SensorBatchSample* s, uint8_t count) {
+    SensorPacketHeader hdr;
+    const uint8_t* payload;
+    if (!sensorPacketParse(buf, len, hdr, payload)) return false;
+    if (sensorBatchCount(buf, len, hdr) != count) return false;
+
+    for (uint8_t i = 0; i < count; i++) {
+        SensorBatchSample out;
+        if (!sensorBatchGet(buf, len, hdr, i, out)) return false;
+        if (memcmp(&out, &s[i], sizeof(out)) != 0) return false;
+    }
+    return true;
+}
+
+static void testRoundTrip(int runs, double& compactBytes, unsigned long& samples) {
+    for (int r = 0; r < runs; r++) {
+        bool indoor = r & 1;
+        SensorBatchSample s[SENSOR_BATCH_MAX];
+        uint8_t count = makeSeries(s, indoor);
+
+        uint8_t buf[250];
+        int len = buildPacket(buf, sizeof(buf), s, count, indoor);
+        CHECK(buf[offsetof(SensorPacketHeader, flags)] & SENSOR_FLAG_COMPACT, "run %d not compact", r);
+        CHECK(sameSeries(buf, len, s, count), "run %d round trip (count %d)", r, count);
+
+        // Abgeschnittenes Paket: Batch-Block muss verworfen werden
+        SensorPacketHeader hdr;
+        const uint8_t* payload;
+        sensorPacketParse(buf, len - 1, hdr, payload);
+        CHECK(sensorBatchCount(buf, len - 1, hdr) == 0, "run %d truncated packet accepted", r);
+
+        int plen = indoor ? sizeof(SensorPayloadIndoorV1) : sizeof(SensorPayloadOutdoorV1);
+        compactBytes += len - (int)sizeof(SensorPacketHeader) - plen - 1;
+        samples += count;
+    }
+}
+
+static void testFallback() {
+    // Maximal springende Werte: kompakt grösser als fest -> festes Format
+    SensorBatchSample s[SENSOR_BATCH_MAX];
+    for (int i = 0; i < SENSOR_BATCH_MAX; i++) {
+        s[i].age_sec = (i & 1) ? 0 : 0xFFFF;
+        s[i].temperature = (i & 1) ? -32768 : 32767;
+        s[i].pressure = (i & 1) ? 0 : 0xFFFF;
+        s[i].humidity = (i & 1) ? 0 : 0xFFFF;
+        s[i].battery_voltage = (i & 1) ? 0 : 0xFFFF;
+    }
+
+    uint8_t buf[sizeof(SensorPacketHeader) + sizeof(SensorPayloadIndoorV1) + 1 +
+                SENSOR_BATCH_MAX * sizeof(SensorBatchSample)];
+    int len = buildPacket(buf, sizeof(buf), s, SENSOR_BATCH_MAX, true);
+    CHECK(!(buf[offsetof(SensorPacketHeader, flags)] & SENSOR_FLAG_COMPACT), "fallback not taken");
+    CHECK(len == (int)sizeof(buf), "fallback length %d", len);
+    CHECK(sameSeries(buf, len, s, SENSOR_BATCH_MAX), "fallback round trip");
+}
+
+int main(int argc, char** argv) {
+    int runs = (argc > 1) ? atoi(argv[1]) : 10000;
+
+    double compactBytes = 0;
+    unsigned long samples = 0;
+
+    testVarint();
+    testRoundTrip(runs, compactBytes, samples);
+    testFallback();
+
+    double perSample = compactBytes / samples;
+    printf("%d runs, %lu samples: compact %.2f bytes/sample, fixed %u, single packet %u (indoor)\n",
+           runs, samples, perSample, (unsigned)sizeof(SensorBatchSample),
+           (unsigned)(sizeof(SensorPacketHeader) + sizeof(SensorPayloadIndoorV1)));
+    printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * csv_bench.cpp
+ * Host-Benchmark für CsvReader.h (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Erzeugt eine 30-Tage Outdoor-Monatsdatei (alle 15 min, wie der CYD Master)
+ * und eine Datalogger-Datei mit leeren Feldern, parst beide und meldet
+ * Datensätze/Sekunde sowie die Anzahl Heap-Allokationen während des Parsens.
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I../CYD_I2C_Receiver/CYD_I2C_Master csv_bench.cpp -o csv_bench
+ *   ./csv_bench [Wiederholungen]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "CsvReader.h"
+
+// ==================== ALLOKATIONS-ZÄHLER ====================
+
+static size_t allocCount = 0;
+
+void* operator new(size_t size) {
+    allocCount++;
+    void* p = malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ==================== QUELLE ====================
+
+// Dateiquelle mit derselben read()-Signatur wie SD File
+class FileSource {
+private:
+    FILE* fp;
+
+public:
+    explicit FileSource(FILE* f) : fp(f) {}
+
+    int read(uint8_t* buf, size_t len) {
+        return (int)fread(buf, 1, len, fp);
+    }
+};
+
+// ==================== TESTDATEN ====================
+
+static const int DAYS = 30;
+static const int RECORDS_PER_DAY = 96;   // alle 15 Minuten
+
+static void writeMonthlyFile(const char* path) {
+    FILE* fp = fopen(path, "w");
+    fprintf(fp, "DateTime,Temperature_C,Pressure_mbar,Battery_mV,RSSI_dBm,Battery_Warning,Sleep_Time_sec\n");
+
+    for (int d = 0; d < DAYS; d++) {
+        for (int r = 0; r < RECORDS_PER_DAY; r++) {
+            int minutes = r * 15;
+            float temp = -5.0f + (d % 7) + (r % 40) * 0.3f;
+            fprintf(fp, "2025-01-%02d %02d:%02d:00,%.1f,%d,%d,%d,0,300\r\n",
+                    d + 1, minutes / 60, minutes % 60, temp, 1000 + (r % 30), 4100 - d, -60 - (r % 20));
+        }
+    }
+    fclose(fp);
+}
+
+static void writeDataloggerFile(const char* path) {
+    FILE* fp = fopen(path, "w");
+    unsigned long ts = 0;
+
+    for (int i = 0; i < DAYS * RECORDS_PER_DAY; i++) {
+        ts += 900000;
+        fprintf(fp, "%lu,,,%.2f,%.2f,%.2f,%u,%u,,%u,%u,%u,%u\n",
+                ts, 21.5f + (i % 10) * 0.1f, 45.0f + (i % 5), 1013.25f, 3900u, 0u, 300u, 120u, 0u, 5u);
+    }
+    fclose(fp);
+}
+
+// ==================== BENCHMARK ====================
+
+struct Result {
+    unsigned long records;
+    long long checksum;     // verhindert, dass der Compiler das Parsen wegoptimiert
+    bool ok;
+};
+
+static Result parseMonthly(const char* path) {
+    Result res = { 0, 0, true };
+    FILE* fp = fopen(path, "rb");
+    FileSource src(fp);
+    CsvReader<FileSource> csv(src);
+
+    csv.next();  // Header
+    while (csv.next()) {
+        int32_t temp, press, batt;
+        if (csv.count() < 4 || !csvParseFixed(csv.field(1), temp, 1) ||
+            !csvParseInt(csv.field(2), press) || !csvParseInt(csv.field(3), batt)) {
+            res.ok = false;
+            continue;
+        }
+        res.checksum += temp + press + batt;
+        res.records++;
+    }
+    fclose(fp);
+    return res;
+}
+
+static Result parseDatalogger(const char* path) {
+    Result res = { 0, 0, true };
+    FILE* fp = fopen(path, "rb");
+    FileSource src(fp);
+    CsvReader<FileSource> csv(src);
+
+    while (csv.next()) {
+        int32_t temp, batt;
+        // Felder 1, 2 (Date, Time) und 8 (RSSI) sind leer
+        if (csv.count() != 13 || !csv.field(1).isEmpty() || !csv.field(8).isEmpty() ||
+            !csvParseFixed(csv.field(3), temp, 2) || !csvParseInt(csv.field(6), batt)) {
+            res.ok = false;
+            continue;
+        }
+        res.checksum += temp + batt;
+        res.records++;
+    }
+    fclose(fp);
+    return res;
+}
+
+static bool selfTest() {
+    struct { const char* text; uint8_t decimals; int32_t expected; bool valid; } cases[] = {
+        { "-3.4", 1, -34, true },
+        { "-3.4", 2, -340, true },
+        { "21.57", 1, 215, true },
+        { "1013", 0, 1013, true },
+        { "+0.5", 1, 5, true },
+        { "", 1, 0, false },
+        { "abc", 1, 0, false },
+    };
+
+    bool ok = true;
+    for (auto& c : cases) {
+        CsvField f = { c.text, (uint16_t)strlen(c.text) };
+        int32_t v = 0;
+        bool valid = csvParseFixed(f, v, c.decimals);
+        if (valid != c.valid || (valid && v != c.expected)) {
+            printf("FAIL: \"%s\" (decimals %d) -> %d (valid %d)\n", c.text, c.decimals, v, valid);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int repeats = (argc > 1) ? atoi(argv[1]) : 50;
+    const char* monthly = "/tmp/csv_bench_outdoor.csv";
+    const char* datalogger = "/tmp/csv_bench_datalogger.csv";
+
+    if (!selfTest()) return 1;
+
+    writeMonthlyFile(monthly);
+    writeDataloggerFile(datalogger);
+
+    const char* names[] = { "Monthly (YYYYMM_outdoor.csv)", "Datalogger (indoor_log.csv)" };
+    Result (*parsers[])(const char*) = { parseMonthly, parseDatalogger };
+    const char* paths[] = { monthly, datalogger };
+
+    bool allOk = true;
+    for (int p = 0; p < 2; p++) {
+        size_t allocsBefore = allocCount;
+        unsigned long total = 0;
+        Result res = { 0, 0, true };
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; i++) {
+            res = parsers[p](paths[p]);
+            total += res.records;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double sec = std::chrono::duration<double>(end - start).count();
+        size_t allocs = allocCount - allocsBefore;
+
+        printf("%-30s %lu records x %d: %.0f records/s, %zu heap allocations%s\n",
+               names[p], res.records, repeats, total / sec, allocs, res.ok ? "" : " (PARSE ERRORS)");
+
+        allOk = allOk && res.ok && res.records == (unsigned long)(DAYS * RECORDS_PER_DAY);
+    }
+
+    remove(monthly);
+    remove(datalogger);
+    return allOk ? 0 : 1;
+}
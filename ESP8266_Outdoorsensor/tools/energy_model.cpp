@@ -0,0 +1,289 @@
+/*
+ * energy_model.cpp
+ * Energie-Budget des Sensors pro Sleep-Policy (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Spielt eine aufgezeichnete Temperatur-/Druckreihe ab (wie adaptive_sim)
+ * und zählt pro Policy die Wakes mit und ohne Funk:
+ * - Fest alle 15 Minuten
+ * - Schwellwert-Regel (calculateAdaptivePeriod() im Sketch)
+ * - Kalman/Trend-Modell (AdaptiveModel.h)
+ * - Kalman/Trend-Modell mit BATCH_MODE (Funk nur jeden send_every-ten Wake)
+ * Jeder Wake kostet Ladung nach Phasen (wie SensorTimingV1 im Paket):
+ *   boot, sensor, radio init, send, sleep setup; dazu alle rfcal_every
+ *   Funk-Wakes eine volle RF-Kalibrierung und der Deep-Sleep-Strom.
+ * Daraus: mittlerer Strom und Laufzeit der Batterie.
+ *
+ * Stromprofil: Textdatei mit "key = value" Zeilen (# Kommentar), fehlende
+ * Werte behalten die Defaults unten. Die Phasen-Zeiten lassen sich aus den
+ * "Phases:" Zeilen eines Empfängers übernehmen. Enthält das Log eine
+ * Duration_ms Spalte (Datalogger), werden sensor/radio init/send so skaliert,
+ * dass ihre Summe der gemessenen mittleren Wachzeit entspricht.
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I.. -I../CYD_I2C_Receiver/CYD_I2C_Master energy_model.cpp -o energy_model
+ *   ./energy_model [log.csv|-] [profile.txt]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AdaptiveModel.h"
+#include "SensorSim.h"
+
+// ==================== STROMPROFIL ====================
+
+struct Profile {
+    double battery_mah = 2000;          // Nennkapazität
+    double usable = 0.8;                // Nutzbarer Anteil bis BATTERY_LIMIT
+    double self_discharge_pct_year = 3; // Selbstentladung in % der Kapazität pro Jahr
+    double sleep_ua = 20;               // Deep Sleep
+
+    double cpu_ma = 20;                 // boot, sensor, sleep setup (Funk aus)
+    double radio_ma = 75;               // radio init (Empfänger an)
+    double tx_ma = 120;                 // send
+    double rfcal_ma = 75;               // volle RF-Kalibrierung beim Boot
+
+    double boot_ms = 80;
+    double sensor_ms = 35;
+    double radio_init_ms = 40;
+    double send_ms = 6;
+    double sleep_setup_ms = 2;
+    double rfcal_ms = 40;
+
+    double rfcal_every = 24;            // RFCAL_EVERY
+    double send_every = 4;              // BATCH_SEND_EVERY
+    double flush_temp = 1.0;            // BATCH_FLUSH_TEMP
+};
+
+struct ProfileKey {
+    const char* name;
+    double Profile::*field;
+};
+
+static const ProfileKey PROFILE_KEYS[] = {
+    { "battery_mah", &Profile::battery_mah },
+    { "usable", &Profile::usable },
+    { "self_discharge_pct_year", &Profile::self_discharge_pct_year },
+    { "sleep_ua", &Profile::sleep_ua },
+    { "cpu_ma", &Profile::cpu_ma },
+    { "radio_ma", &Profile::radio_ma },
+    { "tx_ma", &Profile::tx_ma },
+    { "rfcal_ma", &Profile::rfcal_ma },
+    { "boot_ms", &Profile::boot_ms },
+    { "sensor_ms", &Profile::sensor_ms },
+    { "radio_init_ms", &Profile::radio_init_ms },
+    { "send_ms", &Profile::send_ms },
+    { "sleep_setup_ms", &Profile::sleep_setup_ms },
+    { "rfcal_ms", &Profile::rfcal_ms },
+    { "rfcal_every", &Profile::rfcal_every },
+    { "send_every", &Profile::send_every },
+    { "flush_temp", &Profile::flush_temp },
+};
+
+static bool loadProfile(const char* path, Profile& prof) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return false;
+
+    char line[128];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        for (char* c = line; *c; c++) {
+            if (*c == '=') *c = ' ';
+        }
+
+        char key[48];
+        double value;
+        int n = sscanf(line, "%47s %lf", key, &value);
+        if (n <= 0) continue;   // Leer- oder Kommentarzeile
+
+        bool known = false;
+        for (const ProfileKey& k : PROFILE_KEYS) {
+            if (n == 2 && strcmp(k.name, key) == 0) {
+                prof.*k.field = value;
+                known = true;
+            }
+        }
+        if (!known) fprintf(stderr, "%s:%d: ignored '%s'\n", path, lineNo, key);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+// ==================== SIMULATION ====================
+
+struct Budget {
+    unsigned long wakes = 0;
+    unsigned long radioWakes = 0;
+    unsigned long rfcals = 0;
+    double activeMas = 0;       // mA * s in Wach-Phasen
+};
+
+// Ladung pro Wake in mAs
+static double cpuWakeMas(const Profile& p) {
+    return p.cpu_ma * (p.boot_ms + p.sensor_ms + p.sleep_setup_ms) / 1000.0;
+}
+
+static double radioWakeMas(const Profile& p) {
+    return cpuWakeMas(p) + (p.radio_ma * p.radio_init_ms + p.tx_ma * p.send_ms) / 1000.0;
+}
+
+static void chargeRadioWake(Budget& b, const Profile& p) {
+    b.wakes++;
+    b.radioWakes++;
+    b.activeMas += radioWakeMas(p);
+
+    // Wie nextWakeOption(): jeder (rfcal_every + 1)-te Funk-Wake kalibriert voll
+    if (p.rfcal_every <= 0 || b.radioWakes % ((unsigned long)p.rfcal_every + 1) == 0) {
+        b.rfcals++;
+        b.activeMas += p.rfcal_ma * p.rfcal_ms / 1000.0;
+    }
+}
+
+static void chargeCpuWake(Budget& b, const Profile& p) {
+    b.wakes++;
+    b.activeMas += cpuWakeMas(p);
+}
+
+// Policy liefert die nächste Periode; batch = Funk nach der BATCH_MODE-Logik des Sketches
+template <typename Policy>
+static Budget simulate(const std::vector<Point>& pts, const Profile& prof, bool batch, Policy policy) {
+    Budget b;
+    Truth truth(pts);
+    rngState = 12345;
+
+    double t = pts.front().t;
+    double end = pts.back().t;
+
+    // BATCH_MODE Zustand wie im Sketch (batchShouldSend/batchNextWakeSends)
+    unsigned buffered = 0;
+    float sentTemp = 0;
+    bool rfOff = false;
+    bool firstWake = true;
+
+    while (t < end) {
+        Point p = truth.at(t);
+        float mTemp = p.temp + SENSOR_TEMP_NOISE * gauss();
+        float mPress = p.press + SENSOR_PRESS_NOISE * gauss();
+
+        if (!batch) {
+            chargeRadioWake(b, prof);
+        } else {
+            bool send = firstWake || buffered + 1 >= prof.send_every ||
+                        fabsf(mTemp - sentTemp) >= prof.flush_temp;
+            if (!send) {
+                chargeCpuWake(b, prof);
+                buffered++;
+            } else {
+                // Wake ohne Funk: Neustart mit Funk, dort wird erneut gemessen
+                if (rfOff) chargeCpuWake(b, prof);
+                chargeRadioWake(b, prof);
+                buffered = 0;
+                sentTemp = mTemp;
+            }
+            rfOff = !(buffered + 1 >= prof.send_every);
+            firstWake = false;
+        }
+
+        t += policy(mTemp, mPress);
+    }
+    return b;
+}
+
+// Mittlere Wachzeit der Log-Zeilen (Datalogger Duration_ms), < 0 wenn keine
+static double meanLoggedDuration(const std::vector<Point>& pts) {
+    double sum = 0;
+    unsigned long n = 0;
+    for (const Point& p : pts) {
+        if (p.duration > 0) {
+            sum += p.duration;
+            n++;
+        }
+    }
+    return n ? sum / n : -1;
+}
+
+static void report(const char* name, const Budget& b, const Profile& prof, double days) {
+    double seconds = days * 86400.0;
+    double activeMah = b.activeMas / 3600.0;
+    double sleepMah = prof.sleep_ua / 1000.0 * seconds / 3600.0;
+    double selfMah = prof.battery_mah * prof.self_discharge_pct_year / 100.0 * days / 365.0;
+    double perDay = (activeMah + sleepMah + selfMah) / days;
+    double avgUa = (activeMah + sleepMah) / (seconds / 3600.0) * 1000.0;
+    double lifeDays = prof.battery_mah * prof.usable / perDay;
+
+    printf("%-22s %7.1f wakes/day %6.1f radio/day   avg %6.1f uA   %.3f mAh/day (active %.3f, sleep %.3f, self %.3f)   life %6.0f days (%.1f years)\n",
+           name, b.wakes / days, b.radioWakes / days, avgUa, perDay,
+           activeMah / days, sleepMah / days, selfMah / days, lifeDays, lifeDays / 365.0);
+}
+
+int main(int argc, char** argv) {
+    std::vector<Point> pts;
+    if (!loadOrSynthesize(argc > 1 ? argv[1] : nullptr, pts)) return 1;
+
+    Profile prof;
+    if (argc > 2 && !loadProfile(argv[2], prof)) {
+        fprintf(stderr, "Cannot read profile %s\n", argv[2]);
+        return 1;
+    }
+
+    double days = (pts.back().t - pts.front().t) / 86400.0;
+    printf("%zu records, %.1f days, battery %.0f mAh (%.0f%% usable)\n",
+           pts.size(), days, prof.battery_mah, prof.usable * 100);
+
+    double logged = meanLoggedDuration(pts);
+    double phaseSum = prof.sensor_ms + prof.radio_init_ms + prof.send_ms;
+    if (logged > 0 && phaseSum > 0) {
+        double k = logged / phaseSum;
+        prof.sensor_ms *= k;
+        prof.radio_init_ms *= k;
+        prof.send_ms *= k;
+        printf("Phases scaled x%.2f to logged mean duration %.1f ms\n", k, logged);
+    }
+    printf("Wake: boot %.0f, sensor %.1f, radio init %.1f, send %.1f, sleep setup %.0f ms -> %.2f mAs with radio, %.2f mAs without\n\n",
+           prof.boot_ms, prof.sensor_ms, prof.radio_init_ms, prof.send_ms, prof.sleep_setup_ms,
+           radioWakeMas(prof), cpuWakeMas(prof));
+
+    auto fixedPolicy = [](float, float) { return DEFAULT_PERIOD; };
+
+    float lastTemp = 20.0f;
+    uint16_t period = DEFAULT_PERIOD;
+    auto legacyPolicy = [&](float temp, float) {
+        period = legacyPeriod(temp, lastTemp, period);
+        lastTemp = temp;
+        return period;
+    };
+
+    AdaptiveConfig cfg = { 0.3f, 0.5f, SENSOR_TEMP_NOISE, SENSOR_PRESS_NOISE,
+                           MODEL_TEMP_DRIFT, MODEL_PRESS_DRIFT, MODEL_CONFIDENCE,
+                           MIN_SLEEP_PERIOD, MODEL_MAX_PERIOD };
+    AdaptiveModel model(cfg);
+    AdaptiveState state;
+    uint16_t lastPeriod = 0;
+    auto modelPolicy = [&](float temp, float press) {
+        model.update(state, temp, press, lastPeriod);
+        lastPeriod = model.nextPeriod(state, temp, press);
+        return lastPeriod;
+    };
+
+    Budget fixed = simulate(pts, prof, false, fixedPolicy);
+    Budget legacy = simulate(pts, prof, false, legacyPolicy);
+    AdaptiveModel::reset(state);
+    lastPeriod = 0;
+    Budget kalman = simulate(pts, prof, false, modelPolicy);
+    AdaptiveModel::reset(state);
+    lastPeriod = 0;
+    Budget batched = simulate(pts, prof, true, modelPolicy);
+
+    report("Fixed 900 s", fixed, prof, days);
+    report("Threshold rule", legacy, prof, days);
+    report("Kalman/trend model", kalman, prof, days);
+    report("Kalman + batch", batched, prof, days);
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * freshness_sim.cpp
+ * Host-Test für Freshness.h (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Simuliert Paketfolgen eines Sensors und prüft den Zustand kurz vor jedem
+ * Empfang und in der Mitte jedes Abstands:
+ * - Normalbetrieb: 60 s Periode mit Wachzeit und Jitter
+ * - BATCH_MODE: Paket nur jeden 4. Wake (BATCH_SEND_EVERY), angekündigt
+ *   wird die Periode eines einzelnen Wakes (900 s)
+ * - Ausfall: drei Pakete fehlen, das Verhältnis darf sich nicht verschieben
+ * - Verlustreiche Strecke: 10 % einzelne Pakete fehlen (Abstand 2x, nur LATE),
+ *   die LATE-Schwelle darf nicht wachsen
+ * - Umschalten auf BATCH_MODE im laufenden Betrieb (Neulernen), auch auf
+ *   jeden 2. Wake (Abstände enden nur in LATE)
+ * - millis()-Überlauf mitten in der Folge
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I../CYD_I2C_Receiver/CYD_I2C_Master freshness_sim.cpp -o freshness_sim
+ *   ./freshness_sim
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "Freshness.h"
+
+static uint32_t rngState = 4711;
+
+static uint32_t rnd() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// Gleichverteilter Jitter in ±range ms
+static int32_t jitter(int32_t range) {
+    return (int32_t)(rnd() % (uint32_t)(2 * range + 1)) - range;
+}
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                     \
+    do {                                     \
+        if (!(cond)) {                       \
+            printf("FAIL: " __VA_ARGS__);    \
+            printf("\n");                    \
+            failures++;                      \
+        }                                    \
+    } while (0)
+
+// Zustände innerhalb eines Abstands, die nicht auftreten dürfen, zählen
+struct RunStats {
+    int lostBefore = 0;         // LOST kurz vor dem nächsten Paket
+    int notFreshMid = 0;        // Nicht FRESH in der Mitte des Abstands
+};
+
+/**
+ * Pakete im Abstand wakes × periodSec (+ Wachzeit, Jitter) einspeisen
+ * @param skipFrom/skipCount Pakete ab Index skipFrom gehen verloren
+ * @param checkFrom Zustände erst ab diesem Paket werten (Anlernphase)
+ */
+static RunStats run(SensorFreshness& f, uint32_t& nowMs, int packets, uint16_t periodSec,
+                    int wakes, int checkFrom, int skipFrom = -1, int skipCount = 0) {
+    RunStats st;
+    for (int i = 0; i < packets; i++) {
+        uint32_t interval = (uint32_t)wakes * (periodSec * 1000UL + 300) + jitter(periodSec * 5);
+        uint32_t prev = nowMs;
+        nowMs += interval;
+
+        if (i >= skipFrom && i < skipFrom + skipCount) continue;
+
+        if (i >= checkFrom) {
+            if (f.state(nowMs - 1) == FRESHNESS_LOST) st.lostBefore++;
+            if (f.state(prev + interval / 2) != FRESHNESS_FRESH) st.notFreshMid++;
+        }
+        f.arrival(nowMs, periodSec);
+    }
+    return st;
+}
+
+// ==================== SZENARIEN ====================
+
+static void testNormal() {
+    SensorFreshness f;
+    uint32_t now = 1000;
+    f.arrival(now, 60);
+    RunStats st = run(f, now, 100, 60, 1, 1);
+
+    CHECK(st.lostBefore == 0, "normal: %d intervals ended lost", st.lostBefore);
+    CHECK(st.notFreshMid == 0, "normal: %d midpoints not fresh", st.notFreshMid);
+    CHECK(f.getRatio() > 0.98f && f.getRatio() < 1.03f, "normal: ratio %.3f", f.getRatio());
+
+    // Ohne weiteres Paket: LATE nach ~1 Periode, LOST nach ~2 Perioden
+    CHECK(f.state(now + 70000) == FRESHNESS_LATE, "normal: not late after 70 s (%s)",
+          SensorFreshness::stateName(f.state(now + 70000)));
+    CHECK(f.state(now + 130000) == FRESHNESS_LOST, "normal: not lost after 130 s");
+    printf("normal:   ratio %.3f dev %.3f learned %u\n",
+           f.getRatio(), f.getDeviation(), (unsigned)f.getLearned());
+}
+
+static void testBatch() {
+    SensorFreshness f;
+    uint32_t now = 1000;
+    f.arrival(now, 900);
+    // Das erste Intervall endet zwangsläufig in LOST (Startwert 1.0), danach nie mehr
+    RunStats st = run(f, now, 50, 900, 4, 1);
+
+    CHECK(f.getLearned() >= 40, "batch: only %u intervals learned", (unsigned)f.getLearned());
+    CHECK(f.getRatio() > 3.9f && f.getRatio() < 4.1f, "batch: ratio %.3f", f.getRatio());
+    CHECK(st.lostBefore == 0, "batch: %d intervals ended lost", st.lostBefore);
+    CHECK(st.notFreshMid == 0, "batch: %d midpoints not fresh", st.notFreshMid);
+    CHECK(f.state(now + 4 * 900000UL + 400000UL) == FRESHNESS_LATE, "batch: not late after a missed batch");
+    printf("batch:    ratio %.3f dev %.3f learned %u\n",
+           f.getRatio(), f.getDeviation(), (unsigned)f.getLearned());
+}
+
+static void testOutage() {
+    SensorFreshness f;
+    uint32_t now = 1000;
+    f.arrival(now, 60);
+    run(f, now, 50, 60, 1, 1);
+    float before = f.getRatio();
+
+    // Pakete 10..12 gehen verloren, der lange Abstand darf nicht gelernt werden
+    RunStats st = run(f, now, 30, 60, 1, 14, 10, 3);
+    CHECK(st.lostBefore == 0, "outage: %d intervals ended lost after recovery", st.lostBefore);
+    CHECK(f.getRatio() > before - 0.03f && f.getRatio() < before + 0.03f,
+          "outage: ratio moved %.3f -> %.3f", before, f.getRatio());
+    printf("outage:   ratio %.3f -> %.3f\n", before, f.getRatio());
+}
+
+static void testLossy() {
+    SensorFreshness f;
+    uint32_t now = 1000;
+    f.arrival(now, 900);
+    run(f, now, 50, 900, 1, 1);
+    uint32_t lateBefore = f.nextChange(f.lastArrival());
+
+    // 500 Pakete, jedes mit 10 % Wahrscheinlichkeit verloren (einzeln)
+    int lostPackets = 0;
+    bool prevLost = false;
+    for (int i = 0; i < 500; i++) {
+        now += 900000UL + 300 + jitter(4500);
+        bool lost = !prevLost && rnd() % 10 == 0;
+        prevLost = lost;
+        if (lost) {
+            lostPackets++;
+            continue;
+        }
+        f.arrival(now, 900);
+    }
+
+    uint32_t lateAfter = f.nextChange(f.lastArrival());
+    CHECK(lateAfter < lateBefore + 10000, "lossy: late threshold grew %lu -> %lu ms",
+          (unsigned long)lateBefore, (unsigned long)lateAfter);
+    CHECK(f.getRatio() > 0.98f && f.getRatio() < 1.03f, "lossy: ratio %.3f", f.getRatio());
+    printf("lossy:    %d lost, late after %lu -> %lu s, ratio %.3f\n", lostPackets,
+           (unsigned long)lateBefore / 1000, (unsigned long)lateAfter / 1000, f.getRatio());
+}
+
+static void testSwitchToBatch() {
+    SensorFreshness f;
+    uint32_t now = 1000;
+    f.arrival(now, 900);
+    run(f, now, 30, 900, 1, 1);
+
+    // Ab jetzt nur jeder 4. Wake: nach RELEARN_GAPS Abständen neu gelernt
+    RunStats st = run(f, now, 30, 900, 4, FRESHNESS_RELEARN_GAPS);
+    CHECK(st.lostBefore == 0, "switch: %d intervals ended lost after relearn", st.lostBefore);
+    CHECK(f.getRatio() > 3.9f && f.getRatio() < 4.1f, "switch: ratio %.3f", f.getRatio());
+    printf("switch:   ratio %.3f learned %u\n", f.getRatio(), (unsigned)f.getLearned());
+
+    // Jeder 2. Wake: Abstände enden in LATE statt LOST, trotzdem neu lernen
+    SensorFreshness g;
+    now = 1000;
+    g.arrival(now, 900);
+    run(g, now, 30, 900, 1, 1);
+    st = run(g, now, 30, 900, 2, FRESHNESS_RELEARN_GAPS);
+    CHECK(st.lostBefore == 0 && st.notFreshMid == 0, "switch x2: lost %d, not fresh %d",
+          st.lostBefore, st.notFreshMid);
+    CHECK(g.getRatio() > 1.95f && g.getRatio() < 2.05f, "switch x2: ratio %.3f", g.getRatio());
+    CHECK(g.state(now + 1800000UL - 1) == FRESHNESS_FRESH, "switch x2: not fresh before next batch");
+    printf("switch x2: ratio %.3f learned %u\n", g.getRatio(), (unsigned)g.getLearned());
+}
+
+static void testWrap() {
+    SensorFreshness f;
+    uint32_t now = 0xFFFFFFFFUL - 5 * 60000UL;     // Überlauf nach ~5 Paketen
+    f.arrival(now, 60);
+    RunStats st = run(f, now, 20, 60, 1, 1);
+    CHECK(st.lostBefore == 0 && st.notFreshMid == 0, "wrap: lost %d, not fresh %d",
+          st.lostBefore, st.notFreshMid);
+    CHECK(f.nextChange(now) != FRESHNESS_NEVER && f.nextChange(now) < 120000UL,
+          "wrap: nextChange %lu", f.nextChange(now));
+}
+
+int main() {
+    testNormal();
+    testBatch();
+    testOutage();
+    testLossy();
+    testSwitchToBatch();
+    testWrap();
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
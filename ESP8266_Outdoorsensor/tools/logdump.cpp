@@ -0,0 +1,77 @@
+/*
+ * logdump.cpp
+ * Binär-Segmente des ESP32_C3_Datalogger nach CSV wandeln
+ * (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Liest ein oder mehrere .bin Segmente aus /logs (LogRecord.h) und schreibt
+ * dieselben Spalten wie die CSV-Segmente auf stdout - Header einmal, danach
+ * alle Datensätze in Dateireihenfolge. Segmente eines Stroms in aufsteigender
+ * Nummer übergeben (z.B. per Shell-Glob), dann entsteht ein durchgehendes Log.
+ * Date/Time in der Lokalzeit, die beim Anlegen des Segments galt.
+ * Ein abgebrochener letzter Datensatz (Stromausfall) wird gemeldet und
+ * übersprungen.
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I../ESP32_C3_Datalogger logdump.cpp -o logdump
+ *   ./logdump indoor_00000.bin indoor_00001.bin > indoor.csv
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "LogRecord.h"
+
+// Ein Segment ausgeben; false bei unlesbarem oder fremdem Header
+static bool dumpSegment(const char* path, bool& headerPrinted, unsigned long& records) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    LogFileHeaderV1 hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != LOG_BIN_MAGIC ||
+        hdr.version != LOG_BIN_VERSION || hdr.record_size != sizeof(LogRecordV1)) {
+        fprintf(stderr, "%s: not a v%d log segment\n", path, LOG_BIN_VERSION);
+        fclose(f);
+        return false;
+    }
+
+    LogRecordV1 rec;
+    char line[160];
+    size_t n;
+    while ((n = fread(&rec, 1, sizeof(rec), f)) == sizeof(rec)) {
+        if (!headerPrinted) {
+            puts(rec.schema == SCHEMA_INDOOR ? INDOOR_CSV_HEADER : OUTDOOR_CSV_HEADER);
+            headerPrinted = true;
+        }
+        logRecordToCsv(rec, hdr.utc_offset_min, line, sizeof(line));
+        puts(line);
+        records++;
+    }
+    if (n != 0) {
+        fprintf(stderr, "%s: truncated record at end (%zu bytes) skipped\n", path, n);
+    }
+
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s segment.bin [segment.bin ...]\n", argv[0]);
+        return 2;
+    }
+
+    bool headerPrinted = false;
+    unsigned long records = 0;
+    int errors = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!dumpSegment(argv[i], headerPrinted, records)) errors++;
+    }
+
+    fprintf(stderr, "%lu records from %d segment(s), %d error(s)\n",
+            records, argc - 1 - errors, errors);
+    return errors ? 1 : 0;
+}
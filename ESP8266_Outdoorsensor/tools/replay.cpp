@@ -0,0 +1,349 @@
+/*
+ * replay.cpp
+ * ESP-NOW Mitschnitte (CaptureFormat.h) auf dem PC nachspielen
+ * (läuft auf dem PC, nicht auf dem ESP)
+ *
+ * Jeder Frame läuft wie im Datalogger durch denselben Code:
+ * - Zeit-Beacons stellen die Uhr (wie wallClock() im Sketch)
+ * - SensorIngest::ingest() inkl. gepufferter Batch-Werte
+ * - 24h Min/Max der primären Sensoren (RollingMinMax.h, Grössen wie im CYD Master)
+ * - Aktualität (Freshness.h): Wechsel nach late/lost zwischen den Frames
+ * - Log-Datensatz und CSV-Zeile (LogRecord.h), mit --csv auch als Dateien
+ *
+ * Ausgabe: Geräte mit Link-Statistik, Min/Max am Ende des Mitschnitts,
+ * Zustandswechsel, Log-Umfang und Durchsatz (Frames/s, Vielfaches der
+ * Echtzeit). Mit --repeat N wird N-mal von vorn gespielt und die
+ * schnellste Runde gemeldet - für Vergleiche vor/nach Parser-Änderungen.
+ *
+ * Build & Run:
+ *   g++ -O2 -std=c++17 -I../ESP32_C3_Datalogger -I../CYD_I2C_Receiver/CYD_I2C_Master replay.cpp -o replay
+ *   ./replay [--repeat N] [--csv DIR] cap_00000.ecap [cap_00001.ecap ...]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CaptureFormat.h"
+#include "Freshness.h"
+#include "LogRecord.h"
+#include "RollingMinMax.h"
+#include "SensorIngest.h"
+
+// Grössen wie im CYD Master
+enum MinMaxQuantity {
+    MM_INDOOR_TEMP, MM_INDOOR_HUM, MM_INDOOR_PRESS, MM_INDOOR_BATT,
+    MM_OUTDOOR_TEMP, MM_OUTDOOR_PRESS, MM_OUTDOOR_BATT,
+    MM_QUANTITY_COUNT
+};
+
+static const char* MM_NAMES[MM_QUANTITY_COUNT] = {
+    "Indoor temp", "Indoor hum", "Indoor press", "Indoor batt",
+    "Outdoor temp", "Outdoor press", "Outdoor batt"
+};
+
+// ==================== MITSCHNITT LADEN ====================
+
+struct Capture {
+    std::vector<RawFrame> frames;
+    uint64_t spanMs = 0;        // Summe der Zeitspannen aller Dateien
+    int files = 0;
+};
+
+static bool loadCapture(const char* path, Capture& cap) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+    fclose(f);
+
+    CaptureFileHeaderV1 hdr;
+    if (buf.size() < sizeof(hdr)) {
+        fprintf(stderr, "%s: too short\n", path);
+        return false;
+    }
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    if (!captureHeaderValid(hdr)) {
+        fprintf(stderr, "%s: not a v%d capture\n", path, CAPTURE_VERSION);
+        return false;
+    }
+
+    size_t pos = sizeof(hdr);
+    size_t first = cap.frames.size();
+    RawFrame frame;
+    while (pos < buf.size()) {
+        size_t used = captureFrameDecode(buf.data() + pos, buf.size() - pos, frame);
+        if (used == 0) {
+            fprintf(stderr, "%s: truncated frame at offset %zu skipped\n", path, pos);
+            break;
+        }
+        cap.frames.push_back(frame);
+        pos += used;
+    }
+
+    if (cap.frames.size() > first) {
+        cap.spanMs += (uint32_t)(cap.frames.back().rxMs - cap.frames[first].rxMs);
+    }
+    cap.files++;
+    return true;
+}
+
+// ==================== EMPFÄNGER ====================
+
+// Zustand eines Empfängers, wie im Datalogger-Sketch
+struct Replay {
+    SensorIngest ingest;
+    RollingMinMaxSet<MM_QUANTITY_COUNT> minMax;
+    SensorFreshness freshness[2];       // Primärer Indoor / Outdoor
+    FreshnessState shown[2] = { FRESHNESS_NONE, FRESHNESS_NONE };
+
+    uint32_t clockEpoch = 0;
+    uint16_t clockEpochMs = 0;
+    int16_t clockOffsetMin = 0;
+    unsigned long clockAnchorMs = 0;
+
+    uint32_t beacons = 0;
+    uint32_t controls = 0;
+    uint32_t dropped = 0;
+    uint32_t records = 0;
+    uint32_t batchRecords = 0;
+    uint64_t csvBytes = 0;
+    uint32_t lateEvents[2] = { 0, 0 };
+    uint32_t lostEvents[2] = { 0, 0 };
+    uint32_t lastMinMaxTime = 0;
+
+    const char* csvDir = nullptr;
+    std::map<std::string, FILE*> csvFiles;
+
+    Replay() { minMax.begin(); }
+
+    ~Replay() {
+        for (auto& it : csvFiles) fclose(it.second);
+    }
+
+    uint32_t wallClock(unsigned long ms) const {
+        if (clockEpoch == 0) return 0;
+        long diff = (long)(int32_t)(ms - clockAnchorMs);
+        int64_t t = (int64_t)clockEpoch * 1000 + clockEpochMs + diff;
+        return (uint32_t)(t / 1000);
+    }
+
+    void writeCsv(const char* stream, uint8_t schema, const char* line) {
+        FILE*& f = csvFiles[stream];
+        if (!f) {
+            std::string path = std::string(csvDir) + "/" + stream + ".csv";
+            f = fopen(path.c_str(), "w");
+            if (!f) {
+                fprintf(stderr, "%s: cannot create\n", path.c_str());
+                csvDir = nullptr;
+                return;
+            }
+            fputs(schema == SCHEMA_INDOOR ? INDOOR_CSV_HEADER : OUTDOOR_CSV_HEADER, f);
+            fputs("\r\n", f);
+        }
+        fputs(line, f);
+        fputs("\r\n", f);
+    }
+
+    void logSample(const char* stream, uint8_t schema, const SensorSample& data,
+                   unsigned long ts, bool batch) {
+        LogRecordV1 rec;
+        logRecordFromSample(rec, data, schema, ts, data.epoch ? data.epoch : wallClock(ts), batch);
+
+        char line[160];
+        int n = logRecordToCsv(rec, clockOffsetMin, line, sizeof(line));
+        csvBytes += n + 2;
+        records++;
+        if (batch) batchRecords++;
+        if (csvDir) writeCsv(stream, schema, line);
+    }
+
+    void updateMinMax(const SensorDevice& dev, unsigned long rxMs) {
+        uint32_t t = minMax.now(wallClock(rxMs), rxMs / 1000);
+        if (t == 0) return;
+        lastMinMaxTime = t;
+
+        const SensorSample& s = dev.last;
+        if (dev.schema == SCHEMA_INDOOR) {
+            minMax[MM_INDOOR_TEMP].update(t, s.temperature);
+            minMax[MM_INDOOR_HUM].update(t, s.humidity);
+            minMax[MM_INDOOR_PRESS].update(t, s.pressure);
+            minMax[MM_INDOOR_BATT].update(t, s.battery_voltage);
+        } else if (dev.schema == SCHEMA_OUTDOOR) {
+            minMax[MM_OUTDOOR_TEMP].update(t, s.temperature);
+            minMax[MM_OUTDOOR_PRESS].update(t, s.pressure);
+            minMax[MM_OUTDOOR_BATT].update(t, s.battery_voltage);
+        }
+    }
+
+    // Zustandswechsel seit dem letzten Frame zählen (die UI hätte hier neu gezeichnet)
+    void checkFreshness(unsigned long nowMs) {
+        for (int i = 0; i < 2; i++) {
+            FreshnessState st = freshness[i].state(nowMs);
+            if (st == shown[i]) continue;
+            if (st == FRESHNESS_LATE) lateEvents[i]++;
+            if (st == FRESHNESS_LOST) lostEvents[i]++;
+            shown[i] = st;
+        }
+    }
+
+    void process(const RawFrame& frame) {
+        checkFreshness(frame.rxMs);
+
+        TimeBeaconV1 beacon;
+        if (sensorTimeBeaconParse(frame.data, frame.len, beacon)) {
+            clockEpoch = beacon.epoch;
+            clockEpochMs = beacon.epoch_ms;
+            clockOffsetMin = beacon.utc_offset_min;
+            clockAnchorMs = frame.rxMs;
+            beacons++;
+            return;
+        }
+        if (sensorPacketIsControl(frame.data, frame.len)) {
+            controls++;
+            return;
+        }
+
+        SensorDevice* dev = ingest.ingest(frame.mac, frame.data, frame.len, frame.rssi, frame.rxMs);
+        if (!dev) {
+            dropped++;
+            return;
+        }
+        dev->hasNewData = false;
+
+        char stream[16];            // Strom-Name wie im Datalogger
+        if (dev->ordinal == 0) {
+            snprintf(stream, sizeof(stream), "%s", dev->schema == SCHEMA_INDOOR ? "indoor" : "outdoor");
+        } else {
+            snprintf(stream, sizeof(stream), "sensor_%02X%02X%02X", dev->mac[3], dev->mac[4], dev->mac[5]);
+        }
+
+        uint8_t count = SensorIngest::getBatchCount(*dev, frame.data, frame.len);
+        SensorSample sample;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!SensorIngest::getBatchSample(*dev, frame.data, frame.len, i, sample)) break;
+            logSample(stream, dev->schema, sample, frame.rxMs - sample.age_sec * 1000UL, true);
+        }
+        logSample(stream, dev->schema, dev->last, frame.rxMs, false);
+
+        if (dev->ordinal != 0) return;
+
+        int slot = (dev->schema == SCHEMA_INDOOR) ? 0 : 1;
+        freshness[slot].arrival(frame.rxMs, dev->last.sleep_time_sec);
+        checkFreshness(frame.rxMs);
+        updateMinMax(*dev, frame.rxMs);
+    }
+};
+
+// ==================== BERICHT ====================
+
+static void printReport(Replay& r, const Capture& cap) {
+    printf("Frames: %zu from %d file(s), span %.1f h\n",
+           cap.frames.size(), cap.files, cap.spanMs / 3600000.0);
+    printf("  beacons %lu, other control %lu, dropped %lu\n",
+           (unsigned long)r.beacons, (unsigned long)r.controls, (unsigned long)r.dropped);
+
+    printf("\nDevices:\n");
+    for (uint8_t i = 0; i < r.ingest.getCount(); i++) {
+        SensorDevice* dev = r.ingest.getDevice(i);
+        char mac[18];
+        SensorIngest::formatMac(dev->mac, mac);
+        const LinkStats& l = dev->link;
+        printf("  %s %-8s #%d  pkts %lu  lost %lu (%.1f%%)  dup %lu  bad %lu  retry %lu  "
+               "RSSI %d [p10 %d p50 %d p90 %d]  jitter %lu ms\n",
+               mac, SensorIngest::getSchemaName(dev->schema), dev->ordinal + 1,
+               (unsigned long)l.packets, (unsigned long)l.lost, l.lossTotalPct(),
+               (unsigned long)l.duplicates, (unsigned long)l.malformed, (unsigned long)l.retries,
+               l.rssiAvg(), l.rssiPercentile(10), l.rssiPercentile(50), l.rssiPercentile(90),
+               (unsigned long)l.jitterMs);
+    }
+    printf("  table full drops %lu, unknown drops %lu\n",
+           (unsigned long)r.ingest.getTableFullDrops(), (unsigned long)r.ingest.getUnknownDrops());
+
+    printf("\n24h Min/Max at end of capture (%s time):\n",
+           r.minMax.isEpochBased() ? "epoch" : "uptime");
+    for (int q = 0; q < MM_QUANTITY_COUNT; q++) {
+        float lo, hi;
+        if (r.minMax[q].get(r.lastMinMaxTime, lo, hi)) {
+            printf("  %-14s %9.2f .. %9.2f\n", MM_NAMES[q], lo, hi);
+        }
+    }
+
+    printf("\nFreshness: indoor late %lu / lost %lu, outdoor late %lu / lost %lu\n",
+           (unsigned long)r.lateEvents[0], (unsigned long)r.lostEvents[0],
+           (unsigned long)r.lateEvents[1], (unsigned long)r.lostEvents[1]);
+    for (int i = 0; i < 2; i++) {
+        if (r.freshness[i].getLearned() == 0) continue;
+        printf("  %s: interval/period %.3f, deviation %.3f (%lu intervals)\n",
+               i == 0 ? "indoor" : "outdoor", r.freshness[i].getRatio(),
+               r.freshness[i].getDeviation(), (unsigned long)r.freshness[i].getLearned());
+    }
+
+    printf("\nLog: %lu records (%lu from batches), CSV %llu bytes (%.1f/record), binary %lu bytes\n",
+           (unsigned long)r.records, (unsigned long)r.batchRecords,
+           (unsigned long long)r.csvBytes, r.records ? (double)r.csvBytes / r.records : 0.0,
+           (unsigned long)(r.records * sizeof(LogRecordV1)));
+}
+
+// ==================== MAIN ====================
+
+int main(int argc, char** argv) {
+    int repeat = 1;
+    const char* csvDir = nullptr;
+    Capture cap;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat < 1) repeat = 1;
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvDir = argv[++i];
+        } else if (!loadCapture(argv[i], cap)) {
+            return 1;
+        }
+    }
+
+    if (cap.files == 0) {
+        fprintf(stderr, "usage: %s [--repeat N] [--csv DIR] capture.ecap [...]\n", argv[0]);
+        return 2;
+    }
+
+    double bestMs = 0, totalMs = 0;
+    std::unique_ptr<Replay> last;
+
+    for (int run = 0; run < repeat; run++) {
+        std::unique_ptr<Replay> r(new Replay());
+        // CSV-Dateien nur in der letzten Runde schreiben
+        if (run == repeat - 1) r->csvDir = csvDir;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (const RawFrame& frame : cap.frames) r->process(frame);
+        auto t1 = std::chrono::steady_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        totalMs += ms;
+        if (run == 0 || ms < bestMs) bestMs = ms;
+        last = std::move(r);
+    }
+
+    printReport(*last, cap);
+
+    double frames = (double)cap.frames.size();
+    printf("\nReplay: %d run(s), best %.3f ms, mean %.3f ms, %.0f ns/frame, %.0f frames/s",
+           repeat, bestMs, totalMs / repeat,
+           frames ? bestMs * 1e6 / frames : 0.0, bestMs > 0 ? frames * 1000.0 / bestMs : 0.0);
+    if (bestMs > 0 && cap.spanMs > 0) printf(", %.0fx real time", cap.spanMs / bestMs);
+    printf("\n");
+    return 0;
+}